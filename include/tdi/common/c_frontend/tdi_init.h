@@ -31,7 +31,8 @@ extern "C" {
  * @brief Get the TdiDevice object corresponding to the (device_id)
  *
  * @param[in] dev_id Device ID
- * @param[out] tdi_device Device Obj associated with the Device.
+ * @param[out] tdi_device Device Obj associated with the Device. The handle
+ *    is valid until the device is removed
  *
  * @return Status of the API call
  */
@@ -142,6 +142,32 @@ tdi_status_t tdi_table_entry_get(const tdi_table_hdl *table_hdl,
                                  const tdi_table_key_hdl *key,
                                  tdi_table_data_hdl *data);
 
+/**
+ * @brief Get a batch of entries from the table by key
+ *
+ * @param[in] table_hdl Table object
+ * @param[in] session Session Object
+ * @param[in] dev_tgt Device target
+ * @param[in] flags Call flags
+ * @param[in] keys Array of Key objects. Size should be equal to n
+ * @param[inout] data Array of allocated Data objects.
+ * Size should be equal to n
+ * @param[in] n Number of entries queried
+ * @param[out] statuses Array receiving the status of each entry.
+ * Size should be equal to n
+ *
+ * @return TDI_SUCCESS if every entry was read, else the status of the
+ * first entry that failed
+ */
+tdi_status_t tdi_table_entry_get_batch(const tdi_table_hdl *table_hdl,
+                                       const tdi_session_hdl *session,
+                                       const tdi_target_hdl *dev_tgt,
+                                       const tdi_flags_hdl *flags,
+                                       const tdi_table_key_hdl **keys,
+                                       tdi_table_data_hdl **data,
+                                       uint32_t n,
+                                       tdi_status_t *statuses);
+
 /**
  * @brief Get an entry from the table by entry handle
  *
@@ -387,7 +413,9 @@ tdi_status_t tdi_table_key_reset(const tdi_table_hdl *table_hdl,
                                  tdi_table_key_hdl **key_hdl_ret);
 
 /**
- * @brief Deallocate key for the table
+ * @brief Deallocate key for the table. The key is returned to the pool of
+ * its table, which must still exist: after a program reload, free the keys
+ * of the old tables before their grace period ends
  *
  * @param[in] table_hdl Table object
  * @param[in] key_hdl Key object
@@ -688,13 +716,52 @@ tdi_status_t tdi_table_action_data_reset_with_fields(
     tdi_table_data_hdl **data_hdl_ret);
 
 /**
- * @brief Deallocate data object. Only one version of data deallocate API exists
+ * @brief Deallocate data object. Only one version of data deallocate API
+ * exists. The data object is returned to the pool of its table, which must
+ * still exist: after a program reload, free the data objects of the old
+ * tables before their grace period ends
  *
  * @param[in] data_hdl Data object
  *
  * @return Status of API call
  */
 tdi_status_t tdi_table_data_deallocate(tdi_table_data_hdl *data_hdl);
+
+/**
+ * @brief Set the number of key objects each free list of the pool of the
+ * table may keep. Threads are mapped to the 16 free lists round robin, so
+ * threads past the first 16 share a free list, and its size. Only the free
+ * list of the calling thread is filled right away. Key objects are then
+ * recycled by tdi_table_key_allocate() and tdi_table_key_deallocate()
+ * instead of being allocated and freed every time. 0 disables the pool,
+ * which is the default
+ *
+ * @param[in] table_hdl Table object
+ * @param[in] size Pool size per free list
+ *
+ * @return Status of API call. TDI_NOT_SUPPORTED, and the pool stays as it
+ * was, if the table can't reset key objects
+ */
+tdi_status_t tdi_table_key_pool_size_set(const tdi_table_hdl *table_hdl,
+                                         const size_t size);
+
+/**
+ * @brief Set the number of data objects each free list of the pool of the
+ * table may keep. Threads are mapped to the 16 free lists round robin, so
+ * threads past the first 16 share a free list, and its size. Only the free
+ * list of the calling thread is filled right away. Data objects are then
+ * recycled by the data allocate APIs and tdi_table_data_deallocate()
+ * instead of being allocated and freed every time. 0 disables the pool,
+ * which is the default
+ *
+ * @param[in] table_hdl Table object
+ * @param[in] size Pool size per free list
+ *
+ * @return Status of API call. TDI_NOT_SUPPORTED, and the pool stays as it
+ * was, if the table can't reset data objects
+ */
+tdi_status_t tdi_table_data_pool_size_set(const tdi_table_hdl *table_hdl,
+                                          const size_t size);
 /**
  * @brief Are Action IDs applicable for this table
  *
@@ -193,6 +193,28 @@ tdi_status_t tdi_data_field_get_value_ptr(const tdi_table_data_hdl *data_hdl,
                                            const size_t size,
                                            uint8_t *val);
 
+/**
+ * @brief Get a read only view of the value without copying it. Valid on
+ * fields of all sizes, for targets which keep values as byte arrays
+ *
+ * @param[in] data_hdl          Data object handle
+ * @param[in] field_id          Field ID
+ * @param[out] val              Pointer to the start of the value, in network
+ *                              order and byte-padded like
+ *                              tdi_data_field_get_value_ptr(). It points into
+ *                              the data object and stays valid until the
+ *                              field is set again, or the data object is
+ *                              reset or deallocated.
+ * @param[out] size             Number of bytes of the value
+ *
+ * @return Status of the API call. TDI_NOT_SUPPORTED if the target can only
+ * copy values out
+ */
+tdi_status_t tdi_data_field_get_value_view(const tdi_table_data_hdl *data_hdl,
+                                           const tdi_id_t field_id,
+                                           const uint8_t **val,
+                                           size_t *size);
+
 /**
  * @brief Get value array size. Valid on fields of integer array type
  *
@@ -23,12 +23,14 @@
 
 #include <map>
 #include <memory>
+#include <mutex>
 #include <set>
 #include <string>
 #include <unordered_map>
 #include <vector>
 
 #include <tdi/common/tdi_defs.h>
+#include <tdi/common/tdi_json_parser/tdi_info_index.hpp>
 #include <tdi/common/tdi_json_parser/tdi_info_parser.hpp>
 #include <tdi/common/tdi_learn.hpp>
 #include <tdi/common/tdi_table.hpp>
@@ -127,12 +129,27 @@ class TdiInfoMapper {
  */
 class TableFactory {
  public:
+  virtual ~TableFactory() = default;
   virtual std::unique_ptr<tdi::Table> makeTable(
       const TdiInfo * /*tdi_info*/,
       const tdi::TableInfo * /*table_info*/) const {
     // No tables in core currently
     return nullptr;
   };
+
+  /**
+   * @brief Make a table on program reload. prev_table is the table of the
+   * same name and schema in the TdiInfo being replaced, and is still in use
+   * until that TdiInfo is released. Targets which keep table state in the
+   * Table obj override this to share that state with the new table. By
+   * default the table is made from scratch
+   */
+  virtual std::unique_ptr<tdi::Table> remakeTable(
+      const TdiInfo *tdi_info,
+      const tdi::TableInfo *table_info,
+      const tdi::Table * /*prev_table*/) const {
+    return makeTable(tdi_info, table_info);
+  };
 };
 
 /**
@@ -165,6 +182,31 @@ class TdiInfo {
       std::unique_ptr<TdiInfoParser> tdi_info_parser,
       const tdi::TableFactory *factory);
 
+  /**
+   * @brief Static function to create TdiInfo which owns its table factory.
+   * In lazy mode no tdi::Table obj is created up front. Each one is created
+   * by the factory the first time it is looked up, so startup time and
+   * memory scale with the tables actually used. Lookups stay thread safe.
+   * tablesGet() and tableMapGet() create all remaining tables
+   *
+   * @param p4_name P4 name
+   * @param tdi_info_parser Parser holding the table and learn info
+   * @param factory Table factory, kept for the life of the TdiInfo
+   * @param lazy_tables Create tdi::Table objs on first lookup
+   * @param prev_tdi_info TdiInfo this one replaces on a program reload, or
+   * nullptr. Tables it holds whose schema is unchanged are made through
+   * TableFactory::remakeTable() with the previous table, so they keep their
+   * state. It must outlive this call only
+   *
+   * @return unique_ptr to TdiInfo
+   */
+  std::unique_ptr<const TdiInfo> static makeTdiInfo(
+      const std::string &p4_name,
+      std::unique_ptr<TdiInfoParser> tdi_info_parser,
+      std::unique_ptr<const tdi::TableFactory> factory,
+      const bool &lazy_tables,
+      const TdiInfo *prev_tdi_info = nullptr);
+
   /**
    * @brief Get all the tdi::Table objs.
    *
@@ -253,26 +295,51 @@ class TdiInfo {
   TdiInfo &operator=(const TdiInfo &) = delete;
   TdiInfo &operator=(TdiInfo &&) = delete;
 
-  /* Main P4_info map. object_name --> tdi_info object */
-  std::map<std::string, std::unique_ptr<tdi::Table>> tableMap;
+  /* Main P4_info map. object_name --> tdi_info object. In lazy mode tables
+   * are added as they are created, under table_map_mtx_ */
+  mutable std::map<std::string, std::unique_ptr<tdi::Table>> tableMap;
 
  private:
   TdiInfo(const std::string &p4_name,
           std::unique_ptr<TdiInfoParser> tdi_info_parser,
-          const tdi::TableFactory *factory);
+          const tdi::TableFactory *factory,
+          std::unique_ptr<const tdi::TableFactory> owned_factory,
+          const bool &lazy_tables,
+          const TdiInfo *prev_tdi_info);
+
+  // Table of lazy mode, the object is created once on first lookup
+  struct LazyTable {
+    LazyTable(const std::string &name_in, const TableInfo *table_info_in)
+        : name(name_in), table_info(table_info_in){};
+    const std::string name;
+    const TableInfo *table_info;
+    mutable std::once_flag once;
+    // Written once under once, nullptr if the factory failed
+    mutable const tdi::Table *table{nullptr};
+  };
+
+  const tdi::Table *tableMaterialize(
+      const LazyTable &lazy_table,
+      const tdi::Table *prev_table = nullptr) const;
+  // Table of prev_tdi_info with the same name and schema, if it exists
+  static const tdi::Table *prevTableGet(const TdiInfo *prev_tdi_info,
+                                        const std::string &name,
+                                        const TableInfo *table_info);
+  void tablesMaterialize() const;
 
   // This is the map which is to be queried when a name lookup for a table
   // happens. Multiple names can point to the same table because multiple
   // names can exist for a table. Example, switchingress.forward and forward
-  // both are valid for a table if no conflicts with other table is present
-  std::map<std::string, const tdi::Table *> fullTableMap;
+  // both are valid for a table if no conflicts with other table is present.
+  // Built once, a lookup hashes the name a single time
+  NameIndex<tdi::Table> fullTableIndex;
 
   /* Reverse map in case lookup from ID is needed*/
   std::map<tdi_id_t, const tdi::Table *> tableIdMap;
 
   // Learn Map
   std::map<std::string, std::unique_ptr<tdi::Learn>> learnMap;
-  std::map<std::string, const tdi::Learn *> fullLearnMap;
+  NameIndex<tdi::Learn> fullLearnIndex;
   std::map<tdi_id_t, const tdi::Learn *> learnIdMap;
 
   // Set of optimized out table names. Tables that may be present
@@ -286,6 +353,16 @@ class TdiInfo {
   // name like "$SHARED".
   const std::string p4_name_;
   std::unique_ptr<TdiInfoParser> tdi_info_parser_;
+
+  // Lazy mode. Tables are looked up through these instead of
+  // fullTableIndex and tableIdMap, which stay empty
+  const bool lazy_tables_{false};
+  std::unique_ptr<const tdi::TableFactory> owned_factory_;
+  const tdi::TableFactory *factory_{nullptr};
+  std::map<std::string, std::unique_ptr<LazyTable>> lazyTableMap;
+  NameIndex<LazyTable> fullLazyTableIndex;
+  std::map<tdi_id_t, const LazyTable *> lazyTableIdMap;
+  mutable std::mutex table_map_mtx_;
 };
 
 }  // namespace tdi
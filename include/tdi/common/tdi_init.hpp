@@ -23,7 +23,9 @@
 #ifndef _TDI_INIT_HPP_
 #define _TDI_INIT_HPP_
 
+#include <atomic>
 #include <functional>
+#include <future>
 #include <memory>
 #include <mutex>
 
@@ -71,6 +73,56 @@ class Device {
   tdi_status_t tdiInfoGet(const std::string &prog_name,
                           const TdiInfo **tdi_info) const;
 
+  /**
+   * @brief Get a reference to the TdiInfo object corresponding to the
+   * program name. The TdiInfo stays valid for as long as the reference is
+   * held, even if the program is reloaded meanwhile
+   *
+   * @param[in] prog_name Name of the P4 program
+   * @param[out] tdi_info TdiInfo Obj associated with the Device
+   *    and the program name
+   *
+   * @return Status of the API call
+   */
+  tdi_status_t tdiInfoGet(const std::string &prog_name,
+                          std::shared_ptr<const TdiInfo> *tdi_info) const;
+
+  /**
+   * @brief Reload a program with a new tdi.json, without stopping its
+   * readers. The new TdiInfo is built aside and then published atomically.
+   * Tables whose schema is unchanged keep their state. The previous TdiInfo
+   * is retired, it stays valid for holders of a reference and for raw
+   * pointer users until tdiInfoRetiredRelease()
+   *
+   * @param[in] program_config Config of the program, prog_name_ must be a
+   * program of this device
+   *
+   * @return Status of the API call
+   */
+  tdi_status_t programReload(const tdi::ProgramConfig &program_config);
+
+  /**
+   * @brief programReload() on a background thread
+   *
+   * @param[in] program_config Config of the program
+   *
+   * @return Future with the status of the reload
+   */
+  std::future<tdi_status_t> programReloadAsync(
+      const tdi::ProgramConfig &program_config);
+
+  /**
+   * @brief End the grace period of the TdiInfo objects retired by reloads.
+   * Call once no thread uses a raw TdiInfo, Table or Learn pointer taken
+   * before the reloads. Key and data objects allocated from the retired
+   * tables count as such, since freeing them through the pool APIs or the
+   * C frontend goes through their table. Free them before calling this.
+   * Holders of a reference are not affected
+   *
+   * @return Status of the API call
+   */
+  tdi_status_t tdiInfoRetiredRelease();
+
   /**
    * @brief Get a vector of loaded p4 program names on this device
    *
@@ -97,7 +149,32 @@ class Device {
   const std::vector<tdi::ProgramConfig> device_config_;
   const std::vector<tdi_mgr_type_e> mgr_type_list_;
   const void *cookie_;
-  std::map<std::string, std::unique_ptr<const TdiInfo>> tdi_info_map_;
+  // The programs are set when the device is added. The TdiInfo of each is
+  // swapped on reload with std::atomic_load/atomic_store only
+  std::map<std::string, std::shared_ptr<const TdiInfo>> tdi_info_map_;
+
+  /**
+   * @brief Build the TdiInfo of a program. Targets which support reload
+   * override this
+   *
+   * @param[in] program_config Config of the program
+   * @param[in] prev_tdi_info TdiInfo being replaced, or nullptr
+   * @param[out] tdi_info New TdiInfo
+   *
+   * @return Status of the API call
+   */
+  virtual tdi_status_t tdiInfoCreate(
+      const tdi::ProgramConfig & /*program_config*/,
+      const TdiInfo * /*prev_tdi_info*/,
+      std::unique_ptr<const TdiInfo> * /*tdi_info*/) const {
+    return TDI_NOT_SUPPORTED;
+  };
+
+ private:
+  // Serializes reloads, readers never take it
+  std::mutex reload_mtx_;
+  // TdiInfo objects replaced by reloads, kept for raw pointer users
+  std::vector<std::shared_ptr<const TdiInfo>> retired_tdi_infos_;
 };
 
 /**
@@ -118,13 +195,28 @@ class DevMgr {
    * program name)
    *
    * @param[in] dev_id Device ID
-   * @param[out] Device Device object
+   * @param[out] Device Device object. The pointer does not keep the Device
+   * alive, a concurrent deviceRemove may destroy it. Callers which can race
+   * with deviceRemove must use the reference version below
    *
    * @return Status of the API call
    */
   tdi_status_t deviceGet(const tdi_dev_id_t &dev_id,
                          const tdi::Device **device) const;
 
+  /**
+   * @brief Get a reference to a Device object. The Device stays alive as
+   * long as the reference is held, even if it is removed meanwhile.
+   * Lock-free with regard to deviceAdd and deviceRemove
+   *
+   * @param[in] dev_id Device ID
+   * @param[out] device Reference to the Device object
+   *
+   * @return Status of the API call
+   */
+  tdi_status_t deviceGet(const tdi_dev_id_t &dev_id,
+                         std::shared_ptr<const tdi::Device> *device) const;
+
   /**
    * @brief Get a list of all device IDs currently added
    *
@@ -138,11 +230,12 @@ class DevMgr {
   /**
    * @brief Device Add function which creates a Device object and maintains it
    *
-   * @param[in] device_id
+   * @param[in] device_id Device ID. Must be less than kMaxDevices
    * @param[in] cookie User defined cookie which platforms can use to
    * send any additional information they want to help with inititalization
    *
-   * @return Status of API call
+   * @return Status of API call. TDI_INVALID_ARG if the device ID is not less
+   * than kMaxDevices
    */
   template <typename T>
   tdi_status_t deviceAdd(const tdi_dev_id_t &device_id,
@@ -150,6 +243,15 @@ class DevMgr {
                          const std::vector<tdi::ProgramConfig> &device_config,
                          const std::vector<tdi_mgr_type_e> mgr_type_list,
                          void *cookie) {
+    if (device_id >= kMaxDevices) {
+      LOG_ERROR("%s:%d Device ID %d out of range, max : %d",
+                __func__,
+                __LINE__,
+                device_id,
+                kMaxDevices);
+      return TDI_INVALID_ARG;
+    }
+    std::lock_guard<std::mutex> lock(dev_map_mtx_);
     if (this->dev_map_.find(device_id) != this->dev_map_.end()) {
       LOG_ERROR("%s:%d Device obj exists for dev : %d",
                 __func__,
@@ -157,27 +259,53 @@ class DevMgr {
                 device_id);
       return TDI_ALREADY_EXISTS;
     }
-    auto dev = std::unique_ptr<tdi::Device>(
+    auto dev = std::shared_ptr<tdi::Device>(
         new T(device_id, arch_type, device_config, mgr_type_list, cookie));
+    // Readers that see the pointer also see the constructed Device
+    std::atomic_store(&this->devices_[device_id],
+                      std::shared_ptr<const Device>(dev));
     this->dev_map_[device_id] = std::move(dev);
     return TDI_SUCCESS;
   }
 
+  /**
+   * @brief Remove a device. Lookups stop finding it right away. The Device
+   * object is destroyed here, or when the last reference got from deviceGet
+   * is released if there are any
+   *
+   * @param[in] device_id
+   *
+   * @return Status of API call
+   */
   tdi_status_t deviceRemove(const tdi_dev_id_t &device_id);
 
+  /**
+   * @brief Device IDs must be less than this
+   */
+  static const tdi_dev_id_t kMaxDevices = 256;
+
   DevMgr(DevMgr const &) = delete;
   DevMgr(DevMgr &&) = delete;
   DevMgr &operator=(const DevMgr &) = delete;
   DevMgr &operator=(DevMgr &&) = delete;
 
  protected:
-  std::map<tdi_dev_id_t, std::unique_ptr<Device>> dev_map_;
+  // Owns the devices along with devices_ and the references handed out by
+  // deviceGet. Only accessed with dev_map_mtx_ held
+  std::map<tdi_dev_id_t, std::shared_ptr<Device>> dev_map_;
 
  private:
-  DevMgr(){};
+  DevMgr();
+
+  // Lookup array indexed by device ID. Accessed with std::atomic_load and
+  // std::atomic_store only, so readers never take dev_map_mtx_ and a
+  // reader's reference keeps a removed Device alive
+  std::shared_ptr<const Device> devices_[kMaxDevices];
+  // Serializes deviceAdd and deviceRemove
+  std::mutex dev_map_mtx_;
 
   static std::mutex dev_mgr_instance_mutex;
-  static DevMgr *dev_mgr_instance;
+  static std::atomic<DevMgr *> dev_mgr_instance;
 };  // DevMgr
 
 /**
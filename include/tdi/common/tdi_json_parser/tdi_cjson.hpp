@@ -21,6 +21,7 @@
 #include <map>
 #include <fstream>
 #include <iostream>
+#include <iterator>
 #include <vector>
 
 /* tdi_includes */
@@ -29,22 +30,72 @@
 
 namespace tdi {
 
+class CjsonArena;
+
 class CjsonObjHandler {
  public:
   CjsonObjHandler(const std::string &fileContent);
+  // Read only document parsed into an arena
+  CjsonObjHandler(std::unique_ptr<CjsonArena> arena);
   ~CjsonObjHandler();
   cJSON *rootGet() { return root; }
+  bool readOnly() const { return arena_ != nullptr; }
+  // Exact value of an integer node, only known for arena documents
+  bool exactValueGet(const cJSON *node, uint64_t *value) const;
 
  private:
   cJSON *root = nullptr;
+  std::unique_ptr<CjsonArena> arena_;
 };
 
 class Cjson {
  public:
+  /**
+   * @brief Forward iterator over the children of an object or array. It
+   * follows the sibling links of the document, so walking n children is
+   * O(n) and allocates nothing. Children are returned as Cjson values, which
+   * only point into the document owned by the parent
+   */
+  class ChildIterator {
+   public:
+    typedef std::forward_iterator_tag iterator_category;
+    typedef Cjson value_type;
+    typedef std::ptrdiff_t difference_type;
+    typedef const Cjson *pointer;
+    typedef Cjson reference;
+
+    ChildIterator(const Cjson &parent, cJSON *node)
+        : parent_(&parent), node_(node){};
+    Cjson operator*() const { return Cjson(*parent_, node_); };
+    ChildIterator &operator++() {
+      node_ = node_->next;
+      return *this;
+    };
+    ChildIterator operator++(int) {
+      ChildIterator prev = *this;
+      node_ = node_->next;
+      return prev;
+    };
+    bool operator==(const ChildIterator &other) const {
+      return node_ == other.node_;
+    };
+    bool operator!=(const ChildIterator &other) const {
+      return node_ != other.node_;
+    };
+
+   private:
+    const Cjson *parent_;
+    cJSON *node_;
+  };
+
   Cjson(const Cjson &parent, const std::string &key);
   //  Cjson(const std::string &fileContent);
   Cjson(const Cjson &parent, int &index);
   static Cjson createCjsonFromFile(const std::string &fileContent);
+  // Parse a read only document into an arena. Integers are read exactly up
+  // to 64 bits. The buffer need not be NUL terminated and can be released
+  // once this returns. Does not exist() if the buffer is not valid JSON
+  static Cjson createCjsonFromBuffer(const char *content, const size_t &len);
   Cjson(){};
 
   // Copy ctor
@@ -54,6 +105,12 @@ class Cjson {
   // rule of three need not be followed since the shared_ptr will
   // be destroyed automatically when out of scope
 
+  // Iterate over children, for (const auto &child : node)
+  ChildIterator begin() const {
+    return ChildIterator(*this, root ? root->child : nullptr);
+  };
+  ChildIterator end() const { return ChildIterator(*this, nullptr); };
+
   std::vector<std::shared_ptr<Cjson>> getCjsonChildVec() const;
   std::vector<std::string> getCjsonChildStringVec() const;
   std::string getCjsonKey() const;
@@ -76,6 +133,9 @@ class Cjson {
  private:
   static void createCjsonFromFileInternal(const std::string &fileContent,
                                           Cjson &obj);
+  // Node of the document the parent belongs to
+  Cjson(const Cjson &parent, cJSON *node)
+      : root(node), cjson_mem_tracker(parent.cjson_mem_tracker){};
   cJSON *root = nullptr;
   std::shared_ptr<CjsonObjHandler> cjson_mem_tracker = nullptr;
 };
@@ -0,0 +1,225 @@
+/*
+ * Copyright(c) 2021 Intel Corporation.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this software except as stipulated in the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+/** @file tdi_info_index.hpp
+ *
+ *  @brief Contains the read only ID and name indexes of TDI info objects
+ */
+#ifndef _TDI_INFO_INDEX_HPP
+#define _TDI_INFO_INDEX_HPP
+
+#include <algorithm>
+#include <cstdint>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include <tdi/common/tdi_defs.h>
+
+namespace tdi {
+
+/**
+ * @brief Read only index from tdi_id to info objects, built once when a
+ * table is parsed.
+ *
+ * IDs that fall in a dense span are stored in a direct mapped array and
+ * others in an open addressed table of at most half load, so a lookup is a
+ * single probe in the common case and never walks a tree.
+ */
+template <typename T>
+class IdIndex {
+ public:
+  /**
+   * @brief Build the index. IDs must be unique and objects not null
+   */
+  void build(const std::vector<std::pair<tdi_id_t, const T *>> &entries) {
+    direct_.clear();
+    slots_.clear();
+    if (entries.empty()) return;
+    tdi_id_t min_id = entries.front().first;
+    tdi_id_t max_id = min_id;
+    for (const auto &entry : entries) {
+      if (entry.first < min_id) min_id = entry.first;
+      if (entry.first > max_id) max_id = entry.first;
+    }
+    const size_t span = static_cast<size_t>(max_id - min_id) + 1;
+    if (span <= 2 * entries.size() + 8) {
+      base_ = min_id;
+      direct_.assign(span, nullptr);
+      for (const auto &entry : entries) {
+        direct_[entry.first - base_] = entry.second;
+      }
+      return;
+    }
+    size_t capacity = 4;
+    while (capacity < 2 * entries.size()) capacity <<= 1;
+    slots_.assign(capacity, std::pair<tdi_id_t, const T *>(0, nullptr));
+    for (const auto &entry : entries) {
+      size_t i = slotGet(entry.first);
+      while (slots_[i].second) i = (i + 1) & (slots_.size() - 1);
+      slots_[i] = entry;
+    }
+  };
+
+  /**
+   * @brief Find the object of an ID
+   * @return The object. nullptr if not found
+   */
+  const T *find(const tdi_id_t &id) const {
+    if (!direct_.empty()) {
+      const tdi_id_t offset = id - base_;
+      return (id >= base_ && offset < direct_.size()) ? direct_[offset]
+                                                      : nullptr;
+    }
+    if (slots_.empty()) return nullptr;
+    for (size_t i = slotGet(id); slots_[i].second;
+         i = (i + 1) & (slots_.size() - 1)) {
+      if (slots_[i].first == id) return slots_[i].second;
+    }
+    return nullptr;
+  };
+
+ private:
+  size_t slotGet(const tdi_id_t &id) const {
+    // Fibonacci hashing, action IDs are sparse but not random
+    return (static_cast<uint32_t>(id) * 0x9e3779b9u >> 8) &
+           (slots_.size() - 1);
+  };
+
+  tdi_id_t base_{0};
+  std::vector<const T *> direct_;
+  std::vector<std::pair<tdi_id_t, const T *>> slots_;
+};
+
+/**
+ * @brief Read only map from a set of tdi_ids to dense ordinals 0..n-1, built
+ * once when a table is parsed.
+ *
+ * Lets per object state about fields, like the active fields of a data
+ * object, be kept in flat arrays or bitsets instead of trees keyed by ID.
+ */
+class IdOrdinals {
+ public:
+  IdOrdinals() = default;
+  // The index points into ids_
+  IdOrdinals(const IdOrdinals &) = delete;
+  IdOrdinals &operator=(const IdOrdinals &) = delete;
+
+  /**
+   * @brief Build the ordinals. Duplicate IDs share an ordinal and ordinals
+   * follow the order of the IDs
+   */
+  void build(std::vector<tdi_id_t> ids) {
+    std::sort(ids.begin(), ids.end());
+    ids.erase(std::unique(ids.begin(), ids.end()), ids.end());
+    ids_ = std::move(ids);
+    std::vector<std::pair<tdi_id_t, const tdi_id_t *>> entries;
+    for (const auto &id : ids_) entries.emplace_back(id, &id);
+    index_.build(entries);
+  };
+
+  /**
+   * @brief Find the ordinal of an ID
+   * @return true if found
+   */
+  bool find(const tdi_id_t &id, size_t *ordinal) const {
+    const tdi_id_t *entry = index_.find(id);
+    if (!entry) return false;
+    *ordinal = entry - ids_.data();
+    return true;
+  };
+
+  /**
+   * @brief Get the ID of an ordinal. The ordinal must be less than sizeGet()
+   */
+  const tdi_id_t &idGet(const size_t &ordinal) const { return ids_[ordinal]; };
+
+  size_t sizeGet() const { return ids_.size(); };
+
+ private:
+  std::vector<tdi_id_t> ids_;
+  IdIndex<tdi_id_t> index_;
+};
+
+/**
+ * @brief Read only index from names to info objects, built once when the
+ * info is parsed.
+ *
+ * Names are kept in a flat open addressed table of at most half load along
+ * with their hash, so a lookup hashes the name once and compares strings
+ * only when the hashes match.
+ */
+template <typename T>
+class NameIndex {
+ public:
+  /**
+   * @brief Build the index. Names must be unique and objects not null
+   */
+  void build(const std::vector<std::pair<std::string, const T *>> &entries) {
+    slots_.clear();
+    if (entries.empty()) return;
+    size_t capacity = 4;
+    while (capacity < 2 * entries.size()) capacity <<= 1;
+    slots_.resize(capacity);
+    for (const auto &entry : entries) {
+      const uint64_t hash = hashGet(entry.first);
+      size_t i = hash & (slots_.size() - 1);
+      while (slots_[i].object) i = (i + 1) & (slots_.size() - 1);
+      slots_[i].hash = hash;
+      slots_[i].name = entry.first;
+      slots_[i].object = entry.second;
+    }
+  };
+
+  /**
+   * @brief Find the object of a name
+   * @return The object. nullptr if not found
+   */
+  const T *find(const std::string &name) const {
+    if (slots_.empty()) return nullptr;
+    const uint64_t hash = hashGet(name);
+    for (size_t i = hash & (slots_.size() - 1); slots_[i].object;
+         i = (i + 1) & (slots_.size() - 1)) {
+      if (slots_[i].hash == hash && slots_[i].name == name) {
+        return slots_[i].object;
+      }
+    }
+    return nullptr;
+  };
+
+ private:
+  struct Slot {
+    uint64_t hash{0};
+    std::string name;
+    const T *object{nullptr};
+  };
+
+  // FNV-1a, with the high bits folded in since only the low ones pick the
+  // slot
+  static uint64_t hashGet(const std::string &name) {
+    uint64_t hash = 0xcbf29ce484222325ULL;
+    for (const auto &c : name) {
+      hash ^= static_cast<uint8_t>(c);
+      hash *= 0x100000001b3ULL;
+    }
+    return hash ^ (hash >> 32);
+  };
+
+  std::vector<Slot> slots_;
+};
+
+}  // namespace tdi
+
+#endif  // _TDI_INFO_INDEX_HPP
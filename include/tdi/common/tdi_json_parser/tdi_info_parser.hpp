@@ -83,11 +83,28 @@ class TdiInfoMapper;
 
 class TdiInfoParser {
  public:
-  TdiInfoParser(std::unique_ptr<TdiInfoMapper> tdi_info_mapper);
+  /**
+   * @brief Construct a parser
+   *
+   * @param[in] tdi_info_mapper Target specific enum mapper
+   * @param[in] parse_threads Threads used to parse files and tables. 0 for
+   * one per hardware thread, 1 to parse serially
+   */
+  TdiInfoParser(std::unique_ptr<TdiInfoMapper> tdi_info_mapper,
+                const size_t &parse_threads = 0);
 
   tdi_status_t parseTdiInfo(
       const std::vector<std::string> &tdi_info_file_paths);
 
+  /**
+   * @brief Parse the schema files, going through a compiled image kept in
+   * schema_cache_dir. The image is written on a miss and reused as long as
+   * the files and the info mapper are unchanged. An empty directory
+   * disables the cache
+   */
+  tdi_status_t parseTdiInfo(const std::vector<std::string> &tdi_info_file_paths,
+                            const std::string &schema_cache_dir);
+
   const std::map<std::string, std::unique_ptr<TableInfo>> &tableInfoMapGet()
       const {
     return table_info_map_;
@@ -119,6 +136,7 @@ class TdiInfoParser {
   tdi_attributes_type_e attributesTypeStrToEnum(const std::string &type);
 
   const std::unique_ptr<TdiInfoMapper> tdi_info_mapper_;
+  const size_t parse_threads_{0};
   std::map<std::string, std::unique_ptr<TableInfo>> table_info_map_;
   std::map<std::string, std::unique_ptr<LearnInfo>> learn_info_map_;
 };
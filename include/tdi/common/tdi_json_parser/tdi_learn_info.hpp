@@ -128,6 +128,7 @@ class LearnInfo {
   std::set<Annotation> annotations_{};
   mutable std::unique_ptr<LearnContextInfo> learn_context_info_;
   friend class TdiInfoParser;
+  friend class SchemaCache;
 };
 
 }  // namespace tdi
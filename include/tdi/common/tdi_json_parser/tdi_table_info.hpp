@@ -26,9 +26,11 @@
 #include <set>
 #include <string>
 #include <unordered_map>
+#include <utility>
 #include <vector>
 
 #include <tdi/common/tdi_defs.h>
+#include <tdi/common/tdi_json_parser/tdi_info_index.hpp>
 
 namespace tdi {
 
@@ -39,6 +41,7 @@ class KeyFieldInfo;
 class DataFieldInfo;
 class Cjson;
 class TdiInfoMapper;
+class SchemaCache;
 
 // Classes that need to be overridden by targets in order for them to
 // target-specific information in the info
@@ -246,6 +249,7 @@ class KeyFieldInfo {
   const bool match_priority_{false};
   mutable std::unique_ptr<KeyFieldContextInfo> key_field_context_info_;
   friend class TdiInfoParser;
+  friend class SchemaCache;
 };  // class KeyFieldInfo
 
 class DataFieldInfo {
@@ -447,6 +451,8 @@ class DataFieldInfo {
   const std::set<tdi_id_t> oneof_siblings_;
   mutable std::unique_ptr<DataFieldContextInfo> data_field_context_info_;
   friend class TdiInfoParser;
+  friend class SchemaCache;
+  friend class TableInfo;
 };
 
 // Action ID APIs
@@ -524,8 +530,14 @@ class ActionInfo {
   const std::map<tdi_id_t, std::unique_ptr<DataFieldInfo>> data_fields_;
   const std::set<tdi::Annotation> annotations_;
   mutable std::unique_ptr<ActionContextInfo> action_context_info_;
+  // Data fields of this action and common data fields of the table. Built
+  // by the owning TableInfo
+  IdIndex<DataFieldInfo> data_index_;
+  NameIndex<DataFieldInfo> data_name_index_;
+  std::vector<tdi_id_t> data_id_list_;
   friend class TableInfo;
   friend class TdiInfoParser;
+  friend class SchemaCache;
 };
 
 /**
@@ -618,11 +630,21 @@ class TableInfo {
    */
   const std::set<tdi_id_t> &dependsOnGet() const { return depends_on_set_; };
 
+  /**
+   * @brief Check whether another TableInfo describes the same table, with
+   * the same fields, actions, types and annotations. Used to tell the
+   * tables a program reload leaves unchanged
+   * @return True if both schemas are the same
+   */
+  bool schemaEqual(const TableInfo &other) const;
+
   /**
    * @brief Get a vector of Key field IDs
-   * @return Vector of Key field IDs
+   * @return Sorted vector of Key field IDs, built when the table is parsed
    */
-  std::vector<tdi_id_t> keyFieldIdListGet() const;
+  const std::vector<tdi_id_t> &keyFieldIdListGet() const {
+    return key_id_list_;
+  };
 
   /**
    * @brief Get Key Field from name
@@ -644,18 +666,22 @@ class TableInfo {
    * @brief Get vector of DataField IDs. Will return non-action (common)
    * data field IDs if any actions exist
    *
-   * @return Vector of IDs
+   * @return Sorted vector of IDs, built when the table is parsed
    */
-  std::vector<tdi_id_t> dataFieldIdListGet() const;
+  const std::vector<tdi_id_t> &dataFieldIdListGet() const {
+    return data_id_list_;
+  };
 
   /**
    * @brief Get vector of DataField IDs for a particular action. If action
    * doesn't exist, then common fields list is returned.
    *
    * @param[in] action_id Action ID
-   * @return Vector of ID.
+   * @return Sorted vector of the action and common field IDs, built when
+   * the table is parsed
    */
-  std::vector<tdi_id_t> dataFieldIdListGet(const tdi_id_t &action_id) const;
+  const std::vector<tdi_id_t> &dataFieldIdListGet(
+      const tdi_id_t &action_id) const;
 
   /**
    * @brief Get the field ID of a Data Field from a name.
@@ -717,11 +743,22 @@ class TableInfo {
   const DataFieldInfo *dataFieldGet(const tdi_id_t &field_id,
                                     const tdi_id_t &action_id) const;
 
+  /**
+   * @brief Get the dense ordinals of every data field ID of the table,
+   * common, action and container fields alike. Target code can use them to
+   * index per field state by bit or array slot
+   *
+   * @return Ordinals, built when the table is parsed
+   */
+  const IdOrdinals &dataFieldOrdinalsGet() const { return data_ordinals_; };
+
   /**
    * @brief Get vector of Action IDs
-   * @return Vector of Action IDs
+   * @return Sorted vector of Action IDs, built when the table is parsed
    */
-  std::vector<tdi_id_t> actionIdListGet() const;
+  const std::vector<tdi_id_t> &actionIdListGet() const {
+    return action_id_list_;
+  };
 
   /**
    * @brief Get ActionInfo object from action name
@@ -812,8 +849,16 @@ class TableInfo {
       const auto data_field = kv.second.get();
       name_data_map_[data_field->nameGet()] = data_field;
     }
+    indexBuild();
   };
 
+  // Build the ID and name indexes and the ID lists once all maps are
+  // populated
+  void indexBuild();
+  // Append the ID of a data field and of all fields nested in it
+  static void dataFieldIdsCollect(const DataFieldInfo &data_field,
+                                  std::vector<tdi_id_t> *ids);
+
   const tdi_id_t id_;
   const std::string name_;
   const tdi_table_type_e table_type_;
@@ -828,9 +873,20 @@ class TableInfo {
   const std::set<tdi_operations_type_e> operations_type_set_;
   const std::set<tdi_attributes_type_e> attributes_type_set_;
   const std::set<Annotation> annotations_{};
+  IdIndex<KeyFieldInfo> key_index_;
+  IdIndex<DataFieldInfo> data_index_;
+  IdIndex<ActionInfo> action_index_;
+  NameIndex<KeyFieldInfo> key_name_index_;
+  NameIndex<DataFieldInfo> data_name_index_;
+  NameIndex<ActionInfo> action_name_index_;
+  IdOrdinals data_ordinals_;
+  std::vector<tdi_id_t> key_id_list_;
+  std::vector<tdi_id_t> data_id_list_;
+  std::vector<tdi_id_t> action_id_list_;
 
   mutable std::unique_ptr<TableContextInfo> table_context_info_;
   friend class TdiInfoParser;
+  friend class SchemaCache;
 };
 
 }  // namespace tdi
@@ -0,0 +1,182 @@
+/*
+ * Copyright(c) 2021 Intel Corporation.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this software except as stipulated in the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+/** @file tdi_packed_table_key.hpp
+ *
+ *  @brief Contains the packed Table Key which targets can build on
+ */
+#ifndef _TDI_PACKED_TABLE_KEY_HPP
+#define _TDI_PACKED_TABLE_KEY_HPP
+
+#include <vector>
+
+#include <tdi/common/tdi_json_parser/tdi_table_info.hpp>
+#include <tdi/common/tdi_table_key.hpp>
+
+namespace tdi {
+
+/**
+ * @brief Position of one key field in the packed key byte stream
+ */
+struct PackedKeyFieldLayout {
+  tdi_id_t id;
+  tdi_match_type_e match_type;
+  tdi_field_data_type_e data_type;
+  size_t size_bits;
+  size_t size_bytes;
+  size_t offset;
+};
+
+/**
+ * @brief Packed layout of the key of a table. Fields are laid out back to
+ * back in increasing field ID order, each one in network order and rounded
+ * up to a whole number of bytes. Built once per table from its TableInfo and
+ * shared by all the key objects of the table.
+ *
+ * A key object holds the packed values followed by the packed masks. Range
+ * fields keep their low bound in the values and their high bound in the
+ * masks. The identity of an entry is its packed values when every field is
+ * exact and the values followed by the masks otherwise.
+ */
+class PackedKeyLayout {
+ public:
+  PackedKeyLayout(const tdi::TableInfo *table_info);
+  // priority_field_ points into fields_, and key objects point to the layout
+  PackedKeyLayout(const PackedKeyLayout &) = delete;
+  PackedKeyLayout &operator=(const PackedKeyLayout &) = delete;
+
+  const PackedKeyFieldLayout *fieldGet(const tdi_id_t &field_id) const;
+  const std::vector<PackedKeyFieldLayout> &fieldsGet() const {
+    return fields_;
+  };
+  // Size of the packed key in bytes
+  const size_t &sizeGet() const { return size_; };
+  // Size of the bytes identifying an entry
+  const size_t &identitySizeGet() const { return identity_size_; };
+  // True if every key field is matched exactly
+  const bool &exactOnlyGet() const { return exact_only_; };
+  // $MATCH_PRIORITY field if the table has one, else nullptr
+  const PackedKeyFieldLayout *priorityFieldGet() const {
+    return priority_field_;
+  };
+  // Ones over the bits of every field taking part in the masked match, that
+  // is every field but the priority and the range fields
+  const std::vector<uint8_t> &matchMaskGet() const { return match_mask_; };
+
+  // Fill the bytes of the field in buf with ones, leaving the bits above
+  // the field width clear
+  static void fieldMaskFill(const PackedKeyFieldLayout &field, uint8_t *buf);
+
+ private:
+  std::vector<PackedKeyFieldLayout> fields_;
+  size_t size_{0};
+  size_t identity_size_{0};
+  bool exact_only_{true};
+  const PackedKeyFieldLayout *priority_field_{nullptr};
+  std::vector<uint8_t> match_mask_;
+};
+
+/**
+ * @brief Table Key kept as one contiguous byte buffer laid out by a
+ * PackedKeyLayout. Setters write each field straight into the buffer, so a
+ * target can hash, compare or encode a key with a memcmp or memcpy of
+ * valueGet() and maskGet() instead of walking per field objects.
+ * Targets derive their key from it and allocate it with the layout of
+ * their table.
+ */
+class PackedTableKey : public TableKey {
+ public:
+  PackedTableKey(const tdi::Table *table, const PackedKeyLayout *layout);
+  virtual ~PackedTableKey() = default;
+
+  using tdi::TableKey::setValue;
+
+  tdi_status_t setValue(const tdi_id_t &field_id,
+                        const tdi::KeyFieldValue &field_value) override;
+
+  /**
+   * @brief Set an exact field without a KeyFieldValue wrapper
+   *
+   * @param[in] field_id Field ID
+   * @param[in] value Value, at most 64 bits wide
+   *
+   * @return Status of the API call
+   */
+  tdi_status_t setValue(const tdi_id_t &field_id, const uint64_t &value);
+
+  /**
+   * @brief Set an exact field of any width without a KeyFieldValue wrapper
+   *
+   * @param[in] field_id Field ID
+   * @param[in] value Value in network order
+   * @param[in] size Size of value in bytes, must match the field
+   *
+   * @return Status of the API call
+   */
+  tdi_status_t setValue(const tdi_id_t &field_id,
+                        const uint8_t *value,
+                        const size_t &size);
+
+  tdi_status_t getValue(const tdi_id_t &field_id,
+                        tdi::KeyFieldValue *value) const override;
+
+  tdi_status_t reset() override;
+
+  // Keys hash and compare as their packed bytes. Ternary and LPM values are
+  // kept masked, so equal keys have equal bytes. Keys of one table order by
+  // field ID and then by value, since fields are packed in network order
+  size_t hash() const override;
+  bool equals(const tdi::TableKey &other) const override;
+  bool less(const tdi::TableKey &other) const override;
+
+  // Packed key values and masks. Ternary values are kept masked. A key used
+  // for a lookup carries the looked up value of a range field as its low
+  // bound
+  const uint8_t *valueGet() const { return bytes_.data(); };
+  const uint8_t *maskGet() const {
+    return bytes_.data() + layout_->sizeGet();
+  };
+  const uint8_t *identityGet() const { return bytes_.data(); };
+  const PackedKeyLayout *layoutGet() const { return layout_; };
+  // Value of the $MATCH_PRIORITY field, 0 if the table has none
+  uint32_t priorityGet() const;
+
+  // Overwrite the identity bytes. Used to return keys of table entries
+  void identitySet(const uint8_t *identity);
+
+ protected:
+  uint8_t *valuePtr(const PackedKeyFieldLayout &field) {
+    return bytes_.data() + field.offset;
+  };
+  uint8_t *maskPtr(const PackedKeyFieldLayout &field) {
+    return bytes_.data() + layout_->sizeGet() + field.offset;
+  };
+  const uint8_t *valuePtr(const PackedKeyFieldLayout &field) const {
+    return bytes_.data() + field.offset;
+  };
+  const uint8_t *maskPtr(const PackedKeyFieldLayout &field) const {
+    return bytes_.data() + layout_->sizeGet() + field.offset;
+  };
+
+  // Layout of an exact field, nullptr after logging if there is none
+  const PackedKeyFieldLayout *exactFieldGet(const tdi_id_t &field_id) const;
+
+  const PackedKeyLayout *layout_;
+  std::vector<uint8_t> bytes_;
+};
+
+}  // namespace tdi
+
+#endif  // _TDI_PACKED_TABLE_KEY_HPP
@@ -20,6 +20,7 @@
 #ifndef _TDI_TABLE_HPP
 #define _TDI_TABLE_HPP
 
+#include <atomic>
 #include <cstring>
 #include <map>
 #include <memory>
@@ -33,6 +34,7 @@
 #include <tdi/common/tdi_json_parser/tdi_table_info.hpp>
 #include <tdi/common/tdi_operations.hpp>
 #include <tdi/common/tdi_session.hpp>
+#include <tdi/common/tdi_table_cursor.hpp>
 #include <tdi/common/tdi_table_data.hpp>
 #include <tdi/common/tdi_table_key.hpp>
 #include <tdi/common/tdi_target.hpp>
@@ -41,6 +43,8 @@ namespace tdi {
 
 // Fwd declaration
 class TdiInfo;
+template <typename T>
+class TdiObjectPool;
 
 /**
  * @brief Class to contain metadata of Table Objs like Data and Key Fields,
@@ -57,7 +61,7 @@ class Table {
    */
   using keyDataPairs = std::vector<std::pair<tdi::TableKey *, TableData *>>;
 
-  virtual ~Table() = default;
+  virtual ~Table();
 
   /// Table APIs
   ///
@@ -115,6 +119,74 @@ class Table {
                                 const tdi::Flags &flags,
                                 const tdi::TableKey &key) const;
 
+  /**
+   * @brief Add a batch of entries to the table. Every entry is attempted
+   * even if an earlier one fails. The default implementation calls
+   * entryAdd once per entry, targets can override it to program the whole
+   * batch at once
+   *
+   * @param[in] session Session Object
+   * @param[in] dev_tgt Device target
+   * @param[in] flags Call flags
+   * @param[in] keys Entry Keys
+   * @param[in] datas Entry Data, one per key
+   * @param[out] statuses Status of each entry, in the order of keys
+   *
+   * @return TDI_SUCCESS if every entry was added, else the status of the
+   * first entry that failed
+   */
+  virtual tdi_status_t entryAddBatch(
+      const tdi::Session &session,
+      const tdi::Target &dev_tgt,
+      const tdi::Flags &flags,
+      const std::vector<const tdi::TableKey *> &keys,
+      const std::vector<const tdi::TableData *> &datas,
+      std::vector<tdi_status_t> *statuses) const;
+
+  /**
+   * @brief Modify a batch of existing entries of the table. Every entry is
+   * attempted even if an earlier one fails. The default implementation
+   * calls entryMod once per entry
+   *
+   * @param[in] session Session Object
+   * @param[in] dev_tgt Device target
+   * @param[in] flags Call flags
+   * @param[in] keys Entry Keys
+   * @param[in] datas Entry Data, one per key
+   * @param[out] statuses Status of each entry, in the order of keys
+   *
+   * @return TDI_SUCCESS if every entry was modified, else the status of the
+   * first entry that failed
+   */
+  virtual tdi_status_t entryModBatch(
+      const tdi::Session &session,
+      const tdi::Target &dev_tgt,
+      const tdi::Flags &flags,
+      const std::vector<const tdi::TableKey *> &keys,
+      const std::vector<const tdi::TableData *> &datas,
+      std::vector<tdi_status_t> *statuses) const;
+
+  /**
+   * @brief Delete a batch of entries of the table. Every entry is attempted
+   * even if an earlier one fails. The default implementation calls entryDel
+   * once per entry
+   *
+   * @param[in] session Session Object
+   * @param[in] dev_tgt Device target
+   * @param[in] flags Call flags
+   * @param[in] keys Entry Keys
+   * @param[out] statuses Status of each entry, in the order of keys
+   *
+   * @return TDI_SUCCESS if every entry was deleted, else the status of the
+   * first entry that failed
+   */
+  virtual tdi_status_t entryDelBatch(
+      const tdi::Session &session,
+      const tdi::Target &dev_tgt,
+      const tdi::Flags &flags,
+      const std::vector<const tdi::TableKey *> &keys,
+      std::vector<tdi_status_t> *statuses) const;
+
   /**
    * @brief Clear a table. Delete all entries. This API also resets default
    * entry if present and is not const default. If table has always present
@@ -231,6 +303,31 @@ class Table {
                                 const tdi::TableKey &key,
                                 tdi::TableData *data) const;
 
+  /**
+   * @brief Get a batch of entries from the table by key, with a single
+   * session, target and flags for the whole batch. Every key is looked up
+   * even if an earlier one fails. The default implementation calls entryGet
+   * once per key, targets can override it to pipeline the reads
+   *
+   * @param[in] session Session Object
+   * @param[in] dev_tgt Device target
+   * @param[in] flags Call flags
+   * @param[in] keys Entry Keys
+   * @param[inout] datas Entry Data, one per key. If not empty will be used
+   *                     to filter returned fields
+   * @param[out] statuses Status of each entry, in the order of keys
+   *
+   * @return TDI_SUCCESS if every entry was read, else the status of the
+   * first entry that failed
+   */
+  virtual tdi_status_t entryGetBatch(
+      const tdi::Session &session,
+      const tdi::Target &dev_tgt,
+      const tdi::Flags &flags,
+      const std::vector<const tdi::TableKey *> &keys,
+      const std::vector<tdi::TableData *> &datas,
+      std::vector<tdi_status_t> *statuses) const;
+
   /**
    * @brief Get an entry from the table by handle
    *
@@ -332,6 +429,27 @@ class Table {
                                      keyDataPairs *key_data_pairs,
                                      uint32_t *num_returned) const;
 
+  /**
+   * @brief Allocate a cursor to iterate over the entries of the table.
+   * Reading a table through a cursor does not look up the last key of each
+   * page again, unlike entryGetFirst and entryGetNextN
+   *
+   * @param[in] session Session Object
+   * @param[in] dev_tgt Device target
+   * @param[in] flags Call flags
+   * @param[in] snapshot Iterate over the entries present now, ignoring later
+   * adds and deletes
+   * @param[out] cursor_ret Cursor Object, positioned on the first entry
+   *
+   * @return Status of the API call
+   */
+  virtual tdi_status_t cursorAllocate(
+      const tdi::Session &session,
+      const tdi::Target &dev_tgt,
+      const tdi::Flags &flags,
+      const bool &snapshot,
+      std::unique_ptr<tdi::TableCursor> *cursor_ret) const;
+
   /**
    * @brief Current Usage of the table
    *
@@ -538,6 +656,110 @@ class Table {
 
   /** @} */  // End of group Data
 
+  //// Object pool APIs
+  /**
+   * @name Object pool APIs
+   * Key and data objects can be recycled through a pool of the table
+   * instead of being allocated and freed for every entry. A pool is split
+   * in 16 free lists, each holding up to the pool size objects. Threads
+   * are mapped to free lists round robin, so the first 16 threads have one
+   * each and further threads share one, and its size, with another thread.
+   * A thread whose free list is empty takes objects from the others.
+   * Pools are disabled
+   * until a size is set, and then the pool APIs behave like the allocate
+   * APIs and plain deletion. Objects taken from a pool are ordinary objects
+   * of the table and may also just be deleted. Releasing an object uses its
+   * table, so objects of a table retired by a program reload must be
+   * released before Device::tdiInfoRetiredRelease(), or deleted.
+   *
+   * @{
+   */
+  /**
+   * @brief Set the number of key objects each free list of the pool may
+   * keep. Only the free list of the calling thread is filled, up to that
+   * size, right away. Free lists of other threads fill as they release
+   * objects. 0 disables the pool and frees the cached objects
+   *
+   * @param[in] size Pool size per free list
+   *
+   * @return Status of the API call. TDI_NOT_SUPPORTED, and the pool stays
+   * as it was, if the table does not implement \ref keyReset()
+   */
+  tdi_status_t keyPoolSizeSet(const size_t &size) const;
+
+  /**
+   * @brief Get a reset key object from the pool, or allocate one if the
+   * pool is empty
+   *
+   * @param[out] key_ret Key object returned
+   *
+   * @return Status of the API call
+   */
+  tdi_status_t keyPoolAllocate(std::unique_ptr<tdi::TableKey> *key_ret) const;
+
+  /**
+   * @brief Reset a key object and return it to the pool. It is freed if the
+   * pool is disabled or full, or if the reset fails
+   *
+   * @param[in] key Key object of the table
+   *
+   * @return Status of the API call. Error is returned if the key object is
+   * not associated with the table, in which case it is freed
+   */
+  tdi_status_t keyPoolRelease(std::unique_ptr<tdi::TableKey> key) const;
+
+  /**
+   * @brief Set the number of data objects each free list of the pool may
+   * keep. Only the free list of the calling thread is filled, up to that
+   * size, right away. Free lists of other threads fill as they release
+   * objects. 0 disables the pool and frees the cached objects
+   *
+   * @param[in] size Pool size per free list
+   *
+   * @return Status of the API call. TDI_NOT_SUPPORTED, and the pool stays
+   * as it was, if the table does not implement \ref dataReset()
+   */
+  tdi_status_t dataPoolSizeSet(const size_t &size) const;
+
+  /**
+   * @brief Get a data object from the pool, reset like a new one from \ref
+   * dataAllocate() with the same arguments, or allocate one if the pool is
+   * empty
+   *
+   * @param[in] fields Vector of field IDs to activate. All fields if empty
+   * @param[in] action_id Action ID. 0 if not applicable
+   * @param[out] data_ret Data object returned
+   *
+   * @return Status of the API call
+   */
+  tdi_status_t dataPoolAllocate(
+      const std::vector<tdi_id_t> &fields,
+      const tdi_id_t &action_id,
+      std::unique_ptr<tdi::TableData> *data_ret) const;
+
+  /**
+   * @brief Reset a data object and return it to the pool. It is freed if
+   * the pool is disabled or full, or if the reset fails
+   *
+   * @param[in] data Data object of the table
+   *
+   * @return Status of the API call. Error is returned if the data object is
+   * not associated with the table, in which case it is freed
+   */
+  tdi_status_t dataPoolRelease(std::unique_ptr<tdi::TableData> data) const;
+
+  /**
+   * @brief Get the number of objects cached in the pools by all threads
+   *
+   * @param[out] key_count Number of cached key objects
+   * @param[out] data_count Number of cached data objects
+   *
+   * @return Status of the API call
+   */
+  tdi_status_t poolUsageGet(size_t *key_count, size_t *data_count) const;
+
+  /** @} */  // End of group Object pool
+
   // table attribute APIs
   /**
    * @name Attribute APIs
@@ -671,6 +893,9 @@ class Table {
   const TdiInfo *tdi_info_;
   // The TableInfo class containing all the metadata from tdi.json
   const TableInfo *table_info_;
+  // Pools of recycled objects, created when a pool size is first set
+  mutable std::atomic<TdiObjectPool<TableKey> *> key_pool_{nullptr};
+  mutable std::atomic<TdiObjectPool<TableData> *> data_pool_{nullptr};
   friend tdi::TdiInfo;
 };  // end of tdi::Table
 
@@ -0,0 +1,100 @@
+/*
+ * Copyright(c) 2021 Intel Corporation.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this software except as stipulated in the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+/** @file tdi_table_cursor.hpp
+ *
+ *  @brief Contains TDI Table Cursor APIs
+ */
+#ifndef _TDI_TABLE_CURSOR_HPP
+#define _TDI_TABLE_CURSOR_HPP
+
+#include <tdi/common/tdi_defs.h>
+
+namespace tdi {
+
+// Forward declarations
+class Table;
+class TableKey;
+class TableData;
+
+/**
+ * @brief Stateful iterator over the entries of a table.<br>
+ * <B>Creation: </B> Can only be created using \ref
+ * tdi::Table::cursorAllocate()
+ *
+ * A cursor keeps its position inside the storage of the target, so that
+ * reading the next page of entries does not need to look up the last key
+ * returned. Entries are written into key and data objects owned by the
+ * caller, which can be reused from one page to the next.
+ *
+ * A snapshot cursor iterates over the entries present when it was allocated
+ * or last reset, regardless of later adds and deletes. Other cursors see
+ * the table as it is when each page is read.
+ */
+class TableCursor {
+ public:
+  virtual ~TableCursor() = default;
+
+  /**
+   * @brief Read the next entries of the table
+   *
+   * @param[in] n Maximum number of entries to read
+   * @param[out] keys Array of n allocated Key objects
+   * @param[inout] datas Array of n allocated Data objects, if not empty will
+   *                     be used to filter returned fields
+   * @param[out] num_returned Number of entries read. Less than n once the
+   * cursor reaches the end of the table
+   *
+   * @return Status of the API call
+   */
+  virtual tdi_status_t next(const uint32_t &n,
+                            TableKey **keys,
+                            TableData **datas,
+                            uint32_t *num_returned);
+
+  /**
+   * @brief Move the cursor back to the first entry of the table. A snapshot
+   * cursor also takes a new snapshot
+   *
+   * @return Status of the API call
+   */
+  virtual tdi_status_t reset();
+
+  /**
+   * @brief Get the Table Object associated with this cursor
+   *
+   * @param[out] table Table Object
+   *
+   * @return Status of the API call
+   */
+  tdi_status_t tableGet(const Table **table) const;
+
+  /**
+   * @brief Whether the cursor iterates over a snapshot of the table
+   */
+  const bool &snapshotGet() const { return snapshot_; };
+
+ protected:
+  TableCursor(const Table *table, const bool &snapshot)
+      : table_(table), snapshot_(snapshot){};
+
+ private:
+  const Table *table_;
+  const bool snapshot_;
+};
+
+}  // namespace tdi
+
+#endif  // _TDI_TABLE_CURSOR_HPP
@@ -21,11 +21,13 @@
 #ifndef _TDI_TABLE_DATA_HPP
 #define _TDI_TABLE_DATA_HPP
 
+#include <atomic>
 #include <string>
 #include <cstring>
 #include <vector>
 #include <map>
 #include <memory>
+#include <mutex>
 #include <set>
 
 #include <tdi/common/tdi_defs.h>
@@ -33,6 +35,7 @@
 namespace tdi {
 
 // Forward declarations
+class IdOrdinals;
 class Learn;
 class Table;
 
@@ -60,16 +63,7 @@ class TableData {
   TableData(const tdi::Table *table,
             tdi_id_t action_id,
             tdi_id_t container_id,
-            std::vector<tdi_id_t> active_fields)
-      : table_(table), action_id_(action_id), container_id_(container_id) {
-    if (!active_fields.size()) {
-      all_fields_set_ = true;
-    } else {
-      std::copy(active_fields.begin(),
-                active_fields.end(),
-                std::inserter(active_fields_s_, active_fields_s_.end()));
-    }
-  };
+            std::vector<tdi_id_t> active_fields);
 
   /**
    * @name Set APIs
@@ -106,6 +100,23 @@ class TableData {
                                 const uint8_t *value,
                                 const size_t &size);
 
+  /**
+   * @brief Set value from a byte array the data object may take over. Valid
+   * on fields of all sizes. The input is the same as for the pointer
+   * version, the size being the size of the vector.
+   * Targets which keep values as byte arrays adopt the vector instead of
+   * copying it, so large fields like register and action data do not get
+   * copied per entry. The default copies through the pointer version.
+   *
+   * @param[in] field_id Field ID
+   * @param[in] value Byte-array in network order. Left in an unspecified
+   * state if the call succeeds, and untouched if it fails
+   *
+   * @return Status of the API call
+   */
+  virtual tdi_status_t setValue(const tdi_id_t &field_id,
+                                std::vector<uint8_t> &&value);
+
   /**
    * @brief Set value. Valid only on fields with integer array type
    *
@@ -181,6 +192,22 @@ class TableData {
       const tdi_id_t &field_id,
       std::vector<std::unique_ptr<tdi::TableData>> ret_vec);
 
+  /**
+   * @brief Rvalue variant of the container setValue() above. Takes the
+   * vector by rvalue reference so that callers holding a named vector must
+   * std::move() it explicitly. Ownership semantics are the same as for
+   * setValue(). The default implementation forwards to setValue(), so
+   * targets only need to override that one.
+   *
+   * @param[in] field_id Field ID
+   * @param[in] ret_vec Vector of tdi::TableData unique_ptrs to be moved in
+   *
+   * @return Status of the API call
+   */
+  virtual tdi_status_t setValueMove(
+      const tdi_id_t &field_id,
+      std::vector<std::unique_ptr<tdi::TableData>> &&ret_vec);
+
   /**
    * @brief Set value. Valid only on fields with string type
    *
@@ -226,6 +253,24 @@ class TableData {
                                 const size_t &size,
                                 uint8_t *value) const;
 
+  /**
+   * @brief Get a read only view of the value without copying it. Valid on
+   * fields of all sizes, for targets which keep values as byte arrays.
+   * The view is in network order, byte-padded like the byte-array getValue()
+   * and points into the data object. It stays valid until the field is set
+   * again, or the data object is reset or destroyed
+   *
+   * @param[in] field_id Field ID
+   * @param[out] value Pointer to the start of the value
+   * @param[out] size Number of bytes of the value
+   *
+   * @return Status of the API call. TDI_NOT_SUPPORTED if the target can only
+   * copy values out, in which case the byte-array getValue() is to be used
+   */
+  virtual tdi_status_t getValueView(const tdi_id_t &field_id,
+                                    const uint8_t **value,
+                                    size_t *size) const;
+
   /**
    * @brief Get value. Valid on fields of integer array type
    *
@@ -328,6 +373,14 @@ class TableData {
    */
   const tdi_id_t &actionIdGet() const { return action_id_; };
 
+  /**
+   * @brief Get container ID.
+   *
+   * @return Field ID of the container field this data object was allocated
+   * for. 0 if it is a data object of the table itself
+   */
+  const tdi_id_t &containerIdGet() const { return container_id_; };
+
   /**
    * @brief Data Allocate for a container field ID. Container ID
    * is field ID of a container field. If container ID doesn't
@@ -462,13 +515,13 @@ class TableData {
 
   /**
    * @brief Returns a const ref to set of active fields. If empty
-   * then all fields are deemed to be active.
+   * then all fields are deemed to be active. The set is built on the first
+   * call after the active fields changed, at the cost of one allocation per
+   * field. The reference stays the same for the life of the object
    *
    * @return set of active fields
    */
-  const std::set<tdi_id_t> &activeFieldsGet() const {
-    return active_fields_s_;
-  };
+  const std::set<tdi_id_t> &activeFieldsGet() const;
 
   /**
    * @brief Reset action ID. Caution: Only meant to be used by Target driver
@@ -485,6 +538,25 @@ class TableData {
    */
   tdi_status_t activeFieldsSet(const std::vector<tdi_id_t> &fields);
 
+  /**
+   * @brief Compare with another data object. Both are equal if they belong
+   * to the same table, action and container, have the same active fields,
+   * taking deactivated oneof siblings into account, and hold equal values
+   * in every active field. Inactive fields are ignored
+   *
+   * @param[in] other Data object to compare with
+   *
+   * @return true if both data objects are equal
+   */
+  bool equals(const tdi::TableData &other) const;
+
+  bool operator==(const tdi::TableData &other) const {
+    return this->equals(other);
+  };
+  bool operator!=(const tdi::TableData &other) const {
+    return !this->equals(other);
+  };
+
  protected:
   /**
    * @brief Template pattern function which should be overridden by Derived
@@ -494,6 +566,18 @@ class TableData {
    */
   virtual tdi_status_t resetDerived() { return TDI_SUCCESS; };
 
+  /**
+   * @brief Template pattern function which should be overridden by Derived
+   * classes to compare the values of the active fields. Only called by
+   * equals() once the table, action and active fields are known to match.
+   * The base class compares the object identity
+   *
+   * @return true if the values of all active fields are equal
+   */
+  virtual bool equalsDerived(const tdi::TableData &other) const {
+    return this == &other;
+  };
+
   // For LearnData, this can be set to nullptr
   const tdi::Table *table_;
   // For TableData, this can be set to nullptr
@@ -503,10 +587,43 @@ class TableData {
   tdi_id_t action_id_{0};
   tdi_id_t container_id_{0};
   bool all_fields_set_{false};
-  // set for faster lookup
-  std::set<tdi_id_t> active_fields_s_{};
+
+  /**
+   * @brief Set of field IDs kept as a bitset over the data field ordinals
+   * of the table, so that clearing it is a memset and a lookup is a single
+   * bit test. IDs without an ordinal, like those of data objects without a
+   * table, fall back to a std::set
+   */
+  class FieldSet {
+   public:
+    void init(const IdOrdinals *ordinals);
+    void clear();
+    // Return true if the ID was not in the set yet
+    bool insert(const tdi_id_t &field_id);
+    // Return true if the ID was in the set
+    bool erase(const tdi_id_t &field_id);
+    bool contains(const tdi_id_t &field_id) const;
+    bool empty() const { return !count_; };
+    void idsGet(std::set<tdi_id_t> *field_ids) const;
+    bool operator==(const FieldSet &other) const;
+    bool operator!=(const FieldSet &other) const { return !(*this == other); };
+
+   private:
+    const IdOrdinals *ordinals_{nullptr};
+    std::vector<uint64_t> bits_{};
+    std::set<tdi_id_t> others_{};
+    size_t count_{0};
+  };
+
+  FieldSet active_fields_{};
   // set of removed oneofs
-  std::set<tdi_id_t> removed_one_ofs_{};
+  FieldSet removed_one_ofs_{};
+  // Same fields as active_fields_ for activeFieldsGet(). The mutators only
+  // mark it stale, so resets don't allocate, and it is rebuilt under the
+  // mutex by the first reader that sees it stale
+  mutable std::set<tdi_id_t> active_fields_s_{};
+  mutable std::atomic<bool> active_fields_s_stale_{false};
+  mutable std::mutex active_fields_s_mtx_;
 };
 
 }  // namespace tdi
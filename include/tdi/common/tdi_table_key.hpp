@@ -21,6 +21,7 @@
 #define _TDI_TABLE_KEY_HPP
 
 #include <cstring>
+#include <functional>
 #include <map>
 #include <memory>
 #include <set>
@@ -214,10 +215,58 @@ class TableKey {
    */
   virtual tdi_status_t reset();
 
+  /**
+   * @brief Hash of the key. Keys which compare equal hash equally, so the
+   * value bits of ternary and LPM fields only count under their mask.
+   * The base class hashes the object identity
+   *
+   * @return Hash value
+   */
+  virtual size_t hash() const;
+
+  /**
+   * @brief Compare with another key. Keys of different tables never compare
+   * equal. The base class compares the object identity
+   *
+   * @param[in] other Key to compare with
+   *
+   * @return true if both keys match the same entries
+   */
+  virtual bool equals(const tdi::TableKey &other) const;
+
+  /**
+   * @brief Strict weak ordering of keys, consistent with equals(), for
+   * ordered containers and sorted reconciliation
+   *
+   * @param[in] other Key to compare with
+   *
+   * @return true if this key orders before other
+   */
+  virtual bool less(const tdi::TableKey &other) const;
+
+  bool operator==(const tdi::TableKey &other) const {
+    return this->equals(other);
+  };
+  bool operator!=(const tdi::TableKey &other) const {
+    return !this->equals(other);
+  };
+  bool operator<(const tdi::TableKey &other) const {
+    return this->less(other);
+  };
+
  protected:
   const Table *table_ = nullptr;
 };
 
 }  // namespace tdi
 
+namespace std {
+
+template <>
+struct hash<tdi::TableKey> {
+  size_t operator()(const tdi::TableKey &key) const { return key.hash(); }
+};
+
+}  // namespace std
+
 #endif  // _TDI_TABLE_KEY_HPP
@@ -61,13 +61,21 @@ class ProgramConfig {
  public:
   ProgramConfig(const std::string &prog_name,
                 const std::vector<std::string> &tdi_info_file_paths,
-                const std::vector<tdi::P4Pipeline> &p4_pipelines)
+                const std::vector<tdi::P4Pipeline> &p4_pipelines,
+                const std::string &schema_cache_dir = "",
+                const bool &lazy_tables = false)
       : prog_name_(prog_name),
         tdi_info_file_paths_(tdi_info_file_paths),
-        p4_pipelines_(p4_pipelines){};
+        p4_pipelines_(p4_pipelines),
+        schema_cache_dir_(schema_cache_dir),
+        lazy_tables_(lazy_tables){};
   const std::string prog_name_;
   const std::vector<std::string> tdi_info_file_paths_;
   const std::vector<tdi::P4Pipeline> p4_pipelines_;
+  // Directory for compiled schema images, empty to always parse the JSON
+  const std::string schema_cache_dir_;
+  // Create Table objs on first lookup instead of all at startup
+  const bool lazy_tables_;
 };
 
 enum tdi_target_core_enum_e {
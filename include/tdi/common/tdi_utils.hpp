@@ -16,13 +16,21 @@
 #ifndef _TDI_UTILS_HPP
 #define _TDI_UTILS_HPP
 
-#include <queue>
+#include <algorithm>
+#include <atomic>
 #include <mutex>
 #include <future>
 #include <thread>
 #include <condition_variable>
+#include <exception>
 #include <functional>
+#include <cstdint>
 #include <cstring>
+#include <memory>
+#include <vector>
+
+#include <pthread.h>
+#include <sched.h>
 
 #include <target-sys/bf_sal/bf_sys_intf.h>
 
@@ -44,154 +52,512 @@
 
 namespace tdi {
 
-// This is a class to initialize a generalized thread pool with a specific
-// number of worker threads given at time of creation of the thread pool.
-// The thread pool uses a thread safe queue to manage the producer-consumer
-// pipeline. This thread safe queue is just a wrapper on std::queue<T>.
-// The queue is templatized over std::function<void()> and thus holds function
-// objects. It is the job of the submitTask function to package the function F
-// and the variadic arguments that are passed to it by the user into a
-// std::function<void()> function object and enqueue it in the queue.
-// Any producer can first create the thread pool and then use the submitTask
-// function to submit tasks which will be enqueued in the queue. The worker
-// thread/threads are waiting for any tasks to appear in the queue and pick
-// them up as soon as the tasks are enqueued. During the destruction of the
-// thread pool, the "shutdown_" flag is set which indicates to the worker
-// threads that they need to stop processing the tasks in the queue and return.
-// These worker threads are then subsequently joined.
-// The implementation of this thread pool is inspired from the following.
-// https://github.com/mtrebi/thread-pool
+// This is a class to initialize a generalized work-stealing thread pool with
+// a specific number of worker threads given at time of creation of the
+// thread pool.
+// Every worker owns a Chase-Lev deque of tasks. A worker pushes and pops
+// tasks at the bottom of its own deque without any lock, and idle workers
+// steal from the top of the other deques with a single CAS. Tasks submitted
+// from outside the pool go to a lock-free injection list, which a worker
+// takes whole and moves into its deque. Tasks submitted from a worker of the
+// pool go straight to its own deque.
+// Each task is one heap object that runs the packaged function directly, so
+// there is no std::function or shared_ptr boxing per task.
+// Workers that find no work park on a condition variable. Producers only
+// take the lock to wake them when some worker is parked, so a busy pool
+// never touches a lock.
+// During the destruction of the thread pool, the "shutdown_" flag is set
+// which indicates to the worker threads that they need to stop processing
+// the tasks and return. These worker threads are then subsequently joined
+// and the tasks that did not run are dropped, which breaks their futures.
+// The deque follows "Correct and Efficient Work-Stealing for Weak Memory
+// Models", Le, Pop, Cohen and Zappa Nardelli, PPoPP 2013.
 class TdiThreadPool {
  private:
-  // Wrapper class over std::queue to make it thread safe
-  template <typename T>
-  class ThreadSafeQueue {
+  // A unit of work. next_ links tasks on the injection list
+  class Task {
+   public:
+    virtual ~Task() = default;
+    virtual void run() = 0;
+    Task *next_{nullptr};
+  };
+
+  // Task which runs a packaged_task so that its result reaches a future
+  template <typename R>
+  class PackagedTask : public Task {
    public:
-    ThreadSafeQueue(){};
+    template <typename F>
+    explicit PackagedTask(F &&f) : task_(std::forward<F>(f)) {}
+    void run() override { task_(); }
+    std::future<R> futureGet() { return task_.get_future(); }
+
+   private:
+    std::packaged_task<R()> task_;
+  };
+
+  // Task which just runs a callable. It must not throw
+  template <typename F>
+  class FunctionTask : public Task {
+   public:
+    explicit FunctionTask(F &&f) : fn_(std::move(f)) {}
+    void run() override { fn_(); }
+
+   private:
+    F fn_;
+  };
 
-    void enqueue(T &t) {
-      std::lock_guard<std::mutex> lg(mtx_);
-      queue_.push(t);
+  // Chase-Lev deque. push and take are only called by the owning worker,
+  // steal by any thread. The ring grows when full, and older rings are kept
+  // until the deque goes away since a thief may still read from them
+  class WorkStealingDeque {
+   public:
+    WorkStealingDeque() {
+      rings_.emplace_back(new Ring(kInitialCapacity));
+      ring_.store(rings_.back().get(), std::memory_order_relaxed);
     }
 
-    bool dequeue(T *t) {
-      std::lock_guard<std::mutex> lg(mtx_);
-      if (queue_.empty()) {
-        return false;
+    void push(Task *task) {
+      const int64_t b = bottom_.load(std::memory_order_relaxed);
+      const int64_t t = top_.load(std::memory_order_acquire);
+      Ring *ring = ring_.load(std::memory_order_relaxed);
+      if (b - t > ring->mask_) {
+        ring = grow(ring, t, b);
       }
-      *t = queue_.front();
-      queue_.pop();
-      return true;
+      ring->put(b, task);
+      std::atomic_thread_fence(std::memory_order_release);
+      bottom_.store(b + 1, std::memory_order_relaxed);
     }
 
-    bool empty() const {
-      std::lock_guard<std::mutex> lg(mtx_);
-      return queue_.empty();
+    Task *take() {
+      const int64_t b = bottom_.load(std::memory_order_relaxed) - 1;
+      Ring *ring = ring_.load(std::memory_order_relaxed);
+      bottom_.store(b, std::memory_order_relaxed);
+      std::atomic_thread_fence(std::memory_order_seq_cst);
+      int64_t t = top_.load(std::memory_order_relaxed);
+      if (t > b) {
+        // Empty
+        bottom_.store(b + 1, std::memory_order_relaxed);
+        return nullptr;
+      }
+      Task *task = ring->get(b);
+      if (t == b) {
+        // Last task, race the thieves for it
+        if (!top_.compare_exchange_strong(t,
+                                          t + 1,
+                                          std::memory_order_seq_cst,
+                                          std::memory_order_relaxed)) {
+          task = nullptr;
+        }
+        bottom_.store(b + 1, std::memory_order_relaxed);
+      }
+      return task;
+    }
+
+    Task *steal() {
+      int64_t t = top_.load(std::memory_order_acquire);
+      std::atomic_thread_fence(std::memory_order_seq_cst);
+      const int64_t b = bottom_.load(std::memory_order_acquire);
+      if (t >= b) {
+        return nullptr;
+      }
+      Ring *ring = ring_.load(std::memory_order_acquire);
+      Task *task = ring->get(t);
+      if (!top_.compare_exchange_strong(t,
+                                        t + 1,
+                                        std::memory_order_seq_cst,
+                                        std::memory_order_relaxed)) {
+        // Lost the race to the owner or another thief
+        return nullptr;
+      }
+      return task;
     }
 
-    size_t size() const {
-      std::lock_guard<std::mutex> lg(mtx_);
-      return queue_.size();
+    bool empty() const {
+      const int64_t b = bottom_.load(std::memory_order_relaxed);
+      const int64_t t = top_.load(std::memory_order_relaxed);
+      return b <= t;
     }
 
    private:
-    std::queue<T> queue_;
-    // Lock to protect against concurrent accesses to std::queue
-    mutable std::mutex mtx_;
-  };  // ThreadSafeQueue
+    static const int64_t kInitialCapacity = 256;
 
-  // Functor which will be executed by each worker thread
-  class WorkerThread {
+    class Ring {
+     public:
+      explicit Ring(int64_t capacity)
+          : mask_(capacity - 1), tasks_(new std::atomic<Task *>[capacity]) {}
+      Task *get(const int64_t &i) const {
+        return tasks_[i & mask_].load(std::memory_order_relaxed);
+      }
+      void put(const int64_t &i, Task *task) {
+        tasks_[i & mask_].store(task, std::memory_order_relaxed);
+      }
+      const int64_t mask_;
+
+     private:
+      std::unique_ptr<std::atomic<Task *>[]> tasks_;
+    };
+
+    Ring *grow(Ring *ring, const int64_t &t, const int64_t &b) {
+      rings_.emplace_back(new Ring(2 * (ring->mask_ + 1)));
+      Ring *new_ring = rings_.back().get();
+      for (int64_t i = t; i < b; i++) {
+        new_ring->put(i, ring->get(i));
+      }
+      ring_.store(new_ring, std::memory_order_release);
+      return new_ring;
+    }
+
+    // Thieves move top_ and the owner moves bottom_, keep them on separate
+    // cache lines
+    std::atomic<int64_t> top_{0};
+    char top_pad_[64 - sizeof(std::atomic<int64_t>)];
+    std::atomic<int64_t> bottom_{0};
+    char bottom_pad_[64 - sizeof(std::atomic<int64_t>)];
+    std::atomic<Ring *> ring_{nullptr};
+    std::vector<std::unique_ptr<Ring>> rings_;
+  };  // WorkStealingDeque
+
+  // Worker thread state, the pool keeps one per thread
+  class Worker {
    public:
-    WorkerThread(const int &id, TdiThreadPool *thread_pool)
-        : id_(id), thread_pool_(thread_pool) {}
-
-    void operator()() {
-      // continue processing tasks from the queue until the thread pool is
-      // shutdown
-      while (!thread_pool_->shutdown_) {
-        bool is_dequeued = false;
-        std::function<void()> fn;
-        {
-          std::unique_lock<std::mutex> lock(thread_pool_->mtx_);
-          if (thread_pool_->queue_.empty()) {
-            // Wait until there is work to be performed
-            thread_pool_->cond_var_.wait(lock);
-          }
-        }
-        // Get a task from the queue
-        is_dequeued = thread_pool_->queue_.dequeue(&fn);
-        if (is_dequeued) {
-          // Perform the task
-          fn();
-        }
+    WorkStealingDeque deque_;
+    std::thread thread_;
+  };
+
+  // State shared by the caller and the helper tasks of one parallelFor
+  class ParallelForState {
+   public:
+    std::atomic<size_t> next_chunk_{0};
+    std::atomic<size_t> done_chunks_{0};
+    size_t num_chunks_{0};
+    std::mutex mtx_;
+    std::condition_variable cond_var_;
+    std::exception_ptr error_;
+  };
+
+  // The pool and worker index of the calling thread, if it is a worker
+  struct WorkerContext {
+    const TdiThreadPool *thread_pool{nullptr};
+    size_t index{0};
+  };
+  static WorkerContext &workerContextGet() {
+    static thread_local WorkerContext context;
+    return context;
+  }
+
+  // Index of the calling thread in this pool, or -1 if it is not a worker
+  int64_t workerIndexGet() const {
+    const WorkerContext &context = workerContextGet();
+    return context.thread_pool == this ? static_cast<int64_t>(context.index)
+                                       : -1;
+  }
+
+  // Make a chain of tasks, linked by next_, available to the workers
+  void enqueue(Task *first, Task *last, const size_t &count) {
+    pending_.fetch_add(count, std::memory_order_relaxed);
+    const int64_t index = workerIndexGet();
+    if (index >= 0) {
+      // Nested submission, no contention on the owner end of the deque
+      for (Task *task = first; task != nullptr;) {
+        Task *next = task->next_;
+        task->next_ = nullptr;
+        workers_[index]->deque_.push(task);
+        task = next;
+      }
+    } else {
+      // Lock-free push of the whole chain onto the injection list
+      last->next_ = inject_head_.load(std::memory_order_relaxed);
+      while (!inject_head_.compare_exchange_weak(last->next_,
+                                                 first,
+                                                 std::memory_order_release,
+                                                 std::memory_order_relaxed)) {
       }
     }
+    wake(count);
+  }
 
-   private:
-    const int id_{0};
-    TdiThreadPool *thread_pool_{nullptr};
-  };  // WorkerThread
+  // Wake parked workers if there are any. Pairs with the fence in park(),
+  // either the parking worker sees the new work or we see it parked
+  void wake(const size_t &count) {
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    if (sleeping_.load(std::memory_order_relaxed) == 0) {
+      return;
+    }
+    std::lock_guard<std::mutex> lock(mtx_);
+    if (count > 1) {
+      cond_var_.notify_all();
+    } else {
+      cond_var_.notify_one();
+    }
+  }
+
+  bool workAvailable() const {
+    if (inject_head_.load(std::memory_order_relaxed) != nullptr) {
+      return true;
+    }
+    for (const auto &worker : workers_) {
+      if (!worker->deque_.empty()) {
+        return true;
+      }
+    }
+    return false;
+  }
+
+  void park() {
+    std::unique_lock<std::mutex> lock(mtx_);
+    sleeping_.fetch_add(1, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    if (!shutdown_.load(std::memory_order_relaxed) && !workAvailable()) {
+      cond_var_.wait(lock);
+    }
+    sleeping_.fetch_sub(1, std::memory_order_relaxed);
+  }
 
-  std::vector<std::thread> threads_;  // Vector to keep track of threads
-  bool shutdown_{false};              // Flag to shutdown the pool
-  ThreadSafeQueue<std::function<void()>> queue_;
+  // Take the whole injection list. The oldest task is returned and the
+  // others are pushed so that the owner takes them oldest first
+  Task *injectedTake(const size_t &index) {
+    if (inject_head_.load(std::memory_order_relaxed) == nullptr) {
+      return nullptr;
+    }
+    // The list is newest first
+    Task *task = inject_head_.exchange(nullptr, std::memory_order_acquire);
+    if (task == nullptr) {
+      return nullptr;
+    }
+    while (task->next_ != nullptr) {
+      Task *next = task->next_;
+      task->next_ = nullptr;
+      workers_[index]->deque_.push(task);
+      task = next;
+    }
+    return task;
+  }
+
+  Task *taskFind(const size_t &index) {
+    Task *task = workers_[index]->deque_.take();
+    if (task == nullptr) {
+      task = injectedTake(index);
+    }
+    for (size_t i = 1; task == nullptr && i < workers_.size(); i++) {
+      task = workers_[(index + i) % workers_.size()]->deque_.steal();
+    }
+    return task;
+  }
+
+  void workerRun(const size_t &index) {
+    WorkerContext &context = workerContextGet();
+    context.thread_pool = this;
+    context.index = index;
+    // continue processing tasks until the thread pool is shutdown
+    while (!shutdown_.load(std::memory_order_acquire)) {
+      Task *task = taskFind(index);
+      if (task == nullptr) {
+        park();
+        continue;
+      }
+      pending_.fetch_sub(1, std::memory_order_relaxed);
+      task->run();
+      delete task;
+    }
+  }
+
+  void cpuAffinitySet(std::thread *thread, const int &cpu) {
+#ifdef __linux__
+    cpu_set_t cpu_set;
+    CPU_ZERO(&cpu_set);
+    CPU_SET(cpu, &cpu_set);
+    if (pthread_setaffinity_np(
+            thread->native_handle(), sizeof(cpu_set), &cpu_set) != 0) {
+      LOG_WARN("%s:%d Unable to pin thread pool worker to cpu %d",
+               __func__,
+               __LINE__,
+               cpu);
+    }
+#else
+    (void)thread;
+    (void)cpu;
+#endif
+  }
 
-  // We use condition variable so that the worker threads can be signalled
-  // whenever there are tasks to be performed in the queue and thus they
-  // don't need to spin on the queue waiting for tasks to show up
+  // Claim and run chunks of a parallelFor until none are left
+  template <typename F>
+  static void parallelForRun(ParallelForState *state,
+                             const F *fn,
+                             const size_t &begin,
+                             const size_t &end,
+                             const size_t &grain) {
+    while (true) {
+      const size_t chunk =
+          state->next_chunk_.fetch_add(1, std::memory_order_relaxed);
+      if (chunk >= state->num_chunks_) {
+        return;
+      }
+      const size_t chunk_begin = begin + chunk * grain;
+      const size_t chunk_end = std::min(end, chunk_begin + grain);
+      try {
+        for (size_t i = chunk_begin; i < chunk_end; i++) (*fn)(i);
+      } catch (...) {
+        std::lock_guard<std::mutex> lock(state->mtx_);
+        if (!state->error_) {
+          state->error_ = std::current_exception();
+        }
+      }
+      if (state->done_chunks_.fetch_add(1, std::memory_order_acq_rel) + 1 ==
+          state->num_chunks_) {
+        std::lock_guard<std::mutex> lock(state->mtx_);
+        state->cond_var_.notify_all();
+      }
+    }
+  }
+
+  std::vector<std::unique_ptr<Worker>> workers_;
+  std::atomic<bool> shutdown_{false};  // Flag to shutdown the pool
+  std::atomic<Task *> inject_head_{nullptr};
+  std::atomic<size_t> pending_{0};
+  std::atomic<size_t> sleeping_{0};
+
+  // Parked workers wait on the condition variable, so they don't need to
+  // spin waiting for tasks to show up
   std::mutex mtx_;
   std::condition_variable cond_var_;
 
  public:
-  TdiThreadPool(const size_t &num_threads = 1)
-      : threads_(std::vector<std::thread>(num_threads)) {
-    for (size_t i = 0; i < threads_.size(); i++) {
-      threads_[i] = std::thread(WorkerThread(i, this));
+  // Workers are pinned round robin to the cpus given, if any
+  TdiThreadPool(const size_t &num_threads = 1,
+                const std::vector<int> &cpus = {}) {
+    // All deques exist before any worker may steal from them
+    for (size_t i = 0; i < num_threads; i++) {
+      workers_.emplace_back(new Worker());
+    }
+    for (size_t i = 0; i < num_threads; i++) {
+      workers_[i]->thread_ = std::thread([this, i]() { workerRun(i); });
+      if (!cpus.empty()) {
+        cpuAffinitySet(&workers_[i]->thread_, cpus[i % cpus.size()]);
+      }
     }
   }
   ~TdiThreadPool() {
     // Stop processing any more tasks
-    shutdown_ = true;
-    // Wake up all threads so that break from their respective while loops
-    // and return
+    {
+      std::lock_guard<std::mutex> lock(mtx_);
+      shutdown_.store(true, std::memory_order_release);
+    }
+    // Wake up all threads so that they break from their loops and return
     cond_var_.notify_all();
-    for (size_t i = 0; i < threads_.size(); i++) {
-      if (threads_[i].joinable()) {
+    for (auto &worker : workers_) {
+      if (worker->thread_.joinable()) {
         // Wait for the thread to finish
-        threads_[i].join();
+        worker->thread_.join();
+      }
+    }
+    // Drop the tasks that never ran
+    for (auto &worker : workers_) {
+      while (Task *task = worker->deque_.take()) {
+        delete task;
       }
     }
+    Task *task = inject_head_.exchange(nullptr, std::memory_order_acquire);
+    while (task != nullptr) {
+      Task *next = task->next_;
+      delete task;
+      task = next;
+    }
   }
 
-  size_t getQueueSize() { return queue_.size(); }
+  // Number of tasks submitted and not yet started
+  size_t getQueueSize() { return pending_.load(std::memory_order_relaxed); }
+
+  size_t numThreadsGet() const { return workers_.size(); }
 
   // This function is responsible for packaging the function 'F' and the
-  // variadic arguments 'args' that are passed to it into a generic
-  // function object 'std::function<void()>' and enqueue it in the queue.
-  // These packaged function objects will subsquently be processed by the
-  // worker threads
+  // variadic arguments 'args' that are passed to it into a task and
+  // making it available to the worker threads
   template <typename F, typename... Args>
   auto submitTask(F &&f, Args &&... args) -> std::future<decltype(f(args...))> {
-    // Construct a function object
-    std::function<decltype(f(args...))()> fn_obj =
-        std::bind(std::forward<F>(f), std::forward<Args>(args)...);
-    // Make a packaged task. We need a task object so that we retrieve the
-    // result once the worker thread has finished execution
-    auto task_ptr =
-        std::make_shared<std::packaged_task<decltype(f(args...))()>>(fn_obj);
-
-    // Construct a generic void function
-    std::function<void()> fn_wrapper = [task_ptr]() { (*task_ptr)(); };
-
-    // Enqueue the generic void function
-    queue_.enqueue(fn_wrapper);
+    auto task = new PackagedTask<decltype(f(args...))>(
+        std::bind(std::forward<F>(f), std::forward<Args>(args)...));
+    // Return the future for the packaged_task shared state
+    auto future = task->futureGet();
+    enqueue(task, task, 1);
+    return future;
+  }
 
-    // Wake up any one thread waiting
-    cond_var_.notify_one();
+  // Submit a batch of callables with a single push onto the injection list
+  // and a single wakeup. Futures are returned in the order of fns
+  template <typename F>
+  auto submitTasks(std::vector<F> fns)
+      -> std::vector<std::future<decltype(fns[0]())>> {
+    std::vector<std::future<decltype(fns[0]())>> futures;
+    if (fns.empty()) {
+      return futures;
+    }
+    futures.reserve(fns.size());
+    Task *first = nullptr;
+    Task *last = nullptr;
+    // Link newest first, like the injection list
+    for (auto &fn : fns) {
+      auto task = new PackagedTask<decltype(fns[0]())>(std::move(fn));
+      futures.push_back(task->futureGet());
+      task->next_ = first;
+      first = task;
+      if (last == nullptr) {
+        last = task;
+      }
+    }
+    enqueue(first, last, fns.size());
+    return futures;
+  }
 
-    // Return the future for the packaged_task shared state
-    return task_ptr->get_future();
+  // Run fn(i) for every i in [begin, end) and wait for all of them. Indexes
+  // are handed out in chunks of grain, by default a few chunks per thread.
+  // The calling thread runs chunks too, so it is safe to call from a task
+  // of this pool. The first exception thrown by fn is rethrown here
+  template <typename F>
+  void parallelFor(const size_t &begin,
+                   const size_t &end,
+                   const F &fn,
+                   size_t grain = 0) {
+    if (end <= begin) {
+      return;
+    }
+    const size_t count = end - begin;
+    if (grain == 0) {
+      grain = std::max<size_t>(1, count / (4 * (workers_.size() + 1)));
+    }
+    auto state = std::make_shared<ParallelForState>();
+    state->num_chunks_ = (count + grain - 1) / grain;
+    // Helpers that start after the last chunk is claimed only touch the
+    // shared state, so they may outlive this call
+    const size_t num_helpers =
+        std::min(workers_.size(), state->num_chunks_ - 1);
+    if (num_helpers > 0) {
+      Task *first = nullptr;
+      Task *last = nullptr;
+      const F *fn_ptr = &fn;
+      for (size_t i = 0; i < num_helpers; i++) {
+        auto helper = [state, fn_ptr, begin, end, grain]() {
+          parallelForRun(state.get(), fn_ptr, begin, end, grain);
+        };
+        auto task = new FunctionTask<decltype(helper)>(std::move(helper));
+        task->next_ = first;
+        first = task;
+        if (last == nullptr) {
+          last = task;
+        }
+      }
+      enqueue(first, last, num_helpers);
+    }
+    parallelForRun(state.get(), &fn, begin, end, grain);
+    {
+      std::unique_lock<std::mutex> lock(state->mtx_);
+      state->cond_var_.wait(lock, [&state]() {
+        return state->done_chunks_.load(std::memory_order_acquire) ==
+               state->num_chunks_;
+      });
+    }
+    if (state->error_) {
+      std::rethrow_exception(state->error_);
+    }
   }
 
   // Delete the copy constructor and the assignment operator
@@ -201,6 +567,109 @@ class TdiThreadPool {
   TdiThreadPool &operator=(TdiThreadPool &&) = delete;
 };  // TdiThreadPool
 
+// This is a class to keep a free list of objects of one kind, so that they
+// can be recycled instead of being allocated and freed over and over. The
+// pool does not create objects, the owner fills it by putting back objects
+// it no longer needs.
+// The free list is split in kNumShards shards. Threads are mapped to shards
+// round robin in the order they first use any pool of T, so the first
+// kNumShards threads each have a shard to themselves and later ones share
+// a shard with an earlier thread. The lock of a shard is thus rarely
+// contended and a thread mostly gets back objects it put itself. A thread
+// that finds its shard empty takes objects cached in the other shards,
+// which covers threads that only allocate or only free.
+// The capacity bounds the objects cached per shard, so threads sharing a
+// shard share its capacity too. Objects put beyond it are handed back to
+// the caller.
+template <typename T>
+class TdiObjectPool {
+ public:
+  explicit TdiObjectPool(const size_t &capacity) : capacity_(capacity){};
+
+  // Take a cached object. nullptr if the pool is empty
+  std::unique_ptr<T> get() {
+    if (!size_.load(std::memory_order_relaxed)) return nullptr;
+    const size_t index = shardIndexGet();
+    for (size_t i = 0; i < kNumShards; i++) {
+      Shard &shard = shards_[(index + i) % kNumShards];
+      std::unique_lock<std::mutex> lock(shard.mtx, std::defer_lock);
+      if (i == 0) {
+        lock.lock();
+      } else if (!lock.try_lock()) {
+        continue;
+      }
+      if (!shard.objects.empty()) {
+        std::unique_ptr<T> object = std::move(shard.objects.back());
+        shard.objects.pop_back();
+        size_.fetch_sub(1, std::memory_order_relaxed);
+        return object;
+      }
+    }
+    return nullptr;
+  }
+
+  // Cache an object. Returns the object back if the shard is full
+  std::unique_ptr<T> put(std::unique_ptr<T> object) {
+    Shard &shard = shards_[shardIndexGet()];
+    std::lock_guard<std::mutex> lock(shard.mtx);
+    if (shard.objects.size() >= capacity_.load(std::memory_order_relaxed)) {
+      return object;
+    }
+    shard.objects.push_back(std::move(object));
+    size_.fetch_add(1, std::memory_order_relaxed);
+    return nullptr;
+  }
+
+  // Set the capacity per shard. Cached objects beyond it are freed
+  void capacitySet(const size_t &capacity) {
+    capacity_.store(capacity, std::memory_order_relaxed);
+    for (auto &shard : shards_) {
+      std::vector<std::unique_ptr<T>> freed;
+      {
+        std::lock_guard<std::mutex> lock(shard.mtx);
+        while (shard.objects.size() > capacity) {
+          freed.push_back(std::move(shard.objects.back()));
+          shard.objects.pop_back();
+        }
+        size_.fetch_sub(freed.size(), std::memory_order_relaxed);
+      }
+    }
+  }
+
+  size_t capacityGet() const { return capacity_.load(); }
+
+  // Number of objects cached by all threads
+  size_t sizeGet() const { return size_.load(); }
+
+  // Delete the copy constructor and the assignment operator
+  TdiObjectPool(const TdiObjectPool &) = delete;
+  TdiObjectPool &operator=(const TdiObjectPool &) = delete;
+
+ private:
+  static const size_t kNumShards = 16;
+
+  // The padding keeps shards off each other's cache lines, as pools are
+  // heap allocated and C++11 new does not honor alignas
+  struct Shard {
+    std::mutex mtx;
+    std::vector<std::unique_ptr<T>> objects;
+    char pad_[64];
+  };
+
+  // Threads take shards round robin in the order they first use any pool
+  // of T. Threads past the first kNumShards share a shard
+  static size_t shardIndexGet() {
+    static std::atomic<size_t> next_index{0};
+    static thread_local size_t index =
+        next_index.fetch_add(1, std::memory_order_relaxed) % kNumShards;
+    return index;
+  }
+
+  std::atomic<size_t> capacity_;
+  std::atomic<size_t> size_{0};
+  Shard shards_[kNumShards];
+};  // TdiObjectPool
+
 class TdiEndiannessHandler {
  public:
   TdiEndiannessHandler() = delete;
@@ -249,6 +718,43 @@ class TdiEndiannessHandler {
     src += (8 - size);
     std::memcpy(value_ptr, src, size);
   }
+
+  // The calls below take fields of any width, such as 128 bit IPv6
+  // addresses. A host order field is the integer of the same width in host
+  // byte order, so on little endian hosts both directions reverse the bytes.
+  // value_ptr and out_data may be the same buffer but must not otherwise
+  // overlap. SSSE3 and AVX2 are used when the CPU has them
+
+  static void toHostOrder(const size_t &size,
+                          const uint8_t *value_ptr,
+                          uint8_t *out_data);
+
+  static void toNetworkOrder(const size_t &size,
+                             const uint8_t *value_ptr,
+                             uint8_t *out_data);
+
+  // Convert count fields of size bytes each, stored back to back
+  static void toHostOrderBatch(const size_t &size,
+                               const size_t &count,
+                               const uint8_t *value_ptr,
+                               uint8_t *out_data);
+
+  static void toNetworkOrderBatch(const size_t &size,
+                                  const size_t &count,
+                                  const uint8_t *value_ptr,
+                                  uint8_t *out_data);
+
+  // Convert count network order fields of at most 8 bytes each, stored back
+  // to back, to 64 bit data and back
+  static void toHostOrderBatch(const size_t &size,
+                               const size_t &count,
+                               const uint8_t *value_ptr,
+                               uint64_t *out_data);
+
+  static void toNetworkOrderBatch(const size_t &size,
+                                  const size_t &count,
+                                  const uint64_t *in_data,
+                                  uint8_t *value_ptr);
 };
 
 }  // namespace tdi
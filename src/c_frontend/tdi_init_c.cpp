@@ -25,10 +25,10 @@
 tdi_status_t tdi_device_get(const tdi_dev_id_t dev_id,
                             const tdi_device_hdl **device_hdl_ret) {
   tdi_status_t sts = TDI_SUCCESS;
-  const tdi::Device *device = nullptr;
+  std::shared_ptr<const tdi::Device> device;
   tdi::DevMgr &devMgrObj = tdi::DevMgr::getInstance();
   sts = devMgrObj.deviceGet(dev_id, &device);
-  *device_hdl_ret = reinterpret_cast<const tdi_device_hdl *>(device);
+  *device_hdl_ret = reinterpret_cast<const tdi_device_hdl *>(device.get());
   return sts;
 }
 
@@ -64,8 +64,9 @@ tdi_status_t tdi_info_get(const tdi_dev_id_t dev_id,
   const tdi::TdiInfo *tdiInfo = nullptr;
   std::string program_name(prog_name);
   tdi::DevMgr &devMgrObj = tdi::DevMgr::getInstance();
-  // From the dev_id, to get devObj
-  const tdi::Device *devObj = nullptr;
+  // From the dev_id, to get devObj. The reference keeps it alive for the
+  // rest of the call even if the device is removed concurrently
+  std::shared_ptr<const tdi::Device> devObj;
   sts = devMgrObj.deviceGet(dev_id, &devObj);
   if (sts != TDI_SUCCESS) {
     return sts;
@@ -142,8 +143,9 @@ tdi_status_t tdi_num_p4_names_get(const tdi_dev_id_t dev_id, int *num_names) {
   tdi_status_t sts = TDI_SUCCESS;
   std::vector<std::reference_wrapper<const std::string>> p4_names;
   tdi::DevMgr &devMgrObj = tdi::DevMgr::getInstance();
-  // From the dev_id, to get devObj
-  const tdi::Device *devObj = nullptr;
+  // From the dev_id, to get devObj. The reference keeps it alive for the
+  // rest of the call even if the device is removed concurrently
+  std::shared_ptr<const tdi::Device> devObj;
   sts = devMgrObj.deviceGet(dev_id, &devObj);
   if (sts != TDI_SUCCESS) {
     return sts;
@@ -162,8 +164,9 @@ tdi_status_t tdi_p4_names_get(const tdi_dev_id_t dev_id,
   tdi_status_t sts = TDI_SUCCESS;
   std::vector<std::reference_wrapper<const std::string>> p4_names;
   tdi::DevMgr &devMgrObj = tdi::DevMgr::getInstance();
-  // From the dev_id, to get devObj
-  const tdi::Device *devObj = nullptr;
+  // From the dev_id, to get devObj. The reference keeps it alive for the
+  // rest of the call even if the device is removed concurrently
+  std::shared_ptr<const tdi::Device> devObj;
   sts = devMgrObj.deviceGet(dev_id, &devObj);
   if (sts != TDI_SUCCESS) {
     return sts;
@@ -24,6 +24,8 @@ extern "C" {
 }
 #endif
 
+#include <cstdint>
+
 #include <tdi/common/tdi_session.hpp>
 #include "tdi_state_c.hpp"
 
@@ -35,33 +37,52 @@ TdiCFrontEndSessionState &TdiCFrontEndSessionState::getInstance() {
   return instance;
 }
 
+const size_t TdiCFrontEndSessionState::kNumShards;
+
+TdiCFrontEndSessionState::Shard &TdiCFrontEndSessionState::shardGet(
+    const Session *session_raw) {
+  // Sessions are heap allocated, so the low bits carry no information.
+  // Multiplicative hashing spreads the rest over the shards
+  const uint64_t addr = reinterpret_cast<uintptr_t>(session_raw);
+  const uint64_t hash = (addr >> 4) * 0x9e3779b97f4a7c15ULL;
+  return shards_[(hash >> 32) & (kNumShards - 1)];
+}
+
 std::shared_ptr<Session> TdiCFrontEndSessionState::getSharedPtr(
     const Session *session_raw) {
   if (session_raw == nullptr) {
     return nullptr;
   }
-  std::lock_guard<std::mutex> lock(state_lock);
-  if (sessionStateMap.find(session_raw) != sessionStateMap.end()) {
-    return sessionStateMap.at(session_raw);
+  auto &shard = shardGet(session_raw);
+  std::lock_guard<std::mutex> lock(shard.state_lock);
+  auto it = shard.sessionStateMap.find(session_raw);
+  if (it != shard.sessionStateMap.end()) {
+    return it->second;
   }
   return nullptr;
 }
 
 void TdiCFrontEndSessionState::insertShared(
     std::shared_ptr<Session> session) {
-  std::lock_guard<std::mutex> lock(state_lock);
-  if (sessionStateMap.find(session.get()) != sessionStateMap.end()) {
-    return;
-  }
-  sessionStateMap[session.get()] = session;
+  auto &shard = shardGet(session.get());
+  std::lock_guard<std::mutex> lock(shard.state_lock);
+  // Keeps the existing entry, like before
+  shard.sessionStateMap.emplace(session.get(), std::move(session));
 }
 
 void TdiCFrontEndSessionState::removeShared(const Session *session) {
-  std::lock_guard<std::mutex> lock(state_lock);
-  if (sessionStateMap.find(session) == sessionStateMap.end()) {
-    return;
+  std::shared_ptr<Session> removed;
+  auto &shard = shardGet(session);
+  {
+    std::lock_guard<std::mutex> lock(shard.state_lock);
+    auto it = shard.sessionStateMap.find(session);
+    if (it == shard.sessionStateMap.end()) {
+      return;
+    }
+    removed = std::move(it->second);
+    shard.sessionStateMap.erase(it);
   }
-  sessionStateMap.erase(sessionStateMap.find(session));
+  // The session may be destroyed here, outside the shard lock
 }
 
 }  // tdi_c
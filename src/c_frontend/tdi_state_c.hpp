@@ -16,10 +16,15 @@
 #ifndef _TDI_STATE_C_HPP
 #define _TDI_STATE_C_HPP
 
+#include <cstddef>
+#include <memory>
 #include <mutex>
 #include <unordered_map>
 
 namespace tdi {
+
+class Session;
+
 namespace tdi_c {
 
 class TdiCFrontEndSessionState {
@@ -37,10 +42,24 @@ class TdiCFrontEndSessionState {
   TdiCFrontEndSessionState(TdiCFrontEndSessionState const &) = delete;
   void operator=(TdiCFrontEndSessionState const &) = delete;
 
+  // Number of shards, a power of 2
+  static const size_t kNumShards = 64;
+
  private:
   TdiCFrontEndSessionState() {}
-  std::mutex state_lock;
-  std::map<const Session *, std::shared_ptr<Session> > sessionStateMap;
+
+  // Sessions are spread over shards by pointer, each with its own lock, so
+  // threads working on different sessions rarely contend. Shards are
+  // cache line aligned to keep their locks from false sharing
+  struct alignas(64) Shard {
+    std::mutex state_lock;
+    std::unordered_map<const Session *, std::shared_ptr<Session>>
+        sessionStateMap;
+  };
+
+  Shard &shardGet(const Session *session_raw);
+
+  Shard shards_[kNumShards];
 };
 
 }  // tdi_c
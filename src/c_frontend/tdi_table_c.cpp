@@ -117,6 +117,39 @@ tdi_status_t tdi_table_entry_get(const tdi_table_hdl *table_hdl,
                          reinterpret_cast<tdi::TableData *>(data));
 }
 
+tdi_status_t tdi_table_entry_get_batch(const tdi_table_hdl *table_hdl,
+                                       const tdi_session_hdl *session,
+                                       const tdi_target_hdl *target,
+                                       const tdi_flags_hdl *flags,
+                                       const tdi_table_key_hdl **keys,
+                                       tdi_table_data_hdl **data,
+                                       uint32_t n,
+                                       tdi_status_t *statuses) {
+  if (keys == nullptr || data == nullptr || statuses == nullptr) {
+    LOG_ERROR("%s:%d Invalid arg", __func__, __LINE__);
+    return TDI_INVALID_ARG;
+  }
+  auto table = reinterpret_cast<const tdi::Table *>(table_hdl);
+  std::vector<const tdi::TableKey *> key_vec(n);
+  std::vector<tdi::TableData *> data_vec(n);
+  for (uint32_t i = 0; i < n; i++) {
+    key_vec[i] = reinterpret_cast<const tdi::TableKey *>(keys[i]);
+    data_vec[i] = reinterpret_cast<tdi::TableData *>(data[i]);
+  }
+  std::vector<tdi_status_t> status_vec;
+  auto status =
+      table->entryGetBatch(*reinterpret_cast<const tdi::Session *>(session),
+                           *reinterpret_cast<const tdi::Target *>(target),
+                           *reinterpret_cast<const tdi::Flags *>(flags),
+                           key_vec,
+                           data_vec,
+                           &status_vec);
+  for (uint32_t i = 0; i < status_vec.size(); i++) {
+    statuses[i] = status_vec[i];
+  }
+  return status;
+}
+
 tdi_status_t tdi_table_entry_get_by_handle(const tdi_table_hdl *table_hdl,
                                            const tdi_session_hdl *session,
                                            const tdi_target_hdl *target,
@@ -278,7 +311,7 @@ tdi_status_t tdi_table_key_allocate(const tdi_table_hdl *table_hdl,
                                     tdi_table_key_hdl **key_hdl_ret) {
   auto table = reinterpret_cast<const tdi::Table *>(table_hdl);
   std::unique_ptr<tdi::TableKey> key_hdl;
-  auto status = table->keyAllocate(&key_hdl);
+  auto status = table->keyPoolAllocate(&key_hdl);
   *key_hdl_ret = reinterpret_cast<tdi_table_key_hdl *>(key_hdl.release());
   return status;
 }
@@ -287,7 +320,7 @@ tdi_status_t tdi_table_data_allocate(const tdi_table_hdl *table_hdl,
                                      tdi_table_data_hdl **data_hdl_ret) {
   auto table = reinterpret_cast<const tdi::Table *>(table_hdl);
   std::unique_ptr<tdi::TableData> data_hdl;
-  auto status = table->dataAllocate(&data_hdl);
+  auto status = table->dataPoolAllocate({}, 0, &data_hdl);
   *data_hdl_ret = reinterpret_cast<tdi_table_data_hdl *>(data_hdl.release());
 
   return status;
@@ -298,7 +331,7 @@ tdi_status_t tdi_table_action_data_allocate(const tdi_table_hdl *table_hdl,
                                             tdi_table_data_hdl **data_hdl_ret) {
   auto table = reinterpret_cast<const tdi::Table *>(table_hdl);
   std::unique_ptr<tdi::TableData> data_hdl;
-  auto status = table->dataAllocate(action_id, &data_hdl);
+  auto status = table->dataPoolAllocate({}, action_id, &data_hdl);
   *data_hdl_ret = reinterpret_cast<tdi_table_data_hdl *>(data_hdl.release());
   return status;
 }
@@ -312,7 +345,7 @@ tdi_status_t tdi_table_data_allocate_with_fields(
   std::unique_ptr<tdi::TableData> data_hdl;
   const auto vec = std::vector<tdi_id_t>(fields, fields + num_array);
 
-  auto status = table->dataAllocate(vec, &data_hdl);
+  auto status = table->dataPoolAllocate(vec, 0, &data_hdl);
   *data_hdl_ret = reinterpret_cast<tdi_table_data_hdl *>(data_hdl.release());
 
   return status;
@@ -328,7 +361,7 @@ tdi_status_t tdi_table_action_data_allocate_with_fields(
   std::unique_ptr<tdi::TableData> data_hdl;
   const auto vec = std::vector<tdi_id_t>(fields, fields + num_array);
 
-  auto status = table->dataAllocate(vec, action_id, &data_hdl);
+  auto status = table->dataPoolAllocate(vec, action_id, &data_hdl);
   *data_hdl_ret = reinterpret_cast<tdi_table_data_hdl *>(data_hdl.release());
 
   return status;
@@ -469,8 +502,13 @@ tdi_status_t tdi_table_key_deallocate(tdi_table_key_hdl *key_hdl) {
     LOG_ERROR("%s:%d null param passed", __func__, __LINE__);
     return TDI_INVALID_ARG;
   }
-  delete key;
-  return TDI_SUCCESS;
+  const tdi::Table *table = nullptr;
+  key->tableGet(&table);
+  if (table == nullptr) {
+    delete key;
+    return TDI_SUCCESS;
+  }
+  return table->keyPoolRelease(std::unique_ptr<tdi::TableKey>(key));
 }
 
 tdi_status_t tdi_table_data_deallocate(tdi_table_data_hdl *data_hdl) {
@@ -479,8 +517,25 @@ tdi_status_t tdi_table_data_deallocate(tdi_table_data_hdl *data_hdl) {
     LOG_ERROR("%s:%d null param passed", __func__, __LINE__);
     return TDI_INVALID_ARG;
   }
-  delete data;
-  return TDI_SUCCESS;
+  const tdi::Table *table = nullptr;
+  data->getParent(&table);
+  if (table == nullptr) {
+    delete data;
+    return TDI_SUCCESS;
+  }
+  return table->dataPoolRelease(std::unique_ptr<tdi::TableData>(data));
+}
+
+tdi_status_t tdi_table_key_pool_size_set(const tdi_table_hdl *table_hdl,
+                                         const size_t size) {
+  auto table = reinterpret_cast<const tdi::Table *>(table_hdl);
+  return table->keyPoolSizeSet(size);
+}
+
+tdi_status_t tdi_table_data_pool_size_set(const tdi_table_hdl *table_hdl,
+                                          const size_t size) {
+  auto table = reinterpret_cast<const tdi::Table *>(table_hdl);
+  return table->dataPoolSizeSet(size);
 }
 
 tdi_status_t tdi_table_attributes_deallocate(tdi_attributes_hdl *tbl_attr_hdl) {
@@ -130,6 +130,14 @@ tdi_status_t tdi_data_field_get_value_ptr(const tdi_table_data_hdl *data_hdl,
   return data_field->getValue(field_id, size, val);
 }
 
+tdi_status_t tdi_data_field_get_value_view(const tdi_table_data_hdl *data_hdl,
+                                           const tdi_id_t field_id,
+                                           const uint8_t **val,
+                                           size_t *size) {
+  auto data_field = reinterpret_cast<const tdi::TableData *>(data_hdl);
+  return data_field->getValueView(field_id, val, size);
+}
+
 tdi_status_t tdi_data_field_get_value_array(
     const tdi_table_data_hdl *data_hdl,
     const tdi_id_t field_id,
@@ -225,8 +225,7 @@ tdi_status_t tdi_key_field_id_list_get(const tdi_table_info_hdl *table_info_hdl,
   }
 
   auto tableInfo = reinterpret_cast<const tdi::TableInfo *>(table_info_hdl);
-  std::vector<tdi_id_t> temp_vec;
-  temp_vec = tableInfo->keyFieldIdListGet();
+  const auto &temp_vec = tableInfo->keyFieldIdListGet();
 
   for (auto it = temp_vec.begin(); it != temp_vec.end(); ++it) {
     tdi_id_t field_id = *it;
@@ -360,8 +359,7 @@ tdi_status_t tdi_data_field_list_get(const tdi_table_info_hdl *table_info_hdl,
   }
 
   auto tableInfo = reinterpret_cast<const tdi::TableInfo *>(table_info_hdl);
-  std::vector<tdi_id_t> field_ids;
-  field_ids = tableInfo->dataFieldIdListGet();
+  const auto &field_ids = tableInfo->dataFieldIdListGet();
   for (auto it = field_ids.begin(); it != field_ids.end(); ++it) {
     tdi_id_t field_id = *it;
     id_vec_ret[it - field_ids.begin()] = field_id;
@@ -436,8 +434,7 @@ tdi_status_t tdi_data_field_list_with_action_get(
   }
 
   auto tableInfo = reinterpret_cast<const tdi::TableInfo *>(table_info_hdl);
-  // std::vector<tdi_id_t> field_ids;
-  auto field_ids = tableInfo->dataFieldIdListGet(action_id);
+  const auto &field_ids = tableInfo->dataFieldIdListGet(action_id);
   for (auto it = field_ids.begin(); it != field_ids.end(); ++it) {
     tdi_id_t field_id = *it;
     id_vec_ret[it - field_ids.begin()] = field_id;
@@ -758,8 +755,7 @@ tdi_status_t tdi_action_id_list_size_get(
   }
 
   auto tableInfo = reinterpret_cast<const tdi::TableInfo *>(table_info_hdl);
-  auto action_ids = tableInfo->actionIdListGet();
-  *num = action_ids.size();
+  *num = tableInfo->actionIdListGet().size();
 
   return TDI_SUCCESS;
 }
@@ -778,7 +774,7 @@ tdi_status_t tdi_action_id_list_get(const tdi_table_info_hdl *table_info_hdl,
   }
 
   auto tableInfo = reinterpret_cast<const tdi::TableInfo *>(table_info_hdl);
-  auto action_ids = tableInfo->actionIdListGet();
+  const auto &action_ids = tableInfo->actionIdListGet();
   for (auto it = action_ids.begin(); it != action_ids.end(); ++it) {
     tdi_id_t action_id = *it;
     id_vec_ret[it - action_ids.begin()] = action_id;
@@ -0,0 +1,287 @@
+/*
+ * Copyright(c) 2021 Intel Corporation.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this software except as stipulated in the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <cstring>
+#include <new>
+
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
+#include "tdi_dummy_exact_match_engine.hpp"
+
+namespace tdi {
+namespace tna {
+namespace dummy {
+
+namespace {
+
+const size_t kMinBuckets = 4;
+
+inline uint64_t rotl64(const uint64_t &x, const int &r) {
+  return (x << r) | (x >> (64 - r));
+}
+
+inline uint64_t fmix64(uint64_t k) {
+  k ^= k >> 33;
+  k *= 0xff51afd7ed558ccdULL;
+  k ^= k >> 33;
+  k *= 0xc4ceb9fe1a85ec53ULL;
+  k ^= k >> 33;
+  return k;
+}
+
+}  // namespace
+
+const int ExactMatchEngine::kSlotsPerBucket;
+const uint8_t ExactMatchEngine::kTagEmpty;
+const uint8_t ExactMatchEngine::kTagDeleted;
+const uint8_t ExactMatchEngine::kTagPad;
+
+ExactMatchEngine::ExactMatchEngine(const size_t &key_size)
+    : key_size_(key_size) {}
+
+ExactMatchEngine::~ExactMatchEngine() { std::free(buckets_); }
+
+uint64_t ExactMatchEngine::hashBytes(const uint8_t *key, const size_t &len) {
+  const uint64_t m = 0x9e3779b97f4a7c15ULL;
+  uint64_t h = len * m;
+  size_t i = 0;
+  for (; i + 8 <= len; i += 8) {
+    uint64_t w;
+    std::memcpy(&w, key + i, sizeof(w));
+    h = rotl64(h ^ (w * m), 29) * m;
+  }
+  if (i < len) {
+    uint64_t w = 0;
+    std::memcpy(&w, key + i, len - i);
+    h = rotl64(h ^ (w * m), 29) * m;
+  }
+  return fmix64(h);
+}
+
+uint32_t ExactMatchEngine::matchTag(const Bucket &bucket, const uint8_t &tag) {
+#if defined(__SSE2__)
+  const __m128i tags =
+      _mm_load_si128(reinterpret_cast<const __m128i *>(bucket.tags));
+  const __m128i needle = _mm_set1_epi8(static_cast<char>(tag));
+  return static_cast<uint32_t>(
+      _mm_movemask_epi8(_mm_cmpeq_epi8(tags, needle)));
+#else
+  uint32_t mask = 0;
+  for (int i = 0; i < kSlotsPerBucket; i++) {
+    if (bucket.tags[i] == tag) mask |= (1u << i);
+  }
+  return mask;
+#endif
+}
+
+bool ExactMatchEngine::findSlot(const uint8_t *key,
+                                const uint64_t &hash,
+                                size_t *bucket_idx,
+                                int *slot) const {
+  if (!num_buckets_) return false;
+  const uint8_t tag = tagOf(hash);
+  size_t idx = static_cast<size_t>(hash) & bucket_mask_;
+  for (size_t probes = 0; probes < num_buckets_; probes++) {
+    const Bucket &bucket = buckets_[idx];
+    uint32_t match = matchTag(bucket, tag);
+    while (match) {
+      const int i = __builtin_ctz(match);
+      match &= match - 1;
+      const uint32_t h = bucket.handles[i];
+      if (hashes_[h] == hash &&
+          std::memcmp(keyGet(h), key, key_size_) == 0) {
+        *bucket_idx = idx;
+        *slot = i;
+        return true;
+      }
+    }
+    if (matchTag(bucket, kTagEmpty)) return false;
+    idx = (idx + 1) & bucket_mask_;
+  }
+  return false;
+}
+
+void ExactMatchEngine::placeHandle(const uint64_t &hash,
+                                   const uint32_t &handle) {
+  size_t idx = static_cast<size_t>(hash) & bucket_mask_;
+  while (true) {
+    Bucket &bucket = buckets_[idx];
+    uint32_t avail =
+        matchTag(bucket, kTagEmpty) | matchTag(bucket, kTagDeleted);
+    if (avail) {
+      const int i = __builtin_ctz(avail);
+      if (bucket.tags[i] == kTagEmpty) used_slots_++;
+      bucket.tags[i] = tagOf(hash);
+      bucket.handles[i] = handle;
+      return;
+    }
+    idx = (idx + 1) & bucket_mask_;
+  }
+}
+
+void ExactMatchEngine::rehash(const size_t &num_buckets) {
+  void *mem = nullptr;
+  if (posix_memalign(&mem, sizeof(Bucket), num_buckets * sizeof(Bucket))) {
+    throw std::bad_alloc();
+  }
+  std::free(buckets_);
+  buckets_ = static_cast<Bucket *>(mem);
+  num_buckets_ = num_buckets;
+  bucket_mask_ = num_buckets - 1;
+  for (size_t i = 0; i < num_buckets_; i++) {
+    std::memset(buckets_[i].tags, kTagEmpty, kSlotsPerBucket);
+    std::memset(buckets_[i].tags + kSlotsPerBucket,
+                kTagPad,
+                sizeof(buckets_[i].tags) - kSlotsPerBucket);
+  }
+  used_slots_ = 0;
+  for (uint32_t h = 0; h < handleEnd(); h++) {
+    if (in_use_[h]) placeHandle(hashes_[h], h);
+  }
+}
+
+uint32_t ExactMatchEngine::handleAllocate() {
+  if (!free_handles_.empty()) {
+    const uint32_t handle = free_handles_.back();
+    free_handles_.pop_back();
+    return handle;
+  }
+  const uint32_t handle = handleEnd();
+  keys_.resize(keys_.size() + key_size_);
+  hashes_.push_back(0);
+  in_use_.push_back(false);
+  return handle;
+}
+
+tdi_status_t ExactMatchEngine::insert(const uint8_t *key, uint32_t *handle) {
+  const uint64_t hash = hashBytes(key, key_size_);
+  size_t idx;
+  int slot;
+  if (findSlot(key, hash, &idx, &slot)) {
+    *handle = buckets_[idx].handles[slot];
+    return TDI_ALREADY_EXISTS;
+  }
+  // Keep at least 1/8th of the slots empty so that probing terminates
+  // quickly. Tombstones count as used, a rehash drops them.
+  const size_t capacity = num_buckets_ * kSlotsPerBucket;
+  if ((used_slots_ + 1) * 8 > capacity * 7) {
+    size_t new_buckets = num_buckets_ ? num_buckets_ : kMinBuckets;
+    while ((size_ + 1) * 8 * 2 > new_buckets * kSlotsPerBucket * 7) {
+      new_buckets <<= 1;
+    }
+    rehash(new_buckets);
+  }
+  *handle = handleAllocate();
+  std::memcpy(&keys_[static_cast<size_t>(*handle) * key_size_],
+              key,
+              key_size_);
+  hashes_[*handle] = hash;
+  in_use_[*handle] = true;
+  placeHandle(hash, *handle);
+  size_++;
+  return TDI_SUCCESS;
+}
+
+tdi_status_t ExactMatchEngine::find(const uint8_t *key,
+                                    uint32_t *handle) const {
+  size_t idx;
+  int slot;
+  if (!findSlot(key, hashBytes(key, key_size_), &idx, &slot)) {
+    return TDI_OBJECT_NOT_FOUND;
+  }
+  *handle = buckets_[idx].handles[slot];
+  return TDI_SUCCESS;
+}
+
+void ExactMatchEngine::findBatch(const uint8_t *const *keys,
+                                 const size_t &count,
+                                 uint32_t *handles,
+                                 tdi_status_t *statuses) const {
+  uint64_t hashes[kBatchGroup];
+  for (size_t base = 0; base < count; base += kBatchGroup) {
+    const size_t group =
+        (count - base < kBatchGroup) ? count - base : kBatchGroup;
+    for (size_t i = 0; i < group; i++) {
+      hashes[i] = hashBytes(keys[base + i], key_size_);
+      if (num_buckets_) {
+        __builtin_prefetch(&buckets_[static_cast<size_t>(hashes[i]) &
+                                     bucket_mask_]);
+      }
+    }
+    for (size_t i = 0; i < group; i++) {
+      size_t idx;
+      int slot;
+      if (findSlot(keys[base + i], hashes[i], &idx, &slot)) {
+        handles[base + i] = buckets_[idx].handles[slot];
+        statuses[base + i] = TDI_SUCCESS;
+      } else {
+        statuses[base + i] = TDI_OBJECT_NOT_FOUND;
+      }
+    }
+  }
+}
+
+tdi_status_t ExactMatchEngine::erase(const uint8_t *key, uint32_t *handle) {
+  size_t idx;
+  int slot;
+  if (!findSlot(key, hashBytes(key, key_size_), &idx, &slot)) {
+    return TDI_OBJECT_NOT_FOUND;
+  }
+  Bucket &bucket = buckets_[idx];
+  *handle = bucket.handles[slot];
+  // A bucket which still has an empty tag ends every probe sequence going
+  // through it, so the slot can go back to empty instead of a tombstone.
+  if (matchTag(bucket, kTagEmpty)) {
+    bucket.tags[slot] = kTagEmpty;
+    used_slots_--;
+  } else {
+    bucket.tags[slot] = kTagDeleted;
+  }
+  in_use_[*handle] = false;
+  free_handles_.push_back(*handle);
+  size_--;
+  return TDI_SUCCESS;
+}
+
+void ExactMatchEngine::reserve(const size_t &count) {
+  size_t new_buckets = num_buckets_ ? num_buckets_ : kMinBuckets;
+  while (count * 8 > new_buckets * kSlotsPerBucket * 7) {
+    new_buckets <<= 1;
+  }
+  if (new_buckets != num_buckets_) rehash(new_buckets);
+  keys_.reserve(count * key_size_);
+  hashes_.reserve(count);
+  in_use_.reserve(count);
+}
+
+void ExactMatchEngine::clear() {
+  std::free(buckets_);
+  buckets_ = nullptr;
+  num_buckets_ = 0;
+  bucket_mask_ = 0;
+  size_ = 0;
+  used_slots_ = 0;
+  keys_.clear();
+  hashes_.clear();
+  in_use_.clear();
+  free_handles_.clear();
+}
+
+}  // namespace dummy
+}  // namespace tna
+}  // namespace tdi
@@ -0,0 +1,189 @@
+/*
+ * Copyright(c) 2021 Intel Corporation.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this software except as stipulated in the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+/** @file tdi_dummy_exact_match_engine.hpp
+ *
+ *  @brief Contains the software exact match engine used by dummy tables
+ */
+#ifndef _TDI_DUMMY_EXACT_MATCH_ENGINE_HPP
+#define _TDI_DUMMY_EXACT_MATCH_ENGINE_HPP
+
+#include <cstdint>
+#include <cstdlib>
+#include <vector>
+
+#include <tdi/common/tdi_defs.h>
+
+namespace tdi {
+namespace tna {
+namespace dummy {
+
+/**
+ * @brief Open addressing hash table keyed on fixed size packed key bytes.
+ *
+ * Every key inserted is given a handle. Handles are dense, are recycled
+ * after delete and index a key arena owned by the engine, so that the
+ * caller can keep per entry state in a plain vector indexed by the same
+ * handle.
+ *
+ * The slot array is made of cache line sized buckets. A bucket holds 12
+ * one byte tags (7 bits of the hash) followed by the 12 handles they
+ * belong to. A lookup loads the 16 tag bytes of a bucket at once and
+ * compares all of them against the tag of the key with a single SIMD
+ * compare, so the key arena is only touched for real candidates. Probing
+ * is linear over buckets and stops at the first bucket which still has an
+ * empty tag.
+ */
+class ExactMatchEngine {
+ public:
+  ExactMatchEngine(const size_t &key_size);
+  ~ExactMatchEngine();
+
+  /**
+   * @brief Insert a key
+   *
+   * @param[in] key Packed key bytes. key_size bytes are read
+   * @param[out] handle Handle assigned to the key
+   *
+   * @return TDI_ALREADY_EXISTS if the key is present
+   */
+  tdi_status_t insert(const uint8_t *key, uint32_t *handle);
+
+  /**
+   * @brief Find a key
+   *
+   * @param[in] key Packed key bytes
+   * @param[out] handle Handle of the key
+   *
+   * @return TDI_OBJECT_NOT_FOUND if the key is not present
+   */
+  tdi_status_t find(const uint8_t *key, uint32_t *handle) const;
+
+  /**
+   * @brief Find a batch of keys. The buckets of a group of keys are
+   * prefetched before any of them is probed, so that the cache misses of
+   * the group overlap instead of being taken one after another.
+   *
+   * @param[in] keys Packed key bytes of each key
+   * @param[in] count Number of keys
+   * @param[out] handles Handle of each key found
+   * @param[out] statuses TDI_OBJECT_NOT_FOUND for each key not present
+   */
+  void findBatch(const uint8_t *const *keys,
+                 const size_t &count,
+                 uint32_t *handles,
+                 tdi_status_t *statuses) const;
+
+  /**
+   * @brief Remove a key. The handle returned is free for reuse by the
+   * next insert.
+   *
+   * @param[in] key Packed key bytes
+   * @param[out] handle Handle the key had
+   *
+   * @return TDI_OBJECT_NOT_FOUND if the key is not present
+   */
+  tdi_status_t erase(const uint8_t *key, uint32_t *handle);
+
+  /**
+   * @brief Size the slot array and the per handle state for count keys, so
+   * that inserts up to count keys do not rehash
+   */
+  void reserve(const size_t &count);
+
+  /**
+   * @brief Remove all keys and release the slot array
+   */
+  void clear();
+
+  /**
+   * @brief Get the key bytes of a handle in use
+   */
+  const uint8_t *keyGet(const uint32_t &handle) const {
+    return &keys_[static_cast<size_t>(handle) * key_size_];
+  };
+
+  /**
+   * @brief Whether a handle is currently assigned to a key
+   */
+  bool handleInUse(const uint32_t &handle) const {
+    return handle < in_use_.size() && in_use_[handle];
+  };
+
+  /**
+   * @brief One past the highest handle ever assigned. Iterating over
+   * [0, handleEnd()) and skipping free handles visits every key
+   */
+  uint32_t handleEnd() const {
+    return static_cast<uint32_t>(in_use_.size());
+  };
+
+  const size_t &sizeGet() const { return size_; };
+  const size_t &keySizeGet() const { return key_size_; };
+
+  ExactMatchEngine(const ExactMatchEngine &) = delete;
+  ExactMatchEngine &operator=(const ExactMatchEngine &) = delete;
+
+ private:
+  static const int kSlotsPerBucket = 12;
+  // Keys hashed and prefetched together by findBatch()
+  static const size_t kBatchGroup = 8;
+  static const uint8_t kTagEmpty = 0x80;
+  static const uint8_t kTagDeleted = 0xFE;
+  // Tags past kSlotsPerBucket never match an empty, deleted or full tag
+  static const uint8_t kTagPad = 0xFF;
+
+  struct Bucket {
+    uint8_t tags[16];
+    uint32_t handles[kSlotsPerBucket];
+  };
+  static_assert(sizeof(Bucket) == 64, "Bucket must fill one cache line");
+
+  static uint64_t hashBytes(const uint8_t *key, const size_t &len);
+  static uint8_t tagOf(const uint64_t &hash) {
+    return static_cast<uint8_t>(hash >> 57);
+  };
+  // Bitmask of slots in the bucket whose tag is equal to tag
+  static uint32_t matchTag(const Bucket &bucket, const uint8_t &tag);
+
+  bool findSlot(const uint8_t *key,
+                const uint64_t &hash,
+                size_t *bucket_idx,
+                int *slot) const;
+  void placeHandle(const uint64_t &hash, const uint32_t &handle);
+  void rehash(const size_t &num_buckets);
+  uint32_t handleAllocate();
+
+  const size_t key_size_;
+  Bucket *buckets_{nullptr};
+  size_t bucket_mask_{0};
+  size_t num_buckets_{0};
+  // Number of keys
+  size_t size_{0};
+  // Number of slots holding a key or a tombstone
+  size_t used_slots_{0};
+
+  // Per handle state
+  std::vector<uint8_t> keys_;
+  std::vector<uint64_t> hashes_;
+  std::vector<bool> in_use_;
+  std::vector<uint32_t> free_handles_;
+};
+
+}  // namespace dummy
+}  // namespace tna
+}  // namespace tdi
+
+#endif  // _TDI_DUMMY_EXACT_MATCH_ENGINE_HPP
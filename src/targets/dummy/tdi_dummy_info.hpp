@@ -110,6 +110,22 @@ class TableFactory : public tdi::tna::TableFactory {
     }
     return nullptr;
   };
+
+  // Entries of direct match tables live in the table obj, share them
+  virtual std::unique_ptr<tdi::Table> remakeTable(
+      const TdiInfo *tdi_info,
+      const tdi::TableInfo *table_info,
+      const tdi::Table *prev_table) const override {
+    if (table_info && prev_table &&
+        static_cast<tdi_dummy_table_type_e>(table_info->tableTypeGet()) ==
+            TDI_DUMMY_TABLE_TYPE_MATCH_DIRECT) {
+      return std::unique_ptr<tdi::Table>(new MatchActionDirect(
+          tdi_info,
+          table_info,
+          static_cast<const MatchActionDirect *>(prev_table)));
+    }
+    return makeTable(tdi_info, table_info);
+  };
 };
 
 }  // namespace dummy
@@ -39,21 +39,42 @@ Device::Device(const tdi_dev_id_t &device_id,
                 program_config.prog_name_.c_str());
       continue;
     }
-    auto tdi_info_mapper = std::unique_ptr<tdi::TdiInfoMapper>(
-        new tdi::tna::dummy::TdiInfoMapper());
-    auto table_factory =
-        std::unique_ptr<tdi::TableFactory>(new tdi::tna::dummy::TableFactory());
-
-    auto tdi_info_parser = std::unique_ptr<TdiInfoParser>(
-        new TdiInfoParser(std::move(tdi_info_mapper)));
-    tdi_info_parser->parseTdiInfo(program_config.tdi_info_file_paths_);
-    auto tdi_info = tdi::TdiInfo::makeTdiInfo(program_config.prog_name_,
-                                              std::move(tdi_info_parser),
-                                              table_factory.get());
+    std::unique_ptr<const TdiInfo> tdi_info;
+    if (tdiInfoCreate(program_config, nullptr, &tdi_info) != TDI_SUCCESS) {
+      LOG_ERROR("%s:%d Failed to create TdiInfo for %s",
+                __func__,
+                __LINE__,
+                program_config.prog_name_.c_str());
+      continue;
+    }
     tdi_info_map_[program_config.prog_name_] = std::move(tdi_info);
   }
 }
 
+tdi_status_t Device::tdiInfoCreate(const tdi::ProgramConfig &program_config,
+                                   const TdiInfo *prev_tdi_info,
+                                   std::unique_ptr<const TdiInfo> *tdi_info)
+    const {
+  auto tdi_info_mapper = std::unique_ptr<tdi::TdiInfoMapper>(
+      new tdi::tna::dummy::TdiInfoMapper());
+  auto table_factory =
+      std::unique_ptr<tdi::TableFactory>(new tdi::tna::dummy::TableFactory());
+
+  auto tdi_info_parser = std::unique_ptr<TdiInfoParser>(
+      new TdiInfoParser(std::move(tdi_info_mapper)));
+  auto status = tdi_info_parser->parseTdiInfo(
+      program_config.tdi_info_file_paths_, program_config.schema_cache_dir_);
+  if (status != TDI_SUCCESS) {
+    return status;
+  }
+  *tdi_info = tdi::TdiInfo::makeTdiInfo(program_config.prog_name_,
+                                        std::move(tdi_info_parser),
+                                        std::move(table_factory),
+                                        program_config.lazy_tables_,
+                                        prev_tdi_info);
+  return *tdi_info ? TDI_SUCCESS : TDI_UNEXPECTED;
+}
+
 tdi_status_t Init::tdiModuleInit(
     const std::vector<tdi_mgr_type_e> mgr_type_list) {
   auto &dev_mgr_obj = DevMgr::getInstance();
@@ -67,6 +67,12 @@ class Device : public tdi::tna::Device {
       std::unique_ptr<tdi::Flags> * /*flags*/) const override final {
     return TDI_SUCCESS;
   }
+
+ protected:
+  tdi_status_t tdiInfoCreate(
+      const tdi::ProgramConfig &program_config,
+      const TdiInfo *prev_tdi_info,
+      std::unique_ptr<const TdiInfo> *tdi_info) const override;
 };
 
 /**
@@ -0,0 +1,212 @@
+/*
+ * Copyright(c) 2021 Intel Corporation.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this software except as stipulated in the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <algorithm>
+#include <cstring>
+
+#include "tdi_dummy_lpm_match_engine.hpp"
+
+namespace tdi {
+namespace tna {
+namespace dummy {
+
+namespace {
+
+inline uint8_t lenMask(const uint8_t &len) {
+  return len ? static_cast<uint8_t>(0xff << (8 - len)) : 0;
+}
+
+}  // namespace
+
+const uint32_t LpmMatchEngine::kNone;
+
+LpmMatchEngine::LpmMatchEngine(const size_t &key_size) : key_size_(key_size) {
+  nodeAllocate(kNone, 0);
+}
+
+uint32_t LpmMatchEngine::rank(const uint64_t *bits, const uint8_t &slot) {
+  const int word = slot >> 6;
+  const int bit = slot & 63;
+  uint32_t count = 0;
+  for (int i = 0; i < word; i++) {
+    count += __builtin_popcountll(bits[i]);
+  }
+  const uint64_t mask = (bit == 63) ? ~0ULL : ((1ULL << (bit + 1)) - 1);
+  return count + __builtin_popcountll(bits[word] & mask);
+}
+
+uint32_t LpmMatchEngine::nodeAllocate(const uint32_t &parent,
+                                      const uint8_t &parent_slot) {
+  uint32_t node_id;
+  if (!free_nodes_.empty()) {
+    node_id = free_nodes_.back();
+    free_nodes_.pop_back();
+  } else {
+    node_id = static_cast<uint32_t>(nodes_.size());
+    nodes_.emplace_back();
+  }
+  auto &node = nodes_[node_id];
+  std::memset(node.child_bits, 0, sizeof(node.child_bits));
+  std::memset(node.leaf_bits, 0, sizeof(node.leaf_bits));
+  node.children.clear();
+  node.routes.clear();
+  // A single run of "no route" over the whole node
+  node.leaf_bits[0] = 1;
+  node.leaves.assign(1, kNone);
+  node.parent = parent;
+  node.parent_slot = parent_slot;
+  return node_id;
+}
+
+void LpmMatchEngine::nodeLeavesBuild(Node *node) {
+  uint32_t expanded[256];
+  std::fill(expanded, expanded + 256, kNone);
+  // Paint shorter routes first so that longer ones overwrite them
+  std::vector<LocalRoute> routes = node->routes;
+  std::sort(routes.begin(),
+            routes.end(),
+            [](const LocalRoute &a, const LocalRoute &b) {
+              return a.len < b.len;
+            });
+  for (const auto &route : routes) {
+    const uint32_t count = 1u << (8 - route.len);
+    std::fill(expanded + route.bits, expanded + route.bits + count,
+              route.handle);
+  }
+  std::memset(node->leaf_bits, 0, sizeof(node->leaf_bits));
+  node->leaves.clear();
+  for (uint32_t slot = 0; slot < 256; slot++) {
+    if (slot == 0 || expanded[slot] != expanded[slot - 1]) {
+      node->leaf_bits[slot >> 6] |= (1ULL << (slot & 63));
+      node->leaves.push_back(expanded[slot]);
+    }
+  }
+}
+
+void LpmMatchEngine::nodeRelease(uint32_t node_id) {
+  // Free nodes left with neither routes nor children, up to the root
+  while (node_id != 0) {
+    auto &node = nodes_[node_id];
+    if (!node.routes.empty() || !node.children.empty()) return;
+    const uint32_t parent_id = node.parent;
+    const uint8_t slot = node.parent_slot;
+    auto &parent = nodes_[parent_id];
+    parent.children.erase(parent.children.begin() +
+                          (rank(parent.child_bits, slot) - 1));
+    parent.child_bits[slot >> 6] &= ~(1ULL << (slot & 63));
+    free_nodes_.push_back(node_id);
+    node_id = parent_id;
+  }
+}
+
+tdi_status_t LpmMatchEngine::insert(const uint32_t &handle,
+                                    const uint8_t *prefix,
+                                    const size_t &prefix_len) {
+  if (prefix_len > key_size_ * 8) {
+    return TDI_INVALID_ARG;
+  }
+  if (handle < routes_.size() && routes_[handle].node != kNone) {
+    return TDI_ALREADY_EXISTS;
+  }
+  const size_t depth = prefix_len ? (prefix_len - 1) / 8 : 0;
+  const uint8_t len = static_cast<uint8_t>(prefix_len - depth * 8);
+  const uint8_t bits = prefix_len ? (prefix[depth] & lenMask(len)) : 0;
+
+  uint32_t node_id = 0;
+  for (size_t d = 0; d < depth; d++) {
+    const uint8_t slot = prefix[d];
+    if (bitGet(nodes_[node_id].child_bits, slot)) {
+      auto &node = nodes_[node_id];
+      node_id = node.children[rank(node.child_bits, slot) - 1];
+      continue;
+    }
+    // nodes_ may grow, so only take references after allocating
+    const uint32_t child_id = nodeAllocate(node_id, slot);
+    auto &node = nodes_[node_id];
+    node.children.insert(node.children.begin() + rank(node.child_bits, slot),
+                         child_id);
+    node.child_bits[slot >> 6] |= (1ULL << (slot & 63));
+    node_id = child_id;
+  }
+
+  auto &node = nodes_[node_id];
+  for (const auto &route : node.routes) {
+    if (route.bits == bits && route.len == len) {
+      return TDI_ALREADY_EXISTS;
+    }
+  }
+  LocalRoute local_route;
+  local_route.bits = bits;
+  local_route.len = len;
+  local_route.handle = handle;
+  node.routes.push_back(local_route);
+  nodeLeavesBuild(&node);
+
+  if (handle >= routes_.size()) {
+    routes_.resize(handle + 1);
+  }
+  routes_[handle].node = node_id;
+  routes_[handle].bits = bits;
+  routes_[handle].len = len;
+  size_++;
+  return TDI_SUCCESS;
+}
+
+tdi_status_t LpmMatchEngine::erase(const uint32_t &handle) {
+  if (handle >= routes_.size() || routes_[handle].node == kNone) {
+    return TDI_OBJECT_NOT_FOUND;
+  }
+  const uint32_t node_id = routes_[handle].node;
+  auto &node = nodes_[node_id];
+  node.routes.erase(std::find_if(node.routes.begin(),
+                                 node.routes.end(),
+                                 [&handle](const LocalRoute &route) {
+                                   return route.handle == handle;
+                                 }));
+  nodeLeavesBuild(&node);
+  nodeRelease(node_id);
+  routes_[handle] = Route();
+  size_--;
+  return TDI_SUCCESS;
+}
+
+tdi_status_t LpmMatchEngine::lookup(const uint8_t *key,
+                                    uint32_t *handle) const {
+  uint32_t best = kNone;
+  const Node *node = &nodes_[0];
+  for (size_t d = 0; d < key_size_; d++) {
+    const uint8_t slot = key[d];
+    const uint32_t leaf = node->leaves[rank(node->leaf_bits, slot) - 1];
+    if (leaf != kNone) best = leaf;
+    if (!bitGet(node->child_bits, slot)) break;
+    node = &nodes_[node->children[rank(node->child_bits, slot) - 1]];
+  }
+  if (best == kNone) return TDI_OBJECT_NOT_FOUND;
+  *handle = best;
+  return TDI_SUCCESS;
+}
+
+void LpmMatchEngine::clear() {
+  size_ = 0;
+  nodes_.clear();
+  free_nodes_.clear();
+  routes_.clear();
+  nodeAllocate(kNone, 0);
+}
+
+}  // namespace dummy
+}  // namespace tna
+}  // namespace tdi
@@ -0,0 +1,135 @@
+/*
+ * Copyright(c) 2021 Intel Corporation.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this software except as stipulated in the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+/** @file tdi_dummy_lpm_match_engine.hpp
+ *
+ *  @brief Contains the software longest prefix match engine used by dummy
+ *  tables
+ */
+#ifndef _TDI_DUMMY_LPM_MATCH_ENGINE_HPP
+#define _TDI_DUMMY_LPM_MATCH_ENGINE_HPP
+
+#include <cstdint>
+#include <vector>
+
+#include <tdi/common/tdi_defs.h>
+
+namespace tdi {
+namespace tna {
+namespace dummy {
+
+/**
+ * @brief Compressed multibit trie over keys of any byte width, in the style
+ * of Poptrie.
+ *
+ * Every node consumes one key byte. Within a node, the routes ending in
+ * that byte are expanded over the 256 slots, and the expansion is stored
+ * compressed. A 256 bit map marks the slots where the best route changes,
+ * and the distinct routes are kept in a dense array indexed by the
+ * popcount of the map. Children are stored the same way, behind a 256 bit
+ * map of the slots that have one. A lookup is one popcount per key byte
+ * and never backtracks. It remembers the last route seen on its way down.
+ *
+ * Routes are kept on the node they end in, not pushed down to the leaves,
+ * so an add or withdraw only rebuilds the arrays of that node. IPv4 keys
+ * are at most 4 nodes deep and IPv6 keys at most 16.
+ */
+class LpmMatchEngine {
+ public:
+  LpmMatchEngine(const size_t &key_size);
+
+  /**
+   * @brief Add a route
+   *
+   * @param[in] handle Caller assigned handle of the route. Must not be in
+   * use
+   * @param[in] prefix Packed key bytes. Bits past prefix_len are ignored
+   * @param[in] prefix_len Prefix length in bits, from the most significant
+   * bit of the first byte
+   *
+   * @return TDI_ALREADY_EXISTS if the same prefix is present
+   */
+  tdi_status_t insert(const uint32_t &handle,
+                      const uint8_t *prefix,
+                      const size_t &prefix_len);
+
+  /**
+   * @brief Withdraw a route
+   *
+   * @return TDI_OBJECT_NOT_FOUND if no route has the handle
+   */
+  tdi_status_t erase(const uint32_t &handle);
+
+  /**
+   * @brief Find the longest prefix matching a key
+   *
+   * @return TDI_OBJECT_NOT_FOUND if no route matches
+   */
+  tdi_status_t lookup(const uint8_t *key, uint32_t *handle) const;
+
+  void clear();
+
+  size_t sizeGet() const { return size_; };
+  size_t nodeCountGet() const { return nodes_.size() - free_nodes_.size(); };
+
+ private:
+  static const uint32_t kNone = 0xffffffff;
+
+  // A route ending in a node. It covers the slots whose top len bits are
+  // equal to bits
+  struct LocalRoute {
+    uint8_t bits;
+    uint8_t len;
+    uint32_t handle;
+  };
+
+  struct Node {
+    uint64_t child_bits[4];
+    uint64_t leaf_bits[4];
+    std::vector<uint32_t> children;
+    std::vector<uint32_t> leaves;
+    std::vector<LocalRoute> routes;
+    uint32_t parent;
+    uint8_t parent_slot;
+  };
+
+  struct Route {
+    uint32_t node{kNone};
+    uint8_t bits{0};
+    uint8_t len{0};
+  };
+
+  // Number of bits set in bits[0..slot]
+  static uint32_t rank(const uint64_t *bits, const uint8_t &slot);
+  static bool bitGet(const uint64_t *bits, const uint8_t &slot) {
+    return (bits[slot >> 6] >> (slot & 63)) & 1;
+  };
+
+  uint32_t nodeAllocate(const uint32_t &parent, const uint8_t &parent_slot);
+  void nodeLeavesBuild(Node *node);
+  void nodeRelease(uint32_t node_id);
+
+  const size_t key_size_;
+  size_t size_{0};
+  std::vector<Node> nodes_;
+  std::vector<uint32_t> free_nodes_;
+  std::vector<Route> routes_;
+};
+
+}  // namespace dummy
+}  // namespace tna
+}  // namespace tdi
+
+#endif  // _TDI_DUMMY_LPM_MATCH_ENGINE_HPP
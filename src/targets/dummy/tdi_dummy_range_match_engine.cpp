@@ -0,0 +1,276 @@
+/*
+ * Copyright(c) 2021 Intel Corporation.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this software except as stipulated in the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <cstring>
+#include <initializer_list>
+
+#include "tdi_dummy_range_match_engine.hpp"
+
+namespace tdi {
+namespace tna {
+namespace dummy {
+
+const uint32_t RangeMatchEngine::kNone;
+
+RangeMatchEngine::RangeMatchEngine(const size_t &key_size,
+                                   const std::vector<RangeField> &ranges)
+    : key_size_(key_size), ranges_(ranges) {}
+
+int RangeMatchEngine::primaryCompare(const uint8_t *a,
+                                     const uint8_t *b) const {
+  const auto &primary = ranges_.front();
+  return std::memcmp(a + primary.offset, b + primary.offset, primary.size);
+}
+
+bool RangeMatchEngine::nodeLess(const uint32_t &a, const uint32_t &b) const {
+  const int cmp = primaryCompare(lowGet(a), lowGet(b));
+  return cmp ? cmp < 0 : a < b;
+}
+
+bool RangeMatchEngine::ruleMatch(const uint32_t &handle,
+                                 const uint8_t *key) const {
+  const uint8_t *value = values_.data() + handle * key_size_;
+  const uint8_t *mask = maskGet(handle);
+  for (size_t i = 0; i < key_size_; i++) {
+    if ((key[i] & mask[i]) != value[i]) return false;
+  }
+  const uint8_t *low = lowGet(handle);
+  const uint8_t *high = highGet(handle);
+  for (const auto &range : ranges_) {
+    if (std::memcmp(key + range.offset, low + range.offset, range.size) < 0 ||
+        std::memcmp(key + range.offset, high + range.offset, range.size) >
+            0) {
+      return false;
+    }
+  }
+  return true;
+}
+
+bool RangeMatchEngine::ruleOverlap(const uint32_t &handle,
+                                   const uint8_t *value,
+                                   const uint8_t *mask,
+                                   const uint8_t *high) const {
+  const uint8_t *rule_value = values_.data() + handle * key_size_;
+  const uint8_t *rule_mask = maskGet(handle);
+  // Range bytes are clear in the rule mask, so the query bounds drop out
+  for (size_t i = 0; i < key_size_; i++) {
+    if ((rule_value[i] ^ value[i]) & rule_mask[i] & mask[i]) return false;
+  }
+  const uint8_t *rule_low = lowGet(handle);
+  const uint8_t *rule_high = highGet(handle);
+  for (const auto &range : ranges_) {
+    if (std::memcmp(rule_low + range.offset, high + range.offset, range.size) >
+            0 ||
+        std::memcmp(value + range.offset, rule_high + range.offset, range.size) >
+            0) {
+      return false;
+    }
+  }
+  return true;
+}
+
+tdi_status_t RangeMatchEngine::insert(const uint32_t &handle,
+                                      const uint8_t *value,
+                                      const uint8_t *mask,
+                                      const uint8_t *high,
+                                      const uint32_t &priority) {
+  if (handle < nodes_.size() && nodes_[handle].in_use) {
+    return TDI_ALREADY_EXISTS;
+  }
+  for (const auto &range : ranges_) {
+    if (std::memcmp(value + range.offset, high + range.offset, range.size) >
+        0) {
+      return TDI_INVALID_ARG;
+    }
+  }
+  if (handle >= nodes_.size()) {
+    nodes_.resize(handle + 1);
+    values_.resize(nodes_.size() * key_size_);
+    masks_.resize(nodes_.size() * key_size_);
+    lows_.resize(nodes_.size() * key_size_);
+    highs_.resize(nodes_.size() * key_size_);
+  }
+  uint8_t *rule_value = values_.data() + handle * key_size_;
+  uint8_t *rule_mask = masks_.data() + handle * key_size_;
+  std::memcpy(rule_mask, mask, key_size_);
+  for (const auto &range : ranges_) {
+    std::memset(rule_mask + range.offset, 0, range.size);
+  }
+  for (size_t i = 0; i < key_size_; i++) {
+    rule_value[i] = value[i] & rule_mask[i];
+  }
+  std::memcpy(lows_.data() + handle * key_size_, value, key_size_);
+  std::memcpy(highs_.data() + handle * key_size_, high, key_size_);
+
+  // xorshift32, for the heap order of the treap
+  seed_ ^= seed_ << 13;
+  seed_ ^= seed_ >> 17;
+  seed_ ^= seed_ << 5;
+  auto &node = nodes_[handle];
+  node = Node();
+  node.in_use = true;
+  node.priority = priority;
+  node.heap = seed_;
+  node.max_high = handle;
+  node.best = handle;
+
+  uint32_t left, right;
+  split(root_, handle, &left, &right);
+  root_ = merge(merge(left, handle), right);
+  size_++;
+  return TDI_SUCCESS;
+}
+
+tdi_status_t RangeMatchEngine::erase(const uint32_t &handle) {
+  if (handle >= nodes_.size() || !nodes_[handle].in_use) {
+    return TDI_OBJECT_NOT_FOUND;
+  }
+  root_ = eraseFrom(root_, handle);
+  nodes_[handle] = Node();
+  size_--;
+  return TDI_SUCCESS;
+}
+
+void RangeMatchEngine::nodeUpdate(const uint32_t &node_id) {
+  auto &node = nodes_[node_id];
+  node.max_high = node_id;
+  node.best = node_id;
+  for (const auto &child_id : {node.left, node.right}) {
+    if (child_id == kNone) continue;
+    const auto &child = nodes_[child_id];
+    if (primaryCompare(highGet(child.max_high), highGet(node.max_high)) > 0) {
+      node.max_high = child.max_high;
+    }
+    if (ruleBetter(child.best, node.best)) {
+      node.best = child.best;
+    }
+  }
+}
+
+void RangeMatchEngine::split(const uint32_t node_id,
+                             const uint32_t &handle,
+                             uint32_t *left,
+                             uint32_t *right) {
+  if (node_id == kNone) {
+    *left = kNone;
+    *right = kNone;
+    return;
+  }
+  if (nodeLess(node_id, handle)) {
+    split(nodes_[node_id].right, handle, &nodes_[node_id].right, right);
+    *left = node_id;
+  } else {
+    split(nodes_[node_id].left, handle, left, &nodes_[node_id].left);
+    *right = node_id;
+  }
+  nodeUpdate(node_id);
+}
+
+uint32_t RangeMatchEngine::merge(const uint32_t left, const uint32_t right) {
+  if (left == kNone) return right;
+  if (right == kNone) return left;
+  if (nodes_[left].heap > nodes_[right].heap) {
+    nodes_[left].right = merge(nodes_[left].right, right);
+    nodeUpdate(left);
+    return left;
+  }
+  nodes_[right].left = merge(left, nodes_[right].left);
+  nodeUpdate(right);
+  return right;
+}
+
+uint32_t RangeMatchEngine::eraseFrom(const uint32_t node_id,
+                                     const uint32_t &handle) {
+  auto &node = nodes_[node_id];
+  if (node_id == handle) {
+    return merge(node.left, node.right);
+  }
+  if (nodeLess(handle, node_id)) {
+    node.left = eraseFrom(node.left, handle);
+  } else {
+    node.right = eraseFrom(node.right, handle);
+  }
+  nodeUpdate(node_id);
+  return node_id;
+}
+
+void RangeMatchEngine::lookupFrom(const uint32_t &node_id,
+                                  const uint8_t *key,
+                                  bool *found,
+                                  uint32_t *best) const {
+  if (node_id == kNone) return;
+  const auto &node = nodes_[node_id];
+  // Every interval below ends before the key
+  if (primaryCompare(key, highGet(node.max_high)) > 0) return;
+  // Nothing below can beat the rule already found
+  if (*found && !ruleBetter(node.best, *best)) return;
+  lookupFrom(node.left, key, found, best);
+  // This node and everything to its right start after the key
+  if (primaryCompare(key, lowGet(node_id)) < 0) return;
+  if (ruleMatch(node_id, key) && (!*found || ruleBetter(node_id, *best))) {
+    *best = node_id;
+    *found = true;
+  }
+  lookupFrom(node.right, key, found, best);
+}
+
+tdi_status_t RangeMatchEngine::lookup(const uint8_t *key,
+                                      uint32_t *handle) const {
+  bool found = false;
+  uint32_t best = kNone;
+  lookupFrom(root_, key, &found, &best);
+  if (!found) return TDI_OBJECT_NOT_FOUND;
+  *handle = best;
+  return TDI_SUCCESS;
+}
+
+void RangeMatchEngine::overlapFrom(const uint32_t &node_id,
+                                   const uint8_t *value,
+                                   const uint8_t *mask,
+                                   const uint8_t *high,
+                                   std::vector<uint32_t> *handles) const {
+  if (node_id == kNone) return;
+  const auto &node = nodes_[node_id];
+  if (primaryCompare(value, highGet(node.max_high)) > 0) return;
+  overlapFrom(node.left, value, mask, high, handles);
+  if (primaryCompare(high, lowGet(node_id)) < 0) return;
+  if (ruleOverlap(node_id, value, mask, high)) {
+    handles->push_back(node_id);
+  }
+  overlapFrom(node.right, value, mask, high, handles);
+}
+
+void RangeMatchEngine::overlapGet(const uint8_t *value,
+                                  const uint8_t *mask,
+                                  const uint8_t *high,
+                                  std::vector<uint32_t> *handles) const {
+  handles->clear();
+  overlapFrom(root_, value, mask, high, handles);
+}
+
+void RangeMatchEngine::clear() {
+  size_ = 0;
+  root_ = kNone;
+  nodes_.clear();
+  values_.clear();
+  masks_.clear();
+  lows_.clear();
+  highs_.clear();
+}
+
+}  // namespace dummy
+}  // namespace tna
+}  // namespace tdi
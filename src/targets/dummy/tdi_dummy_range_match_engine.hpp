@@ -0,0 +1,188 @@
+/*
+ * Copyright(c) 2021 Intel Corporation.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this software except as stipulated in the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+/** @file tdi_dummy_range_match_engine.hpp
+ *
+ *  @brief Contains the software range classifier used by dummy tables
+ */
+#ifndef _TDI_DUMMY_RANGE_MATCH_ENGINE_HPP
+#define _TDI_DUMMY_RANGE_MATCH_ENGINE_HPP
+
+#include <cstdint>
+#include <vector>
+
+#include <tdi/common/tdi_defs.h>
+
+namespace tdi {
+namespace tna {
+namespace dummy {
+
+/**
+ * @brief Bytes of a range field in the packed key
+ */
+struct RangeField {
+  size_t offset;
+  size_t size;
+};
+
+/**
+ * @brief Augmented interval tree over packed key bytes, for rules with one
+ * or more range fields.
+ *
+ * Rules are ordered by the low bound of the first range field in a treap.
+ * Every node also records the rule with the highest high bound and the rule
+ * with the best priority in its subtree. A lookup skips subtrees whose
+ * intervals all end below the key, subtrees whose intervals all start above
+ * it, and subtrees that cannot beat the rule already found. The other range
+ * fields and the masked fields are checked on the rules the walk reaches.
+ *
+ * Bounds are compared as unsigned big endian byte strings, which is how
+ * the fields are packed. Lower priority values win and rules of equal
+ * priority are resolved by the lowest handle.
+ */
+class RangeMatchEngine {
+ public:
+  RangeMatchEngine(const size_t &key_size,
+                   const std::vector<RangeField> &ranges);
+
+  /**
+   * @brief Add a rule
+   *
+   * @param[in] handle Caller assigned handle of the rule. Must not be in use
+   * @param[in] value Packed key value. Holds the low bounds of range fields
+   * @param[in] mask Packed mask of the other fields. Ignored over range
+   * fields
+   * @param[in] high Packed high bounds. Only read over range fields
+   * @param[in] priority Priority of the rule, lower wins
+   *
+   * @return TDI_INVALID_ARG if a low bound is above its high bound
+   */
+  tdi_status_t insert(const uint32_t &handle,
+                      const uint8_t *value,
+                      const uint8_t *mask,
+                      const uint8_t *high,
+                      const uint32_t &priority);
+
+  /**
+   * @brief Remove a rule
+   *
+   * @return TDI_OBJECT_NOT_FOUND if no rule has the handle
+   */
+  tdi_status_t erase(const uint32_t &handle);
+
+  /**
+   * @brief Find the best rule matching a key
+   *
+   * @return TDI_OBJECT_NOT_FOUND if no rule matches
+   */
+  tdi_status_t lookup(const uint8_t *key, uint32_t *handle) const;
+
+  /**
+   * @brief Find every rule that overlaps a query rule, that is every rule
+   * matching at least one key the query rule matches
+   *
+   * @param[in] value Packed value and low bounds of the query
+   * @param[in] mask Packed mask of the query
+   * @param[in] high Packed high bounds of the query
+   * @param[out] handles Handles of the overlapping rules, in no given order
+   */
+  void overlapGet(const uint8_t *value,
+                  const uint8_t *mask,
+                  const uint8_t *high,
+                  std::vector<uint32_t> *handles) const;
+
+  void clear();
+
+  size_t sizeGet() const { return size_; };
+
+ private:
+  static const uint32_t kNone = 0xffffffff;
+
+  struct Node {
+    bool in_use{false};
+    uint32_t priority{0};
+    uint32_t heap{0};
+    uint32_t left{kNone};
+    uint32_t right{kNone};
+    // Rule of the subtree with the highest high bound
+    uint32_t max_high{kNone};
+    // Rule of the subtree with the best priority
+    uint32_t best{kNone};
+  };
+
+  const uint8_t *lowGet(const uint32_t &handle) const {
+    return lows_.data() + handle * key_size_;
+  };
+  const uint8_t *highGet(const uint32_t &handle) const {
+    return highs_.data() + handle * key_size_;
+  };
+  const uint8_t *maskGet(const uint32_t &handle) const {
+    return masks_.data() + handle * key_size_;
+  };
+  // Compare the primary range field of two packed byte strings
+  int primaryCompare(const uint8_t *a, const uint8_t *b) const;
+  bool nodeLess(const uint32_t &a, const uint32_t &b) const;
+  bool ruleBetter(const uint32_t &a, const uint32_t &b) const {
+    return nodes_[a].priority != nodes_[b].priority
+               ? nodes_[a].priority < nodes_[b].priority
+               : a < b;
+  };
+  bool ruleMatch(const uint32_t &handle, const uint8_t *key) const;
+  bool ruleOverlap(const uint32_t &handle,
+                   const uint8_t *value,
+                   const uint8_t *mask,
+                   const uint8_t *high) const;
+
+  void nodeUpdate(const uint32_t &node_id);
+  // Treap primitives. Node IDs are taken by value, callers pass child links
+  // that the recursion rewrites. split() separates the nodes ordered before
+  // handle from the others
+  void split(const uint32_t node_id,
+             const uint32_t &handle,
+             uint32_t *left,
+             uint32_t *right);
+  uint32_t merge(const uint32_t left, const uint32_t right);
+  uint32_t eraseFrom(const uint32_t node_id, const uint32_t &handle);
+
+  void lookupFrom(const uint32_t &node_id,
+                  const uint8_t *key,
+                  bool *found,
+                  uint32_t *best) const;
+  void overlapFrom(const uint32_t &node_id,
+                   const uint8_t *value,
+                   const uint8_t *mask,
+                   const uint8_t *high,
+                   std::vector<uint32_t> *handles) const;
+
+  const size_t key_size_;
+  const std::vector<RangeField> ranges_;
+  size_t size_{0};
+  uint32_t root_{kNone};
+  uint32_t seed_{0x9e3779b9};
+  // Indexed by handle. The node of a rule is its handle
+  std::vector<Node> nodes_;
+  // Packed rule bytes, key_size_ per handle. Values are kept masked, with
+  // the range fields clear
+  std::vector<uint8_t> values_;
+  std::vector<uint8_t> masks_;
+  std::vector<uint8_t> lows_;
+  std::vector<uint8_t> highs_;
+};
+
+}  // namespace dummy
+}  // namespace tna
+}  // namespace tdi
+
+#endif  // _TDI_DUMMY_RANGE_MATCH_ENGINE_HPP
@@ -0,0 +1,960 @@
+/*
+ * Copyright(c) 2021 Intel Corporation.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this software except as stipulated in the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <cstring>
+
+#include <tdi/common/tdi_utils.hpp>
+
+#include "tdi_dummy_table.hpp"
+
+namespace tdi {
+namespace tna {
+namespace dummy {
+
+tdi_status_t MatchActionDirect::keyCheck(const tdi::TableKey &key,
+                                         const TableKey **dummy_key) const {
+  const tdi::Table *key_table;
+  key.tableGet(&key_table);
+  if (key_table != this) {
+    LOG_ERROR("%s:%d %s Key object was not allocated by this table",
+              __func__,
+              __LINE__,
+              tableInfoGet()->nameGet().c_str());
+    return TDI_INVALID_ARG;
+  }
+  *dummy_key = static_cast<const TableKey *>(&key);
+  return TDI_SUCCESS;
+}
+
+tdi_status_t MatchActionDirect::dataCheck(const tdi::TableData &data,
+                                          const TableData **dummy_data) const {
+  const tdi::Table *data_table;
+  data.getParent(&data_table);
+  if (data_table != this) {
+    LOG_ERROR("%s:%d %s Data object was not allocated by this table",
+              __func__,
+              __LINE__,
+              tableInfoGet()->nameGet().c_str());
+    return TDI_INVALID_ARG;
+  }
+  const auto &action_id = data.actionIdGet();
+  if (action_id && tableInfoGet()->actionGet(action_id) == nullptr) {
+    return TDI_INVALID_ARG;
+  }
+  *dummy_data = static_cast<const TableData *>(&data);
+  return TDI_SUCCESS;
+}
+
+void MatchActionDirect::matchEngineCreate() {
+  if (key_layout_.exactOnlyGet()) return;
+  size_t num_lpm = 0;
+  size_t exact_bytes = 0;
+  std::vector<RangeField> ranges;
+  for (const auto &field : key_layout_.fieldsGet()) {
+    switch (static_cast<int>(field.match_type)) {
+      case TDI_MATCH_TYPE_EXACT:
+        exact_bytes += field.size_bytes;
+        break;
+      case TDI_MATCH_TYPE_LPM:
+        lpm_field_ = &field;
+        num_lpm++;
+        break;
+      case TDI_MATCH_TYPE_TERNARY:
+        break;
+      case TDI_MATCH_TYPE_RANGE:
+        ranges.push_back({field.offset, field.size_bytes});
+        break;
+      default:
+        return;
+    }
+  }
+  if (!ranges.empty()) {
+    lpm_field_ = nullptr;
+    // A table sharing the state of its previous version has the engine
+    if (!range_engine_) {
+      range_engine_.reset(
+          new RangeMatchEngine(key_layout_.sizeGet(), ranges));
+    }
+    return;
+  }
+  if (num_lpm == 1 && !key_layout_.priorityFieldGet() &&
+      exact_bytes + lpm_field_->size_bytes == key_layout_.sizeGet()) {
+    lpm_prefix_base_ = exact_bytes * 8 + lpm_field_->size_bytes * 8 -
+                       lpm_field_->size_bits;
+    if (!lpm_engine_) {
+      lpm_engine_.reset(new LpmMatchEngine(key_layout_.sizeGet()));
+    }
+    return;
+  }
+  lpm_field_ = nullptr;
+  if (!ternary_engine_) {
+    ternary_engine_.reset(new TernaryMatchEngine(key_layout_.sizeGet()));
+  }
+}
+
+void MatchActionDirect::lpmKeyBuild(const uint8_t *value,
+                                    std::vector<uint8_t> *lpm_key) const {
+  lpm_key->resize(key_layout_.sizeGet());
+  uint8_t *out = lpm_key->data();
+  for (const auto &field : key_layout_.fieldsGet()) {
+    if (&field == lpm_field_) continue;
+    std::memcpy(out, value + field.offset, field.size_bytes);
+    out += field.size_bytes;
+  }
+  std::memcpy(out, value + lpm_field_->offset, lpm_field_->size_bytes);
+}
+
+void MatchActionDirect::matchMaskBuild(const TableKey &key,
+                                       std::vector<uint8_t> *mask) const {
+  // The priority field orders the rules but takes no part in the match
+  const auto &match_mask = key_layout_.matchMaskGet();
+  mask->assign(key.maskGet(), key.maskGet() + match_mask.size());
+  for (size_t i = 0; i < mask->size(); i++) {
+    (*mask)[i] &= match_mask[i];
+  }
+}
+
+tdi_status_t MatchActionDirect::engineCheck() const {
+  if (!key_layout_.exactOnlyGet() && !ternary_engine_ && !lpm_engine_ &&
+      !range_engine_) {
+    LOG_ERROR("%s:%d %s No match engine for the key match types of the table",
+              __func__,
+              __LINE__,
+              tableInfoGet()->nameGet().c_str());
+    return TDI_NOT_SUPPORTED;
+  }
+  return TDI_SUCCESS;
+}
+
+void MatchActionDirect::entryDataCopy(const EntryState &entry,
+                                      tdi::TableData *data) const {
+  auto dummy_data = static_cast<TableData *>(data);
+  if (dummy_data->actionIdGet() != entry.action_id) {
+    dummy_data->actionIdSet(entry.action_id);
+  }
+  if (dummy_data->allFieldsSetGet()) {
+    dummy_data->fieldValuesSet(entry.field_values);
+    return;
+  }
+  FieldValueMap field_values;
+  for (const auto &kv : entry.field_values) {
+    bool is_active = false;
+    dummy_data->isActive(kv.first, &is_active);
+    if (is_active) field_values.insert(kv);
+  }
+  dummy_data->fieldValuesSet(field_values);
+}
+
+tdi_status_t MatchActionDirect::entryRead(const uint32_t &handle,
+                                          tdi::TableKey *key,
+                                          tdi::TableData *data) const {
+  if (key) {
+    static_cast<TableKey *>(key)->identitySet(entry_index_.keyGet(handle));
+  }
+  if (data) {
+    entryDataCopy(entries_[handle], data);
+  }
+  return TDI_SUCCESS;
+}
+
+tdi_status_t MatchActionDirect::entryAdd(const tdi::Session & /*session*/,
+                                         const tdi::Target & /*dev_tgt*/,
+                                         const tdi::Flags & /*flags*/,
+                                         const tdi::TableKey &key,
+                                         const tdi::TableData &data) const {
+  const TableKey *dummy_key;
+  const TableData *dummy_data;
+  auto status = keyCheck(key, &dummy_key);
+  if (status != TDI_SUCCESS) return status;
+  status = dataCheck(data, &dummy_data);
+  if (status != TDI_SUCCESS) return status;
+  status = engineCheck();
+  if (status != TDI_SUCCESS) return status;
+
+  std::lock_guard<std::mutex> lock(state_lock_);
+  return entryAddLocked(*dummy_key, *dummy_data);
+}
+
+tdi_status_t MatchActionDirect::entryAddLocked(
+    const TableKey &dummy_key, const TableData &dummy_data) const {
+  const size_t &table_size = tableInfoGet()->sizeGet();
+  if (table_size && entry_index_.sizeGet() >= table_size) {
+    LOG_ERROR("%s:%d %s Table full, %zu entries",
+              __func__,
+              __LINE__,
+              tableInfoGet()->nameGet().c_str(),
+              table_size);
+    return TDI_NO_SPACE;
+  }
+  uint32_t handle;
+  auto status = entry_index_.insert(dummy_key.identityGet(), &handle);
+  if (status != TDI_SUCCESS) {
+    LOG_ERROR("%s:%d %s Entry already exists",
+              __func__,
+              __LINE__,
+              tableInfoGet()->nameGet().c_str());
+    return status;
+  }
+  if (lpm_engine_) {
+    std::vector<uint8_t> lpm_key;
+    lpmKeyBuild(dummy_key.valueGet(), &lpm_key);
+    size_t prefix_len = lpm_prefix_base_;
+    const uint8_t *mask = dummy_key.maskGet() + lpm_field_->offset;
+    for (size_t i = 0; i < lpm_field_->size_bytes; i++) {
+      prefix_len += __builtin_popcount(mask[i]);
+    }
+    status = lpm_engine_->insert(handle, lpm_key.data(), prefix_len);
+  }
+  if (status == TDI_SUCCESS && ternary_engine_) {
+    std::vector<uint8_t> mask;
+    matchMaskBuild(dummy_key, &mask);
+    status = ternary_engine_->insert(
+        handle, dummy_key.valueGet(), mask.data(), dummy_key.priorityGet());
+  }
+  if (status == TDI_SUCCESS && range_engine_) {
+    std::vector<uint8_t> mask;
+    matchMaskBuild(dummy_key, &mask);
+    status = range_engine_->insert(handle,
+                                   dummy_key.valueGet(),
+                                   mask.data(),
+                                   dummy_key.maskGet(),
+                                   dummy_key.priorityGet());
+  }
+  if (status != TDI_SUCCESS) {
+    LOG_ERROR("%s:%d %s Failed to add the entry to the match engine",
+              __func__,
+              __LINE__,
+              tableInfoGet()->nameGet().c_str());
+    // Keep the index and the engines in sync. A table has at most one
+    // match engine, so there is nothing else to undo
+    uint32_t erased_handle;
+    entry_index_.erase(dummy_key.identityGet(), &erased_handle);
+    return status;
+  }
+  if (handle >= entries_.size()) {
+    entries_.resize(handle + 1);
+  }
+  auto &entry = entries_[handle];
+  entry.action_id = dummy_data.actionIdGet();
+  entry.field_values = dummy_data.fieldValuesGet();
+  return TDI_SUCCESS;
+}
+
+tdi_status_t MatchActionDirect::entryMod(const tdi::Session & /*session*/,
+                                         const tdi::Target & /*dev_tgt*/,
+                                         const tdi::Flags & /*flags*/,
+                                         const tdi::TableKey &key,
+                                         const tdi::TableData &data) const {
+  const TableKey *dummy_key;
+  const TableData *dummy_data;
+  auto status = keyCheck(key, &dummy_key);
+  if (status != TDI_SUCCESS) return status;
+  status = dataCheck(data, &dummy_data);
+  if (status != TDI_SUCCESS) return status;
+  status = engineCheck();
+  if (status != TDI_SUCCESS) return status;
+
+  std::lock_guard<std::mutex> lock(state_lock_);
+  return entryModLocked(*dummy_key, *dummy_data);
+}
+
+tdi_status_t MatchActionDirect::entryModLocked(
+    const TableKey &dummy_key, const TableData &dummy_data) const {
+  uint32_t handle;
+  auto status = entry_index_.find(dummy_key.identityGet(), &handle);
+  if (status != TDI_SUCCESS) {
+    LOG_TRACE("%s:%d %s Entry not found",
+              __func__,
+              __LINE__,
+              tableInfoGet()->nameGet().c_str());
+    return status;
+  }
+  auto &entry = entries_[handle];
+  if (entry.action_id != dummy_data.actionIdGet()) {
+    // A new action replaces all the action data of the entry
+    entry.action_id = dummy_data.actionIdGet();
+    entry.field_values = dummy_data.fieldValuesGet();
+    return TDI_SUCCESS;
+  }
+  for (const auto &kv : dummy_data.fieldValuesGet()) {
+    entry.field_values[kv.first] = kv.second;
+  }
+  return TDI_SUCCESS;
+}
+
+tdi_status_t MatchActionDirect::entryDel(const tdi::Session & /*session*/,
+                                         const tdi::Target & /*dev_tgt*/,
+                                         const tdi::Flags & /*flags*/,
+                                         const tdi::TableKey &key) const {
+  const TableKey *dummy_key;
+  auto status = keyCheck(key, &dummy_key);
+  if (status != TDI_SUCCESS) return status;
+  status = engineCheck();
+  if (status != TDI_SUCCESS) return status;
+
+  std::lock_guard<std::mutex> lock(state_lock_);
+  return entryDelLocked(*dummy_key);
+}
+
+tdi_status_t MatchActionDirect::entryDelLocked(
+    const TableKey &dummy_key) const {
+  uint32_t handle;
+  auto status = entry_index_.erase(dummy_key.identityGet(), &handle);
+  if (status != TDI_SUCCESS) {
+    LOG_TRACE("%s:%d %s Entry not found",
+              __func__,
+              __LINE__,
+              tableInfoGet()->nameGet().c_str());
+    return status;
+  }
+  if (lpm_engine_) {
+    lpm_engine_->erase(handle);
+  }
+  if (ternary_engine_) {
+    ternary_engine_->erase(handle);
+  }
+  if (range_engine_) {
+    range_engine_->erase(handle);
+  }
+  entries_[handle] = EntryState();
+  return TDI_SUCCESS;
+}
+
+tdi_status_t MatchActionDirect::entryAddBatch(
+    const tdi::Session & /*session*/,
+    const tdi::Target & /*dev_tgt*/,
+    const tdi::Flags & /*flags*/,
+    const std::vector<const tdi::TableKey *> &keys,
+    const std::vector<const tdi::TableData *> &datas,
+    std::vector<tdi_status_t> *statuses) const {
+  if (statuses == nullptr || keys.size() != datas.size()) {
+    LOG_ERROR("%s:%d %s Invalid args, %zu keys and %zu data",
+              __func__,
+              __LINE__,
+              tableInfoGet()->nameGet().c_str(),
+              keys.size(),
+              datas.size());
+    return TDI_INVALID_ARG;
+  }
+  auto status = engineCheck();
+  if (status != TDI_SUCCESS) return status;
+
+  statuses->assign(keys.size(), TDI_SUCCESS);
+  std::lock_guard<std::mutex> lock(state_lock_);
+  // Size the index and the entry state once for the whole batch
+  entry_index_.reserve(entry_index_.sizeGet() + keys.size());
+  entries_.reserve(entry_index_.sizeGet() + keys.size());
+  for (size_t i = 0; i < keys.size(); i++) {
+    auto &entry_status = (*statuses)[i];
+    const TableKey *dummy_key;
+    const TableData *dummy_data;
+    if (keys[i] == nullptr || datas[i] == nullptr) {
+      entry_status = TDI_INVALID_ARG;
+    } else {
+      entry_status = keyCheck(*keys[i], &dummy_key);
+      if (entry_status == TDI_SUCCESS) {
+        entry_status = dataCheck(*datas[i], &dummy_data);
+      }
+      if (entry_status == TDI_SUCCESS) {
+        entry_status = entryAddLocked(*dummy_key, *dummy_data);
+      }
+    }
+    if (status == TDI_SUCCESS) status = entry_status;
+  }
+  return status;
+}
+
+tdi_status_t MatchActionDirect::entryModBatch(
+    const tdi::Session & /*session*/,
+    const tdi::Target & /*dev_tgt*/,
+    const tdi::Flags & /*flags*/,
+    const std::vector<const tdi::TableKey *> &keys,
+    const std::vector<const tdi::TableData *> &datas,
+    std::vector<tdi_status_t> *statuses) const {
+  if (statuses == nullptr || keys.size() != datas.size()) {
+    LOG_ERROR("%s:%d %s Invalid args, %zu keys and %zu data",
+              __func__,
+              __LINE__,
+              tableInfoGet()->nameGet().c_str(),
+              keys.size(),
+              datas.size());
+    return TDI_INVALID_ARG;
+  }
+  auto status = engineCheck();
+  if (status != TDI_SUCCESS) return status;
+
+  statuses->assign(keys.size(), TDI_SUCCESS);
+  std::lock_guard<std::mutex> lock(state_lock_);
+  for (size_t i = 0; i < keys.size(); i++) {
+    auto &entry_status = (*statuses)[i];
+    const TableKey *dummy_key;
+    const TableData *dummy_data;
+    if (keys[i] == nullptr || datas[i] == nullptr) {
+      entry_status = TDI_INVALID_ARG;
+    } else {
+      entry_status = keyCheck(*keys[i], &dummy_key);
+      if (entry_status == TDI_SUCCESS) {
+        entry_status = dataCheck(*datas[i], &dummy_data);
+      }
+      if (entry_status == TDI_SUCCESS) {
+        entry_status = entryModLocked(*dummy_key, *dummy_data);
+      }
+    }
+    if (status == TDI_SUCCESS) status = entry_status;
+  }
+  return status;
+}
+
+tdi_status_t MatchActionDirect::entryDelBatch(
+    const tdi::Session & /*session*/,
+    const tdi::Target & /*dev_tgt*/,
+    const tdi::Flags & /*flags*/,
+    const std::vector<const tdi::TableKey *> &keys,
+    std::vector<tdi_status_t> *statuses) const {
+  if (statuses == nullptr) {
+    LOG_ERROR("%s:%d Outparam passed is nullptr", __func__, __LINE__);
+    return TDI_INVALID_ARG;
+  }
+  auto status = engineCheck();
+  if (status != TDI_SUCCESS) return status;
+
+  statuses->assign(keys.size(), TDI_SUCCESS);
+  std::lock_guard<std::mutex> lock(state_lock_);
+  for (size_t i = 0; i < keys.size(); i++) {
+    auto &entry_status = (*statuses)[i];
+    const TableKey *dummy_key;
+    if (keys[i] == nullptr) {
+      entry_status = TDI_INVALID_ARG;
+    } else {
+      entry_status = keyCheck(*keys[i], &dummy_key);
+      if (entry_status == TDI_SUCCESS) {
+        entry_status = entryDelLocked(*dummy_key);
+      }
+    }
+    if (status == TDI_SUCCESS) status = entry_status;
+  }
+  return status;
+}
+
+tdi_status_t MatchActionDirect::clear(const tdi::Session & /*session*/,
+                                      const tdi::Target & /*dev_tgt*/,
+                                      const tdi::Flags & /*flags*/) const {
+  std::lock_guard<std::mutex> lock(state_lock_);
+  entry_index_.clear();
+  if (lpm_engine_) {
+    lpm_engine_->clear();
+  }
+  if (ternary_engine_) {
+    ternary_engine_->clear();
+  }
+  if (range_engine_) {
+    range_engine_->clear();
+  }
+  entries_.clear();
+  return TDI_SUCCESS;
+}
+
+tdi_status_t MatchActionDirect::entryGet(const tdi::Session & /*session*/,
+                                         const tdi::Target & /*dev_tgt*/,
+                                         const tdi::Flags & /*flags*/,
+                                         const tdi::TableKey &key,
+                                         tdi::TableData *data) const {
+  const TableKey *dummy_key;
+  const TableData *dummy_data;
+  if (data == nullptr) {
+    LOG_ERROR("%s:%d Outparam passed is nullptr", __func__, __LINE__);
+    return TDI_INVALID_ARG;
+  }
+  auto status = keyCheck(key, &dummy_key);
+  if (status != TDI_SUCCESS) return status;
+  status = dataCheck(*data, &dummy_data);
+  if (status != TDI_SUCCESS) return status;
+  status = engineCheck();
+  if (status != TDI_SUCCESS) return status;
+
+  std::lock_guard<std::mutex> lock(state_lock_);
+  uint32_t handle;
+  status = entry_index_.find(dummy_key->identityGet(), &handle);
+  if (status != TDI_SUCCESS) {
+    LOG_TRACE("%s:%d %s Entry not found",
+              __func__,
+              __LINE__,
+              tableInfoGet()->nameGet().c_str());
+    return status;
+  }
+  return entryRead(handle, nullptr, data);
+}
+
+tdi_status_t MatchActionDirect::entryGetBatch(
+    const tdi::Session & /*session*/,
+    const tdi::Target & /*dev_tgt*/,
+    const tdi::Flags & /*flags*/,
+    const std::vector<const tdi::TableKey *> &keys,
+    const std::vector<tdi::TableData *> &datas,
+    std::vector<tdi_status_t> *statuses) const {
+  if (statuses == nullptr || keys.size() != datas.size()) {
+    LOG_ERROR("%s:%d %s Invalid args, %zu keys and %zu data",
+              __func__,
+              __LINE__,
+              tableInfoGet()->nameGet().c_str(),
+              keys.size(),
+              datas.size());
+    return TDI_INVALID_ARG;
+  }
+  auto status = engineCheck();
+  if (status != TDI_SUCCESS) return status;
+
+  // Probe the index for every valid key at once, then copy out the data
+  statuses->assign(keys.size(), TDI_SUCCESS);
+  std::vector<const uint8_t *> identities;
+  std::vector<size_t> positions;
+  for (size_t i = 0; i < keys.size(); i++) {
+    const TableKey *dummy_key;
+    const TableData *dummy_data;
+    auto &entry_status = (*statuses)[i];
+    if (keys[i] == nullptr || datas[i] == nullptr) {
+      entry_status = TDI_INVALID_ARG;
+      continue;
+    }
+    entry_status = keyCheck(*keys[i], &dummy_key);
+    if (entry_status == TDI_SUCCESS) {
+      entry_status = dataCheck(*datas[i], &dummy_data);
+    }
+    if (entry_status != TDI_SUCCESS) continue;
+    identities.push_back(dummy_key->identityGet());
+    positions.push_back(i);
+  }
+  std::vector<uint32_t> handles(identities.size());
+  std::vector<tdi_status_t> find_statuses(identities.size());
+
+  std::lock_guard<std::mutex> lock(state_lock_);
+  entry_index_.findBatch(identities.data(),
+                         identities.size(),
+                         handles.data(),
+                         find_statuses.data());
+  for (size_t j = 0; j < positions.size(); j++) {
+    const size_t &i = positions[j];
+    (*statuses)[i] = find_statuses[j];
+    if (find_statuses[j] == TDI_SUCCESS) {
+      (*statuses)[i] = entryRead(handles[j], nullptr, datas[i]);
+    }
+  }
+  for (const auto &entry_status : *statuses) {
+    if (entry_status != TDI_SUCCESS) return entry_status;
+  }
+  return TDI_SUCCESS;
+}
+
+tdi_status_t MatchActionDirect::entryGet(const tdi::Session & /*session*/,
+                                         const tdi::Target & /*dev_tgt*/,
+                                         const tdi::Flags & /*flags*/,
+                                         const tdi_handle_t &entry_handle,
+                                         tdi::TableKey *key,
+                                         tdi::TableData *data) const {
+  const TableKey *dummy_key;
+  const TableData *dummy_data;
+  if (key == nullptr || data == nullptr) {
+    LOG_ERROR("%s:%d Outparam passed is nullptr", __func__, __LINE__);
+    return TDI_INVALID_ARG;
+  }
+  auto status = keyCheck(*key, &dummy_key);
+  if (status != TDI_SUCCESS) return status;
+  status = dataCheck(*data, &dummy_data);
+  if (status != TDI_SUCCESS) return status;
+
+  std::lock_guard<std::mutex> lock(state_lock_);
+  if (!entry_index_.handleInUse(entry_handle)) {
+    LOG_TRACE("%s:%d %s Entry handle %u not found",
+              __func__,
+              __LINE__,
+              tableInfoGet()->nameGet().c_str(),
+              entry_handle);
+    return TDI_OBJECT_NOT_FOUND;
+  }
+  return entryRead(entry_handle, key, data);
+}
+
+tdi_status_t MatchActionDirect::entryKeyGet(const tdi::Session & /*session*/,
+                                            const tdi::Target &dev_tgt,
+                                            const tdi::Flags & /*flags*/,
+                                            const tdi_handle_t &entry_handle,
+                                            tdi::Target *entry_tgt,
+                                            tdi::TableKey *key) const {
+  const TableKey *dummy_key;
+  if (key == nullptr) {
+    LOG_ERROR("%s:%d Outparam passed is nullptr", __func__, __LINE__);
+    return TDI_INVALID_ARG;
+  }
+  auto status = keyCheck(*key, &dummy_key);
+  if (status != TDI_SUCCESS) return status;
+
+  std::lock_guard<std::mutex> lock(state_lock_);
+  if (!entry_index_.handleInUse(entry_handle)) {
+    LOG_TRACE("%s:%d %s Entry handle %u not found",
+              __func__,
+              __LINE__,
+              tableInfoGet()->nameGet().c_str(),
+              entry_handle);
+    return TDI_OBJECT_NOT_FOUND;
+  }
+  if (entry_tgt) *entry_tgt = dev_tgt;
+  return entryRead(entry_handle, key, nullptr);
+}
+
+tdi_status_t MatchActionDirect::entryHandleGet(
+    const tdi::Session & /*session*/,
+    const tdi::Target & /*dev_tgt*/,
+    const tdi::Flags & /*flags*/,
+    const tdi::TableKey &key,
+    tdi_handle_t *entry_handle) const {
+  const TableKey *dummy_key;
+  if (entry_handle == nullptr) {
+    LOG_ERROR("%s:%d Outparam passed is nullptr", __func__, __LINE__);
+    return TDI_INVALID_ARG;
+  }
+  auto status = keyCheck(key, &dummy_key);
+  if (status != TDI_SUCCESS) return status;
+  status = engineCheck();
+  if (status != TDI_SUCCESS) return status;
+
+  std::lock_guard<std::mutex> lock(state_lock_);
+  uint32_t handle;
+  status = entry_index_.find(dummy_key->identityGet(), &handle);
+  if (status != TDI_SUCCESS) return status;
+  *entry_handle = handle;
+  return TDI_SUCCESS;
+}
+
+tdi_status_t MatchActionDirect::entryLookup(const tdi::TableKey &key,
+                                            tdi_handle_t *entry_handle) const {
+  const TableKey *dummy_key;
+  if (entry_handle == nullptr) {
+    LOG_ERROR("%s:%d Outparam passed is nullptr", __func__, __LINE__);
+    return TDI_INVALID_ARG;
+  }
+  auto status = keyCheck(key, &dummy_key);
+  if (status != TDI_SUCCESS) return status;
+  status = engineCheck();
+  if (status != TDI_SUCCESS) return status;
+
+  std::lock_guard<std::mutex> lock(state_lock_);
+  uint32_t handle;
+  if (lpm_engine_) {
+    std::vector<uint8_t> lpm_key;
+    lpmKeyBuild(dummy_key->valueGet(), &lpm_key);
+    status = lpm_engine_->lookup(lpm_key.data(), &handle);
+  } else if (ternary_engine_) {
+    status = ternary_engine_->lookup(dummy_key->valueGet(), &handle);
+  } else if (range_engine_) {
+    status = range_engine_->lookup(dummy_key->valueGet(), &handle);
+  } else {
+    status = entry_index_.find(dummy_key->valueGet(), &handle);
+  }
+  if (status != TDI_SUCCESS) return status;
+  *entry_handle = handle;
+  return TDI_SUCCESS;
+}
+
+tdi_status_t MatchActionDirect::entryOverlapGet(
+    const tdi::TableKey &key, std::vector<tdi_handle_t> *entry_handles) const {
+  const TableKey *dummy_key;
+  if (entry_handles == nullptr) {
+    LOG_ERROR("%s:%d Outparam passed is nullptr", __func__, __LINE__);
+    return TDI_INVALID_ARG;
+  }
+  auto status = keyCheck(key, &dummy_key);
+  if (status != TDI_SUCCESS) return status;
+  if (!range_engine_) {
+    LOG_ERROR("%s:%d %s Overlap queries need a range key field",
+              __func__,
+              __LINE__,
+              tableInfoGet()->nameGet().c_str());
+    return TDI_NOT_SUPPORTED;
+  }
+
+  std::vector<uint8_t> mask;
+  matchMaskBuild(*dummy_key, &mask);
+  std::lock_guard<std::mutex> lock(state_lock_);
+  std::vector<uint32_t> handles;
+  range_engine_->overlapGet(
+      dummy_key->valueGet(), mask.data(), dummy_key->maskGet(), &handles);
+  entry_handles->assign(handles.begin(), handles.end());
+  return TDI_SUCCESS;
+}
+
+tdi_status_t MatchActionDirect::entryGetFirst(const tdi::Session & /*session*/,
+                                              const tdi::Target & /*dev_tgt*/,
+                                              const tdi::Flags & /*flags*/,
+                                              tdi::TableKey *key,
+                                              tdi::TableData *data) const {
+  const TableKey *dummy_key;
+  const TableData *dummy_data;
+  if (key == nullptr || data == nullptr) {
+    LOG_ERROR("%s:%d Outparam passed is nullptr", __func__, __LINE__);
+    return TDI_INVALID_ARG;
+  }
+  auto status = keyCheck(*key, &dummy_key);
+  if (status != TDI_SUCCESS) return status;
+  status = dataCheck(*data, &dummy_data);
+  if (status != TDI_SUCCESS) return status;
+
+  std::lock_guard<std::mutex> lock(state_lock_);
+  for (uint32_t handle = 0; handle < entry_index_.handleEnd(); handle++) {
+    if (entry_index_.handleInUse(handle)) {
+      return entryRead(handle, key, data);
+    }
+  }
+  return TDI_OBJECT_NOT_FOUND;
+}
+
+tdi_status_t MatchActionDirect::entryGetNextN(const tdi::Session & /*session*/,
+                                              const tdi::Target & /*dev_tgt*/,
+                                              const tdi::Flags & /*flags*/,
+                                              const tdi::TableKey &key,
+                                              const uint32_t &n,
+                                              keyDataPairs *key_data_pairs,
+                                              uint32_t *num_returned) const {
+  const TableKey *dummy_key;
+  if (key_data_pairs == nullptr || num_returned == nullptr ||
+      key_data_pairs->size() < n) {
+    LOG_ERROR("%s:%d Invalid outparams", __func__, __LINE__);
+    return TDI_INVALID_ARG;
+  }
+  auto status = keyCheck(key, &dummy_key);
+  if (status != TDI_SUCCESS) return status;
+  status = engineCheck();
+  if (status != TDI_SUCCESS) return status;
+
+  std::lock_guard<std::mutex> lock(state_lock_);
+  uint32_t handle;
+  status = entry_index_.find(dummy_key->identityGet(), &handle);
+  if (status != TDI_SUCCESS) {
+    LOG_TRACE("%s:%d %s Entry not found",
+              __func__,
+              __LINE__,
+              tableInfoGet()->nameGet().c_str());
+    return status;
+  }
+  *num_returned = 0;
+  for (handle++; handle < entry_index_.handleEnd() && *num_returned < n;
+       handle++) {
+    if (!entry_index_.handleInUse(handle)) continue;
+    auto &pair = (*key_data_pairs)[*num_returned];
+    const TableKey *pair_key;
+    const TableData *pair_data;
+    if (pair.first == nullptr || pair.second == nullptr ||
+        keyCheck(*pair.first, &pair_key) != TDI_SUCCESS ||
+        dataCheck(*pair.second, &pair_data) != TDI_SUCCESS) {
+      LOG_ERROR("%s:%d %s Invalid key/data pair at %u",
+                __func__,
+                __LINE__,
+                tableInfoGet()->nameGet().c_str(),
+                *num_returned);
+      return TDI_INVALID_ARG;
+    }
+    entryRead(handle, pair.first, pair.second);
+    (*num_returned)++;
+  }
+  return TDI_SUCCESS;
+}
+
+tdi_status_t MatchActionDirect::cursorAllocate(
+    const tdi::Session & /*session*/,
+    const tdi::Target & /*dev_tgt*/,
+    const tdi::Flags & /*flags*/,
+    const bool &snapshot,
+    std::unique_ptr<tdi::TableCursor> *cursor_ret) const {
+  if (cursor_ret == nullptr) {
+    LOG_ERROR("%s:%d Outparam passed is nullptr", __func__, __LINE__);
+    return TDI_INVALID_ARG;
+  }
+  auto status = engineCheck();
+  if (status != TDI_SUCCESS) return status;
+  *cursor_ret = std::unique_ptr<tdi::TableCursor>(
+      new TableCursor(this, snapshot));
+  return (*cursor_ret)->reset();
+}
+
+tdi_status_t MatchActionDirect::usageGet(const tdi::Session & /*session*/,
+                                         const tdi::Target & /*dev_tgt*/,
+                                         const tdi::Flags & /*flags*/,
+                                         uint32_t *count) const {
+  if (count == nullptr) {
+    LOG_ERROR("%s:%d Outparam passed is nullptr", __func__, __LINE__);
+    return TDI_INVALID_ARG;
+  }
+  std::lock_guard<std::mutex> lock(state_lock_);
+  *count = static_cast<uint32_t>(entry_index_.sizeGet());
+  return TDI_SUCCESS;
+}
+
+tdi_status_t MatchActionDirect::keyAllocate(
+    std::unique_ptr<tdi::TableKey> *key_ret) const {
+  *key_ret = std::unique_ptr<tdi::TableKey>(new TableKey(this, &key_layout_));
+  if (*key_ret == nullptr) {
+    return TDI_NO_SYS_RESOURCES;
+  }
+  return TDI_SUCCESS;
+}
+
+tdi_status_t MatchActionDirect::keyReset(tdi::TableKey *key) const {
+  const TableKey *dummy_key;
+  if (key == nullptr) {
+    LOG_ERROR("%s:%d Outparam passed is nullptr", __func__, __LINE__);
+    return TDI_INVALID_ARG;
+  }
+  auto status = keyCheck(*key, &dummy_key);
+  if (status != TDI_SUCCESS) return status;
+  return key->reset();
+}
+
+tdi_status_t MatchActionDirect::dataAllocate(
+    std::unique_ptr<tdi::TableData> *data_ret) const {
+  return this->dataAllocate(std::vector<tdi_id_t>(), 0, data_ret);
+}
+
+tdi_status_t MatchActionDirect::dataAllocate(
+    const tdi_id_t &action_id,
+    std::unique_ptr<tdi::TableData> *data_ret) const {
+  return this->dataAllocate(std::vector<tdi_id_t>(), action_id, data_ret);
+}
+
+tdi_status_t MatchActionDirect::dataAllocate(
+    const std::vector<tdi_id_t> &fields,
+    std::unique_ptr<tdi::TableData> *data_ret) const {
+  return this->dataAllocate(fields, 0, data_ret);
+}
+
+tdi_status_t MatchActionDirect::dataAllocate(
+    const std::vector<tdi_id_t> &fields,
+    const tdi_id_t &action_id,
+    std::unique_ptr<tdi::TableData> *data_ret) const {
+  if (action_id && tableInfoGet()->actionGet(action_id) == nullptr) {
+    return TDI_INVALID_ARG;
+  }
+  *data_ret = std::unique_ptr<tdi::TableData>(
+      new TableData(this, action_id, fields));
+  if (*data_ret == nullptr) {
+    return TDI_NO_SYS_RESOURCES;
+  }
+  return TDI_SUCCESS;
+}
+
+tdi_status_t MatchActionDirect::dataReset(tdi::TableData *data) const {
+  return this->dataReset(std::vector<tdi_id_t>(), 0, data);
+}
+
+tdi_status_t MatchActionDirect::dataReset(const tdi_id_t &action_id,
+                                          tdi::TableData *data) const {
+  return this->dataReset(std::vector<tdi_id_t>(), action_id, data);
+}
+
+tdi_status_t MatchActionDirect::dataReset(const std::vector<tdi_id_t> &fields,
+                                          tdi::TableData *data) const {
+  return this->dataReset(fields, 0, data);
+}
+
+tdi_status_t MatchActionDirect::dataReset(const std::vector<tdi_id_t> &fields,
+                                          const tdi_id_t &action_id,
+                                          tdi::TableData *data) const {
+  const TableData *dummy_data;
+  if (data == nullptr) {
+    LOG_ERROR("%s:%d Outparam passed is nullptr", __func__, __LINE__);
+    return TDI_INVALID_ARG;
+  }
+  auto status = dataCheck(*data, &dummy_data);
+  if (status != TDI_SUCCESS) return status;
+  if (action_id && tableInfoGet()->actionGet(action_id) == nullptr) {
+    return TDI_INVALID_ARG;
+  }
+  return data->reset(action_id, fields);
+}
+
+TableCursor::TableCursor(const MatchActionDirect *table,
+                         const bool &snapshot)
+    : tdi::TableCursor(table, snapshot), dummy_table_(table) {}
+
+tdi_status_t TableCursor::reset() {
+  position_ = 0;
+  if (!snapshotGet()) return TDI_SUCCESS;
+  const auto &index = dummy_table_->entry_index_;
+  const size_t &identity_size = index.keySizeGet();
+  std::lock_guard<std::mutex> lock(dummy_table_->state_lock_);
+  identities_.resize(index.sizeGet() * identity_size);
+  entries_.resize(index.sizeGet());
+  size_t count = 0;
+  for (uint32_t handle = 0; handle < index.handleEnd(); handle++) {
+    if (!index.handleInUse(handle)) continue;
+    std::memcpy(&identities_[count * identity_size],
+                index.keyGet(handle),
+                identity_size);
+    entries_[count] = dummy_table_->entries_[handle];
+    count++;
+  }
+  return TDI_SUCCESS;
+}
+
+tdi_status_t TableCursor::next(const uint32_t &n,
+                               tdi::TableKey **keys,
+                               tdi::TableData **datas,
+                               uint32_t *num_returned) {
+  if (keys == nullptr || datas == nullptr || num_returned == nullptr) {
+    LOG_ERROR("%s:%d Outparam passed is nullptr", __func__, __LINE__);
+    return TDI_INVALID_ARG;
+  }
+  for (uint32_t i = 0; i < n; i++) {
+    const TableKey *dummy_key;
+    const TableData *dummy_data;
+    if (keys[i] == nullptr || datas[i] == nullptr ||
+        dummy_table_->keyCheck(*keys[i], &dummy_key) != TDI_SUCCESS ||
+        dummy_table_->dataCheck(*datas[i], &dummy_data) != TDI_SUCCESS) {
+      LOG_ERROR("%s:%d %s Invalid key/data pair at %u",
+                __func__,
+                __LINE__,
+                dummy_table_->tableInfoGet()->nameGet().c_str(),
+                i);
+      return TDI_INVALID_ARG;
+    }
+  }
+
+  *num_returned = 0;
+  if (snapshotGet()) {
+    const size_t &identity_size =
+        dummy_table_->entry_index_.keySizeGet();
+    for (; position_ < entries_.size() && *num_returned < n; position_++) {
+      static_cast<TableKey *>(keys[*num_returned])
+          ->identitySet(&identities_[position_ * identity_size]);
+      dummy_table_->entryDataCopy(entries_[position_],
+                                  datas[*num_returned]);
+      (*num_returned)++;
+    }
+    return TDI_SUCCESS;
+  }
+
+  const auto &index = dummy_table_->entry_index_;
+  std::lock_guard<std::mutex> lock(dummy_table_->state_lock_);
+  for (; position_ < index.handleEnd() && *num_returned < n; position_++) {
+    if (!index.handleInUse(position_)) continue;
+    dummy_table_->entryRead(
+        position_, keys[*num_returned], datas[*num_returned]);
+    (*num_returned)++;
+  }
+  return TDI_SUCCESS;
+}
+
+}  // namespace dummy
+}  // namespace tna
+}  // namespace tdi
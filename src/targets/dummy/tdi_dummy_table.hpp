@@ -24,21 +24,298 @@
 #ifndef _TDI_DUMMY_TABLE_HPP
 #define _TDI_DUMMY_TABLE_HPP
 
+#include <mutex>
+#include <vector>
+
 #include <tdi/common/tdi_table.hpp>
 
+#include "tdi_dummy_exact_match_engine.hpp"
+#include "tdi_dummy_lpm_match_engine.hpp"
+#include "tdi_dummy_range_match_engine.hpp"
+#include "tdi_dummy_table_data.hpp"
+#include "tdi_dummy_table_key.hpp"
+#include "tdi_dummy_ternary_match_engine.hpp"
+
 namespace tdi {
 namespace tna {
 namespace dummy {
 
+class TableCursor;
+
+/**
+ * @brief Match action table kept entirely in software. Entries are indexed
+ * by the packed bytes of their key, which is all that tables whose key
+ * fields are all exact need. To serve entryLookup, tables with one LPM
+ * field and otherwise exact fields also keep their entries in an
+ * LpmMatchEngine, tables with range fields in a RangeMatchEngine, and
+ * tables with other mixes of exact, ternary and LPM fields in a
+ * TernaryMatchEngine.
+ */
 class MatchActionDirect : public tdi::Table {
  public:
+  // With prev_table, of the same schema, the new table shares its entries.
+  // Both stay usable while a program reload is in its grace period
   MatchActionDirect(const tdi::TdiInfo *tdi_info,
-                    const tdi::TableInfo *table_info)
-      : tdi::Table(tdi_info, table_info) {
-    LOG_ERROR("Creating table for %s", table_info->nameGet().c_str());
+                    const tdi::TableInfo *table_info,
+                    const MatchActionDirect *prev_table = nullptr)
+      : tdi::Table(tdi_info, table_info),
+        key_layout_(table_info),
+        state_(prev_table
+                   ? prev_table->state_
+                   : std::make_shared<State>(key_layout_.identitySizeGet())),
+        state_lock_(state_->lock),
+        entry_index_(state_->entry_index),
+        lpm_engine_(state_->lpm_engine),
+        ternary_engine_(state_->ternary_engine),
+        range_engine_(state_->range_engine),
+        entries_(state_->entries) {
+    LOG_DBG("Creating table for %s", table_info->nameGet().c_str());
+    matchEngineCreate();
   };
 
+  tdi_status_t entryAdd(const tdi::Session &session,
+                        const tdi::Target &dev_tgt,
+                        const tdi::Flags &flags,
+                        const tdi::TableKey &key,
+                        const tdi::TableData &data) const override;
+
+  tdi_status_t entryMod(const tdi::Session &session,
+                        const tdi::Target &dev_tgt,
+                        const tdi::Flags &flags,
+                        const tdi::TableKey &key,
+                        const tdi::TableData &data) const override;
+
+  tdi_status_t entryDel(const tdi::Session &session,
+                        const tdi::Target &dev_tgt,
+                        const tdi::Flags &flags,
+                        const tdi::TableKey &key) const override;
+
+  // The batch variants validate every entry up front and hold the table
+  // lock once for the whole batch
+  tdi_status_t entryAddBatch(
+      const tdi::Session &session,
+      const tdi::Target &dev_tgt,
+      const tdi::Flags &flags,
+      const std::vector<const tdi::TableKey *> &keys,
+      const std::vector<const tdi::TableData *> &datas,
+      std::vector<tdi_status_t> *statuses) const override;
+
+  tdi_status_t entryModBatch(
+      const tdi::Session &session,
+      const tdi::Target &dev_tgt,
+      const tdi::Flags &flags,
+      const std::vector<const tdi::TableKey *> &keys,
+      const std::vector<const tdi::TableData *> &datas,
+      std::vector<tdi_status_t> *statuses) const override;
+
+  tdi_status_t entryDelBatch(
+      const tdi::Session &session,
+      const tdi::Target &dev_tgt,
+      const tdi::Flags &flags,
+      const std::vector<const tdi::TableKey *> &keys,
+      std::vector<tdi_status_t> *statuses) const override;
+
+  tdi_status_t clear(const tdi::Session &session,
+                     const tdi::Target &dev_tgt,
+                     const tdi::Flags &flags) const override;
+
+  tdi_status_t entryGet(const tdi::Session &session,
+                        const tdi::Target &dev_tgt,
+                        const tdi::Flags &flags,
+                        const tdi::TableKey &key,
+                        tdi::TableData *data) const override;
+
+  // Looks up the whole batch in the index with the bucket loads of
+  // neighbouring keys overlapped
+  tdi_status_t entryGetBatch(
+      const tdi::Session &session,
+      const tdi::Target &dev_tgt,
+      const tdi::Flags &flags,
+      const std::vector<const tdi::TableKey *> &keys,
+      const std::vector<tdi::TableData *> &datas,
+      std::vector<tdi_status_t> *statuses) const override;
+
+  tdi_status_t entryGet(const tdi::Session &session,
+                        const tdi::Target &dev_tgt,
+                        const tdi::Flags &flags,
+                        const tdi_handle_t &entry_handle,
+                        tdi::TableKey *key,
+                        tdi::TableData *data) const override;
+
+  tdi_status_t entryKeyGet(const tdi::Session &session,
+                           const tdi::Target &dev_tgt,
+                           const tdi::Flags &flags,
+                           const tdi_handle_t &entry_handle,
+                           tdi::Target *entry_tgt,
+                           tdi::TableKey *key) const override;
+
+  tdi_status_t entryHandleGet(const tdi::Session &session,
+                              const tdi::Target &dev_tgt,
+                              const tdi::Flags &flags,
+                              const tdi::TableKey &key,
+                              tdi_handle_t *entry_handle) const override;
+
+  tdi_status_t entryGetFirst(const tdi::Session &session,
+                             const tdi::Target &dev_tgt,
+                             const tdi::Flags &flags,
+                             tdi::TableKey *key,
+                             tdi::TableData *data) const override;
+
+  tdi_status_t entryGetNextN(const tdi::Session &session,
+                             const tdi::Target &dev_tgt,
+                             const tdi::Flags &flags,
+                             const tdi::TableKey &key,
+                             const uint32_t &n,
+                             keyDataPairs *key_data_pairs,
+                             uint32_t *num_returned) const override;
+
+  tdi_status_t cursorAllocate(
+      const tdi::Session &session,
+      const tdi::Target &dev_tgt,
+      const tdi::Flags &flags,
+      const bool &snapshot,
+      std::unique_ptr<tdi::TableCursor> *cursor_ret) const override;
+
+  tdi_status_t usageGet(const tdi::Session &session,
+                        const tdi::Target &dev_tgt,
+                        const tdi::Flags &flags,
+                        uint32_t *count) const override;
+
+  tdi_status_t keyAllocate(
+      std::unique_ptr<tdi::TableKey> *key_ret) const override;
+  tdi_status_t keyReset(tdi::TableKey *key) const override;
+
+  tdi_status_t dataAllocate(
+      std::unique_ptr<tdi::TableData> *data_ret) const override;
+  tdi_status_t dataAllocate(
+      const tdi_id_t &action_id,
+      std::unique_ptr<tdi::TableData> *data_ret) const override;
+  tdi_status_t dataAllocate(
+      const std::vector<tdi_id_t> &fields,
+      std::unique_ptr<tdi::TableData> *data_ret) const override;
+  tdi_status_t dataAllocate(
+      const std::vector<tdi_id_t> &fields,
+      const tdi_id_t &action_id,
+      std::unique_ptr<tdi::TableData> *data_ret) const override;
+
+  tdi_status_t dataReset(tdi::TableData *data) const override;
+  tdi_status_t dataReset(const tdi_id_t &action_id,
+                         tdi::TableData *data) const override;
+  tdi_status_t dataReset(const std::vector<tdi_id_t> &fields,
+                         tdi::TableData *data) const override;
+  tdi_status_t dataReset(const std::vector<tdi_id_t> &fields,
+                         const tdi_id_t &action_id,
+                         tdi::TableData *data) const override;
+
   bool actionIdApplicable() const override { return true; };
+
+  /**
+   * @brief Find the entry a packet with the given header values would hit.
+   * Each key field holds the header value to look up, set with a full
+   * mask or prefix length since values are stored masked. The masks and
+   * the $MATCH_PRIORITY field are then ignored.
+   *
+   * @param[in] key Key object holding the header values
+   * @param[out] entry_handle Handle of the matching entry
+   *
+   * @return TDI_OBJECT_NOT_FOUND on a miss
+   */
+  tdi_status_t entryLookup(const tdi::TableKey &key,
+                           tdi_handle_t *entry_handle) const;
+
+  /**
+   * @brief Find the entries of a table with range fields that match at
+   * least one packet the given key would match
+   *
+   * @param[in] key Key object of a candidate entry
+   * @param[out] entry_handles Handles of the overlapping entries
+   *
+   * @return TDI_NOT_SUPPORTED if the table has no range field
+   */
+  tdi_status_t entryOverlapGet(const tdi::TableKey &key,
+                               std::vector<tdi_handle_t> *entry_handles) const;
+
+ private:
+  friend class TableCursor;
+
+  struct EntryState {
+    tdi_id_t action_id{0};
+    FieldValueMap field_values;
+  };
+
+  // Everything an entry update changes
+  struct State {
+    State(const size_t &identity_size) : entry_index(identity_size){};
+    std::mutex lock;
+    ExactMatchEngine entry_index;
+    std::unique_ptr<LpmMatchEngine> lpm_engine;
+    std::unique_ptr<TernaryMatchEngine> ternary_engine;
+    std::unique_ptr<RangeMatchEngine> range_engine;
+    std::vector<EntryState> entries;
+  };
+
+  tdi_status_t keyCheck(const tdi::TableKey &key,
+                        const TableKey **dummy_key) const;
+  tdi_status_t dataCheck(const tdi::TableData &data,
+                         const TableData **dummy_data) const;
+  void matchEngineCreate();
+  // Entry updates once the arguments are checked, with state_lock_ held
+  tdi_status_t entryAddLocked(const TableKey &dummy_key,
+                              const TableData &dummy_data) const;
+  tdi_status_t entryModLocked(const TableKey &dummy_key,
+                              const TableData &dummy_data) const;
+  tdi_status_t entryDelLocked(const TableKey &dummy_key) const;
+  // Exact fields followed by the LPM field, the key of the LpmMatchEngine
+  void lpmKeyBuild(const uint8_t *value, std::vector<uint8_t> *lpm_key) const;
+  // Key mask over the fields of the masked match
+  void matchMaskBuild(const TableKey &key, std::vector<uint8_t> *mask) const;
+  tdi_status_t engineCheck() const;
+  void entryDataCopy(const EntryState &entry, tdi::TableData *data) const;
+  tdi_status_t entryRead(const uint32_t &handle,
+                         tdi::TableKey *key,
+                         tdi::TableData *data) const;
+
+  const KeyLayout key_layout_;
+  const std::shared_ptr<State> state_;
+  // Members of state_
+  std::mutex &state_lock_;
+  // Entry identity to entry handle
+  ExactMatchEngine &entry_index_;
+  // At most one of these is set, for tables which are not exact only
+  std::unique_ptr<LpmMatchEngine> &lpm_engine_;
+  std::unique_ptr<TernaryMatchEngine> &ternary_engine_;
+  std::unique_ptr<RangeMatchEngine> &range_engine_;
+  const KeyFieldLayout *lpm_field_{nullptr};
+  // Prefix bits of the LpmMatchEngine key before the LPM field value
+  size_t lpm_prefix_base_{0};
+  // Entry state indexed by entry handle
+  std::vector<EntryState> &entries_;
+};
+
+/**
+ * @brief Cursor over a MatchActionDirect table. It walks the entry handles
+ * in increasing order and remembers the next handle to visit. A snapshot
+ * cursor copies the identities and state of the entries once, under the
+ * table lock, and then reads pages from its copy without taking the lock.
+ */
+class TableCursor : public tdi::TableCursor {
+ public:
+  TableCursor(const MatchActionDirect *table, const bool &snapshot);
+
+  tdi_status_t next(const uint32_t &n,
+                    tdi::TableKey **keys,
+                    tdi::TableData **datas,
+                    uint32_t *num_returned) override;
+
+  tdi_status_t reset() override;
+
+ private:
+  const MatchActionDirect *dummy_table_;
+  // Next entry handle, or next snapshot index, to read
+  uint32_t position_{0};
+  // Snapshot of the entries in handle order
+  std::vector<uint8_t> identities_;
+  std::vector<MatchActionDirect::EntryState> entries_;
 };
 
 class MatchActionIndirect : public tdi::Table {
@@ -46,7 +323,7 @@ class MatchActionIndirect : public tdi::Table {
   MatchActionIndirect(const tdi::TdiInfo *tdi_info,
                       const tdi::TableInfo *table_info)
       : tdi::Table(tdi_info, table_info) {
-    LOG_ERROR("Creating table for %s", table_info->nameGet().c_str());
+    LOG_DBG("Creating table for %s", table_info->nameGet().c_str());
   };
 };
 
@@ -54,7 +331,7 @@ class ActionProfile : public tdi::Table {
  public:
   ActionProfile(const tdi::TdiInfo *tdi_info, const tdi::TableInfo *table_info)
       : tdi::Table(tdi_info, table_info) {
-    LOG_ERROR("Creating table for %s", table_info->nameGet().c_str());
+    LOG_DBG("Creating table for %s", table_info->nameGet().c_str());
   };
 };
 
@@ -62,7 +339,7 @@ class Selector : public tdi::Table {
  public:
   Selector(const tdi::TdiInfo *tdi_info, const tdi::TableInfo *table_info)
       : tdi::Table(tdi_info, table_info) {
-    LOG_ERROR("Creating table for %s", table_info->nameGet().c_str());
+    LOG_DBG("Creating table for %s", table_info->nameGet().c_str());
   };
 };
 
@@ -71,7 +348,7 @@ class CounterIndirect : public tdi::Table {
   CounterIndirect(const tdi::TdiInfo *tdi_info,
                   const tdi::TableInfo *table_info)
       : tdi::Table(tdi_info, table_info) {
-    LOG_ERROR("Creating table for %s", table_info->nameGet().c_str());
+    LOG_DBG("Creating table for %s", table_info->nameGet().c_str());
   };
 };
 
@@ -79,7 +356,7 @@ class MeterIndirect : public tdi::Table {
  public:
   MeterIndirect(const tdi::TdiInfo *tdi_info, const tdi::TableInfo *table_info)
       : tdi::Table(tdi_info, table_info) {
-    LOG_ERROR("Creating table for %s", table_info->nameGet().c_str());
+    LOG_DBG("Creating table for %s", table_info->nameGet().c_str());
   };
 };
 
@@ -88,7 +365,7 @@ class RegisterIndirect : public tdi::Table {
   RegisterIndirect(const tdi::TdiInfo *tdi_info,
                    const tdi::TableInfo *table_info)
       : tdi::Table(tdi_info, table_info) {
-    LOG_ERROR("Creating table for %s", table_info->nameGet().c_str());
+    LOG_DBG("Creating table for %s", table_info->nameGet().c_str());
   };
 };
 
@@ -96,7 +373,7 @@ class PortConfigure : public tdi::Table {
  public:
   PortConfigure(const tdi::TdiInfo *tdi_info, const tdi::TableInfo *table_info)
       : tdi::Table(tdi_info, table_info) {
-    LOG_ERROR("Creating table for %s", table_info->nameGet().c_str());
+    LOG_DBG("Creating table for %s", table_info->nameGet().c_str());
   };
 };
 
@@ -104,7 +381,7 @@ class PortStat : public tdi::Table {
  public:
   PortStat(const tdi::TdiInfo *tdi_info, const tdi::TableInfo *table_info)
       : tdi::Table(tdi_info, table_info) {
-    LOG_ERROR("Creating table for %s", table_info->nameGet().c_str());
+    LOG_DBG("Creating table for %s", table_info->nameGet().c_str());
   };
 };
 
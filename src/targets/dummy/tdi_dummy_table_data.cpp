@@ -0,0 +1,272 @@
+/*
+ * Copyright(c) 2021 Intel Corporation.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this software except as stipulated in the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <cstring>
+
+#include <tdi/common/tdi_table.hpp>
+#include <tdi/common/tdi_utils.hpp>
+
+#include "tdi_dummy_table_data.hpp"
+
+namespace tdi {
+namespace tna {
+namespace dummy {
+
+namespace {
+
+inline size_t fieldBytes(const tdi::DataFieldInfo *field_info) {
+  return (field_info->sizeGet() + 7) / 8;
+}
+
+}  // namespace
+
+tdi_status_t TableData::fieldInfoGet(
+    const tdi_id_t &field_id, const tdi::DataFieldInfo **field_info) const {
+  *field_info = table_->tableInfoGet()->dataFieldGet(field_id, actionIdGet());
+  if (*field_info == nullptr) {
+    return TDI_OBJECT_NOT_FOUND;
+  }
+  bool is_active = false;
+  this->isActive(field_id, &is_active);
+  if (!is_active) {
+    LOG_ERROR("%s:%d %s Field %d is not active",
+              __func__,
+              __LINE__,
+              table_->tableInfoGet()->nameGet().c_str(),
+              field_id);
+    return TDI_INVALID_ARG;
+  }
+  return TDI_SUCCESS;
+}
+
+tdi_status_t TableData::fieldSet(const tdi::DataFieldInfo *field_info,
+                                 std::vector<uint8_t> value) {
+  // Setting one field of a oneof deactivates the others
+  for (const auto &sibling : field_info->oneofSiblingsGet()) {
+    this->removeActiveField(sibling);
+    field_values_.erase(sibling);
+  }
+  field_values_[field_info->idGet()] = std::move(value);
+  return TDI_SUCCESS;
+}
+
+tdi_status_t TableData::fieldGet(const tdi_id_t &field_id,
+                                 const std::vector<uint8_t> **value) const {
+  auto it = field_values_.find(field_id);
+  if (it == field_values_.end()) {
+    LOG_TRACE("%s:%d %s Field %d not set",
+              __func__,
+              __LINE__,
+              table_->tableInfoGet()->nameGet().c_str(),
+              field_id);
+    return TDI_OBJECT_NOT_FOUND;
+  }
+  *value = &it->second;
+  return TDI_SUCCESS;
+}
+
+tdi_status_t TableData::setValue(const tdi_id_t &field_id,
+                                 const uint64_t &value) {
+  const tdi::DataFieldInfo *field_info;
+  auto status = fieldInfoGet(field_id, &field_info);
+  if (status != TDI_SUCCESS) return status;
+  const size_t size_bits = field_info->sizeGet();
+  if (field_info->isPtrGet() || fieldBytes(field_info) > sizeof(uint64_t)) {
+    LOG_ERROR("%s:%d Field %d can only be set as a byte stream",
+              __func__,
+              __LINE__,
+              field_id);
+    return TDI_INVALID_ARG;
+  }
+  if (size_bits < 64 && (value >> size_bits)) {
+    LOG_ERROR("%s:%d Value exceeds the %zu bits of field %d",
+              __func__,
+              __LINE__,
+              size_bits,
+              field_id);
+    return TDI_INVALID_ARG;
+  }
+  std::vector<uint8_t> bytes(fieldBytes(field_info));
+  TdiEndiannessHandler::toNetworkOrder(bytes.size(), value, bytes.data());
+  return fieldSet(field_info, std::move(bytes));
+}
+
+tdi_status_t TableData::setValue(const tdi_id_t &field_id,
+                                 const uint8_t *value,
+                                 const size_t &size) {
+  if (value == nullptr) {
+    LOG_ERROR("%s:%d Value passed is nullptr", __func__, __LINE__);
+    return TDI_INVALID_ARG;
+  }
+  return this->setValue(field_id, std::vector<uint8_t>(value, value + size));
+}
+
+tdi_status_t TableData::setValue(const tdi_id_t &field_id,
+                                 std::vector<uint8_t> &&value) {
+  const tdi::DataFieldInfo *field_info;
+  auto status = fieldInfoGet(field_id, &field_info);
+  if (status != TDI_SUCCESS) return status;
+  if (value.size() != fieldBytes(field_info)) {
+    LOG_ERROR("%s:%d Size %zu does not match the %zu bytes of field %d",
+              __func__,
+              __LINE__,
+              value.size(),
+              fieldBytes(field_info),
+              field_id);
+    return TDI_INVALID_ARG;
+  }
+  // Values are kept as byte arrays, so the vector is adopted as is
+  return fieldSet(field_info, std::move(value));
+}
+
+tdi_status_t TableData::setValue(const tdi_id_t &field_id, const bool &value) {
+  const tdi::DataFieldInfo *field_info;
+  auto status = fieldInfoGet(field_id, &field_info);
+  if (status != TDI_SUCCESS) return status;
+  if (field_info->dataTypeGet() != TDI_FIELD_DATA_TYPE_BOOL) {
+    LOG_ERROR("%s:%d Field %d is not a bool", __func__, __LINE__, field_id);
+    return TDI_INVALID_ARG;
+  }
+  return fieldSet(field_info,
+                  std::vector<uint8_t>(1, static_cast<uint8_t>(value)));
+}
+
+tdi_status_t TableData::getValue(const tdi_id_t &field_id,
+                                 uint64_t *value) const {
+  if (value == nullptr) {
+    LOG_ERROR("%s:%d Outparam passed is nullptr", __func__, __LINE__);
+    return TDI_INVALID_ARG;
+  }
+  const tdi::DataFieldInfo *field_info;
+  auto status = fieldInfoGet(field_id, &field_info);
+  if (status != TDI_SUCCESS) return status;
+  if (field_info->isPtrGet() || fieldBytes(field_info) > sizeof(uint64_t)) {
+    LOG_ERROR("%s:%d Field %d can only be read as a byte stream",
+              __func__,
+              __LINE__,
+              field_id);
+    return TDI_INVALID_ARG;
+  }
+  const std::vector<uint8_t> *bytes;
+  status = fieldGet(field_id, &bytes);
+  if (status != TDI_SUCCESS) return status;
+  TdiEndiannessHandler::toHostOrder(bytes->size(), bytes->data(), value);
+  return TDI_SUCCESS;
+}
+
+tdi_status_t TableData::getValue(const tdi_id_t &field_id,
+                                 const size_t &size,
+                                 uint8_t *value) const {
+  if (value == nullptr) {
+    LOG_ERROR("%s:%d Outparam passed is nullptr", __func__, __LINE__);
+    return TDI_INVALID_ARG;
+  }
+  const tdi::DataFieldInfo *field_info;
+  auto status = fieldInfoGet(field_id, &field_info);
+  if (status != TDI_SUCCESS) return status;
+  if (size != fieldBytes(field_info)) {
+    LOG_ERROR("%s:%d Size %zu does not match the %zu bytes of field %d",
+              __func__,
+              __LINE__,
+              size,
+              fieldBytes(field_info),
+              field_id);
+    return TDI_INVALID_ARG;
+  }
+  const std::vector<uint8_t> *bytes;
+  status = fieldGet(field_id, &bytes);
+  if (status != TDI_SUCCESS) return status;
+  std::memcpy(value, bytes->data(), size);
+  return TDI_SUCCESS;
+}
+
+tdi_status_t TableData::getValueView(const tdi_id_t &field_id,
+                                     const uint8_t **value,
+                                     size_t *size) const {
+  if (value == nullptr || size == nullptr) {
+    LOG_ERROR("%s:%d Outparam passed is nullptr", __func__, __LINE__);
+    return TDI_INVALID_ARG;
+  }
+  const tdi::DataFieldInfo *field_info;
+  auto status = fieldInfoGet(field_id, &field_info);
+  if (status != TDI_SUCCESS) return status;
+  const std::vector<uint8_t> *bytes;
+  status = fieldGet(field_id, &bytes);
+  if (status != TDI_SUCCESS) return status;
+  *value = bytes->data();
+  *size = bytes->size();
+  return TDI_SUCCESS;
+}
+
+tdi_status_t TableData::getValue(const tdi_id_t &field_id, bool *value) const {
+  if (value == nullptr) {
+    LOG_ERROR("%s:%d Outparam passed is nullptr", __func__, __LINE__);
+    return TDI_INVALID_ARG;
+  }
+  const tdi::DataFieldInfo *field_info;
+  auto status = fieldInfoGet(field_id, &field_info);
+  if (status != TDI_SUCCESS) return status;
+  if (field_info->dataTypeGet() != TDI_FIELD_DATA_TYPE_BOOL) {
+    LOG_ERROR("%s:%d Field %d is not a bool", __func__, __LINE__, field_id);
+    return TDI_INVALID_ARG;
+  }
+  const std::vector<uint8_t> *bytes;
+  status = fieldGet(field_id, &bytes);
+  if (status != TDI_SUCCESS) return status;
+  *value = (*bytes)[0] != 0;
+  return TDI_SUCCESS;
+}
+
+tdi_status_t TableData::resetDerived() {
+  field_values_.clear();
+  return TDI_SUCCESS;
+}
+
+bool TableData::equalsDerived(const tdi::TableData &other) const {
+  const auto *dummy_other = dynamic_cast<const TableData *>(&other);
+  if (dummy_other == nullptr) return false;
+  // Both have the same active fields here. A field holds a value in only one
+  // of them if it was set in one and not the other
+  const auto &other_values = dummy_other->field_values_;
+  auto it = field_values_.begin();
+  auto other_it = other_values.begin();
+  while (it != field_values_.end() || other_it != other_values.end()) {
+    tdi_id_t field_id;
+    if (other_it == other_values.end() ||
+        (it != field_values_.end() && it->first < other_it->first)) {
+      field_id = (it++)->first;
+    } else if (it == field_values_.end() || other_it->first < it->first) {
+      field_id = (other_it++)->first;
+    } else {
+      if (it->second != other_it->second) {
+        bool is_active = false;
+        this->isActive(it->first, &is_active);
+        if (is_active) return false;
+      }
+      ++it;
+      ++other_it;
+      continue;
+    }
+    bool is_active = false;
+    this->isActive(field_id, &is_active);
+    if (is_active) return false;
+  }
+  return true;
+}
+
+}  // namespace dummy
+}  // namespace tna
+}  // namespace tdi
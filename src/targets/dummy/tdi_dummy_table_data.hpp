@@ -0,0 +1,93 @@
+/*
+ * Copyright(c) 2021 Intel Corporation.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this software except as stipulated in the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+/** @file tdi_dummy_table_data.hpp
+ *
+ *  @brief Contains the dummy target Table Data object
+ */
+#ifndef _TDI_DUMMY_TABLE_DATA_HPP
+#define _TDI_DUMMY_TABLE_DATA_HPP
+
+#include <map>
+#include <vector>
+
+#include <tdi/common/tdi_json_parser/tdi_table_info.hpp>
+#include <tdi/common/tdi_table_data.hpp>
+
+namespace tdi {
+namespace tna {
+namespace dummy {
+
+/**
+ * @brief Data field values of a dummy table entry, by field ID. Values are
+ * kept as network order byte streams of the field width.
+ */
+using FieldValueMap = std::map<tdi_id_t, std::vector<uint8_t>>;
+
+class TableData : public tdi::TableData {
+ public:
+  TableData(const tdi::Table *table,
+            tdi_id_t action_id,
+            const std::vector<tdi_id_t> &fields)
+      : tdi::TableData(table, action_id, fields){};
+  ~TableData() = default;
+
+  using tdi::TableData::getValue;
+  using tdi::TableData::setValue;
+
+  tdi_status_t setValue(const tdi_id_t &field_id,
+                        const uint64_t &value) override;
+  tdi_status_t setValue(const tdi_id_t &field_id,
+                        const uint8_t *value,
+                        const size_t &size) override;
+  tdi_status_t setValue(const tdi_id_t &field_id,
+                        std::vector<uint8_t> &&value) override;
+  tdi_status_t setValue(const tdi_id_t &field_id, const bool &value) override;
+
+  tdi_status_t getValue(const tdi_id_t &field_id,
+                        uint64_t *value) const override;
+  tdi_status_t getValue(const tdi_id_t &field_id,
+                        const size_t &size,
+                        uint8_t *value) const override;
+  tdi_status_t getValueView(const tdi_id_t &field_id,
+                            const uint8_t **value,
+                            size_t *size) const override;
+  tdi_status_t getValue(const tdi_id_t &field_id, bool *value) const override;
+
+  const FieldValueMap &fieldValuesGet() const { return field_values_; };
+  void fieldValuesSet(const FieldValueMap &field_values) {
+    field_values_ = field_values;
+  };
+
+ protected:
+  tdi_status_t resetDerived() override;
+  bool equalsDerived(const tdi::TableData &other) const override;
+
+ private:
+  tdi_status_t fieldInfoGet(const tdi_id_t &field_id,
+                            const tdi::DataFieldInfo **field_info) const;
+  tdi_status_t fieldSet(const tdi::DataFieldInfo *field_info,
+                        std::vector<uint8_t> value);
+  tdi_status_t fieldGet(const tdi_id_t &field_id,
+                        const std::vector<uint8_t> **value) const;
+
+  FieldValueMap field_values_;
+};
+
+}  // namespace dummy
+}  // namespace tna
+}  // namespace tdi
+
+#endif  // _TDI_DUMMY_TABLE_DATA_HPP
@@ -0,0 +1,47 @@
+/*
+ * Copyright(c) 2021 Intel Corporation.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this software except as stipulated in the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+/** @file tdi_dummy_table_key.hpp
+ *
+ *  @brief Contains the dummy target Table Key object
+ */
+#ifndef _TDI_DUMMY_TABLE_KEY_HPP
+#define _TDI_DUMMY_TABLE_KEY_HPP
+
+#include <tdi/common/tdi_packed_table_key.hpp>
+
+namespace tdi {
+namespace tna {
+namespace dummy {
+
+using KeyFieldLayout = tdi::PackedKeyFieldLayout;
+using KeyLayout = tdi::PackedKeyLayout;
+
+/**
+ * @brief The dummy key is the common packed key over the layout of its
+ * table
+ */
+class TableKey : public tdi::PackedTableKey {
+ public:
+  TableKey(const tdi::Table *table, const KeyLayout *layout)
+      : tdi::PackedTableKey(table, layout){};
+  ~TableKey() = default;
+};
+
+}  // namespace dummy
+}  // namespace tna
+}  // namespace tdi
+
+#endif  // _TDI_DUMMY_TABLE_KEY_HPP
@@ -0,0 +1,165 @@
+/*
+ * Copyright(c) 2021 Intel Corporation.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this software except as stipulated in the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <algorithm>
+
+#include "tdi_dummy_ternary_match_engine.hpp"
+
+namespace tdi {
+namespace tna {
+namespace dummy {
+
+tdi_status_t TernaryMatchEngine::insert(const uint32_t &handle,
+                                        const uint8_t *value,
+                                        const uint8_t *mask,
+                                        const uint32_t &priority) {
+  if (handle < rules_.size() && rules_[handle].in_use) {
+    return TDI_ALREADY_EXISTS;
+  }
+  std::vector<uint8_t> mask_vec(mask, mask + key_size_);
+  uint32_t tuple_id;
+  auto it = tuple_index_.find(mask_vec);
+  if (it != tuple_index_.end()) {
+    tuple_id = it->second;
+  } else {
+    if (!free_tuples_.empty()) {
+      tuple_id = free_tuples_.back();
+      free_tuples_.pop_back();
+    } else {
+      tuple_id = static_cast<uint32_t>(tuples_.size());
+      tuples_.emplace_back();
+    }
+    tuples_[tuple_id].reset(new Tuple(mask, key_size_));
+    tuple_index_[mask_vec] = tuple_id;
+  }
+  auto &tuple = *tuples_[tuple_id];
+
+  scratch_.resize(key_size_);
+  for (size_t i = 0; i < key_size_; i++) {
+    scratch_[i] = value[i] & mask[i];
+  }
+  uint32_t group;
+  if (tuple.groups.insert(scratch_.data(), &group) == TDI_SUCCESS &&
+      group >= tuple.group_rules.size()) {
+    tuple.group_rules.resize(group + 1);
+  }
+
+  if (handle >= rules_.size()) {
+    rules_.resize(handle + 1);
+  }
+  auto &rule = rules_[handle];
+  rule.in_use = true;
+  rule.priority = priority;
+  rule.tuple = tuple_id;
+  rule.group = group;
+
+  auto &group_rules = tuple.group_rules[group];
+  group_rules.insert(
+      std::upper_bound(group_rules.begin(),
+                       group_rules.end(),
+                       handle,
+                       [this](const uint32_t &a, const uint32_t &b) {
+                         return ruleBetter(a, b);
+                       }),
+      handle);
+  tuple.priorities.insert(std::make_pair(priority, handle));
+  tuple_order_dirty_ = true;
+  size_++;
+  return TDI_SUCCESS;
+}
+
+tdi_status_t TernaryMatchEngine::erase(const uint32_t &handle) {
+  if (handle >= rules_.size() || !rules_[handle].in_use) {
+    return TDI_OBJECT_NOT_FOUND;
+  }
+  auto &rule = rules_[handle];
+  auto &tuple = *tuples_[rule.tuple];
+  auto &group_rules = tuple.group_rules[rule.group];
+  group_rules.erase(
+      std::find(group_rules.begin(), group_rules.end(), handle));
+  if (group_rules.empty()) {
+    uint32_t group;
+    tuple.groups.erase(tuple.groups.keyGet(rule.group), &group);
+  }
+  tuple.priorities.erase(std::make_pair(rule.priority, handle));
+  if (tuple.priorities.empty()) {
+    tuple_index_.erase(tuple.mask);
+    tuples_[rule.tuple].reset();
+    free_tuples_.push_back(rule.tuple);
+  }
+  rule = Rule();
+  tuple_order_dirty_ = true;
+  size_--;
+  return TDI_SUCCESS;
+}
+
+void TernaryMatchEngine::tupleOrderUpdate() const {
+  tuple_order_.clear();
+  for (const auto &kv : tuple_index_) {
+    tuple_order_.push_back(kv.second);
+  }
+  std::sort(tuple_order_.begin(),
+            tuple_order_.end(),
+            [this](const uint32_t &a, const uint32_t &b) {
+              return *tuples_[a]->priorities.begin() <
+                     *tuples_[b]->priorities.begin();
+            });
+  tuple_order_dirty_ = false;
+}
+
+tdi_status_t TernaryMatchEngine::lookup(const uint8_t *key,
+                                        uint32_t *handle) const {
+  if (tuple_order_dirty_) tupleOrderUpdate();
+  bool found = false;
+  uint32_t best = 0;
+  scratch_.resize(key_size_);
+  for (const auto &tuple_id : tuple_order_) {
+    const auto &tuple = *tuples_[tuple_id];
+    // Tuples are sorted by their best rule, nothing after this one can win
+    if (found && !ruleBetter(tuple.priorities.begin()->second, best)) {
+      break;
+    }
+    for (size_t i = 0; i < key_size_; i++) {
+      scratch_[i] = key[i] & tuple.mask[i];
+    }
+    uint32_t group;
+    if (tuple.groups.find(scratch_.data(), &group) != TDI_SUCCESS) {
+      continue;
+    }
+    const auto &candidate = tuple.group_rules[group].front();
+    if (!found || ruleBetter(candidate, best)) {
+      best = candidate;
+      found = true;
+    }
+  }
+  if (!found) return TDI_OBJECT_NOT_FOUND;
+  *handle = best;
+  return TDI_SUCCESS;
+}
+
+void TernaryMatchEngine::clear() {
+  size_ = 0;
+  tuples_.clear();
+  free_tuples_.clear();
+  tuple_index_.clear();
+  rules_.clear();
+  tuple_order_.clear();
+  tuple_order_dirty_ = false;
+}
+
+}  // namespace dummy
+}  // namespace tna
+}  // namespace tdi
@@ -0,0 +1,131 @@
+/*
+ * Copyright(c) 2021 Intel Corporation.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this software except as stipulated in the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+/** @file tdi_dummy_ternary_match_engine.hpp
+ *
+ *  @brief Contains the software ternary classifier used by dummy tables
+ */
+#ifndef _TDI_DUMMY_TERNARY_MATCH_ENGINE_HPP
+#define _TDI_DUMMY_TERNARY_MATCH_ENGINE_HPP
+
+#include <map>
+#include <memory>
+#include <set>
+#include <vector>
+
+#include "tdi_dummy_exact_match_engine.hpp"
+
+namespace tdi {
+namespace tna {
+namespace dummy {
+
+/**
+ * @brief Tuple space search classifier over packed key bytes.
+ *
+ * Rules sharing a mask form a tuple. Each tuple is an exact match on the
+ * masked key, so a lookup costs one hash probe per tuple instead of one
+ * compare per rule. Tuples are visited in order of the best priority they
+ * hold and the walk stops as soon as no remaining tuple can beat the rule
+ * already found. Insert and delete only touch the tuple of the rule.
+ *
+ * Lower priority values win, as with $MATCH_PRIORITY. Rules of equal
+ * priority that both match a key are resolved by the lowest handle.
+ */
+class TernaryMatchEngine {
+ public:
+  TernaryMatchEngine(const size_t &key_size) : key_size_(key_size){};
+
+  /**
+   * @brief Add a rule
+   *
+   * @param[in] handle Caller assigned handle of the rule. Must not be in use
+   * @param[in] value Packed key value. Bits outside the mask are ignored
+   * @param[in] mask Packed key mask
+   * @param[in] priority Priority of the rule, lower wins
+   *
+   * @return Status of the API call
+   */
+  tdi_status_t insert(const uint32_t &handle,
+                      const uint8_t *value,
+                      const uint8_t *mask,
+                      const uint32_t &priority);
+
+  /**
+   * @brief Remove a rule
+   *
+   * @return TDI_OBJECT_NOT_FOUND if no rule has the handle
+   */
+  tdi_status_t erase(const uint32_t &handle);
+
+  /**
+   * @brief Find the best rule matching a key
+   *
+   * @param[in] key Packed key bytes
+   * @param[out] handle Handle of the matching rule
+   *
+   * @return TDI_OBJECT_NOT_FOUND if no rule matches
+   */
+  tdi_status_t lookup(const uint8_t *key, uint32_t *handle) const;
+
+  void clear();
+
+  size_t sizeGet() const { return size_; };
+  size_t tupleCountGet() const { return tuple_index_.size(); };
+
+ private:
+  struct Tuple {
+    Tuple(const uint8_t *mask_bytes, const size_t &key_size)
+        : mask(mask_bytes, mask_bytes + key_size), groups(key_size){};
+    std::vector<uint8_t> mask;
+    // Masked key to group. Each group lists the handles of the rules with
+    // that masked key, best first
+    ExactMatchEngine groups;
+    std::vector<std::vector<uint32_t>> group_rules;
+    // (priority, handle) of every rule, for the best priority of the tuple
+    std::set<std::pair<uint32_t, uint32_t>> priorities;
+  };
+
+  struct Rule {
+    bool in_use{false};
+    uint32_t priority{0};
+    uint32_t tuple{0};
+    uint32_t group{0};
+  };
+
+  bool ruleBetter(const uint32_t &a, const uint32_t &b) const {
+    return rules_[a].priority != rules_[b].priority
+               ? rules_[a].priority < rules_[b].priority
+               : a < b;
+  };
+  void tupleOrderUpdate() const;
+
+  const size_t key_size_;
+  size_t size_{0};
+  std::vector<std::unique_ptr<Tuple>> tuples_;
+  std::vector<uint32_t> free_tuples_;
+  std::map<std::vector<uint8_t>, uint32_t> tuple_index_;
+  std::vector<Rule> rules_;
+
+  // Tuples by best priority, rebuilt on the first lookup after a change
+  mutable std::vector<uint32_t> tuple_order_;
+  mutable bool tuple_order_dirty_{false};
+  mutable std::vector<uint8_t> scratch_;
+};
+
+}  // namespace dummy
+}  // namespace tna
+}  // namespace tdi
+
+#endif  // _TDI_DUMMY_TERNARY_MATCH_ENGINE_HPP
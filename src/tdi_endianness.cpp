@@ -0,0 +1,341 @@
+/*
+ * Copyright(c) 2021 Intel Corporation.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this software except as stipulated in the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include <cstdint>
+#include <cstring>
+
+#if defined(__x86_64__) && defined(__GNUC__)
+#include <immintrin.h>
+#define TDI_ENDIANNESS_X86 1
+#endif
+
+// local includes
+#include <tdi/common/tdi_utils.hpp>
+
+namespace tdi {
+
+namespace {
+
+#if __BYTE_ORDER__ == __ORDER_BIG_ENDIAN__
+const bool kSwap = false;
+#else
+const bool kSwap = true;
+#endif
+
+inline uint64_t load64(const uint8_t *p) {
+  uint64_t v;
+  std::memcpy(&v, p, sizeof(v));
+  return v;
+}
+
+inline void store64(uint8_t *p, const uint64_t &v) {
+  std::memcpy(p, &v, sizeof(v));
+}
+
+// Reverse src into dst working inwards from both ends. Both ends are
+// loaded before either is stored, so src may be dst. The vector paths do
+// the outer bytes and leave [lo, hi) to this
+inline void reverse8(const uint8_t *src,
+                     uint8_t *dst,
+                     size_t *lo,
+                     size_t *hi) {
+  while (*hi - *lo >= 16) {
+    const uint64_t front = load64(src + *lo);
+    const uint64_t back = load64(src + *hi - 8);
+    store64(dst + *lo, __builtin_bswap64(back));
+    store64(dst + *hi - 8, __builtin_bswap64(front));
+    *lo += 8;
+    *hi -= 8;
+  }
+  // The middle, at most 15 bytes
+  while (*hi - *lo >= 2) {
+    const uint8_t front = src[*lo];
+    const uint8_t back = src[*hi - 1];
+    dst[*lo] = back;
+    dst[*hi - 1] = front;
+    (*lo)++;
+    (*hi)--;
+  }
+  if (*hi - *lo == 1) {
+    dst[*lo] = src[*lo];
+  }
+}
+
+#ifdef TDI_ENDIANNESS_X86
+
+__attribute__((target("ssse3"))) inline __m128i reverse128(const __m128i &v) {
+  const __m128i shuffle =
+      _mm_set_epi8(0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15);
+  return _mm_shuffle_epi8(v, shuffle);
+}
+
+__attribute__((target("ssse3"))) void reverseSsse3(const size_t &size,
+                                                   const uint8_t *src,
+                                                   uint8_t *dst) {
+  size_t lo = 0;
+  size_t hi = size;
+  while (hi - lo >= 32) {
+    const __m128i front =
+        _mm_loadu_si128(reinterpret_cast<const __m128i *>(src + lo));
+    const __m128i back =
+        _mm_loadu_si128(reinterpret_cast<const __m128i *>(src + hi - 16));
+    _mm_storeu_si128(reinterpret_cast<__m128i *>(dst + lo), reverse128(back));
+    _mm_storeu_si128(reinterpret_cast<__m128i *>(dst + hi - 16),
+                     reverse128(front));
+    lo += 16;
+    hi -= 16;
+  }
+  reverse8(src, dst, &lo, &hi);
+}
+
+__attribute__((target("avx2"))) void reverseAvx2(const size_t &size,
+                                                 const uint8_t *src,
+                                                 uint8_t *dst) {
+  // Reverses within each 128 bit lane, the lanes are swapped after
+  const __m256i shuffle = _mm256_set_epi8(0, 1, 2, 3, 4, 5, 6, 7,
+                                          8, 9, 10, 11, 12, 13, 14, 15,
+                                          0, 1, 2, 3, 4, 5, 6, 7,
+                                          8, 9, 10, 11, 12, 13, 14, 15);
+  size_t lo = 0;
+  size_t hi = size;
+  while (hi - lo >= 64) {
+    __m256i front =
+        _mm256_loadu_si256(reinterpret_cast<const __m256i *>(src + lo));
+    __m256i back =
+        _mm256_loadu_si256(reinterpret_cast<const __m256i *>(src + hi - 32));
+    front = _mm256_permute2x128_si256(
+        _mm256_shuffle_epi8(front, shuffle), front, 0x01);
+    back = _mm256_permute2x128_si256(
+        _mm256_shuffle_epi8(back, shuffle), back, 0x01);
+    _mm256_storeu_si256(reinterpret_cast<__m256i *>(dst + lo), back);
+    _mm256_storeu_si256(reinterpret_cast<__m256i *>(dst + hi - 32), front);
+    lo += 32;
+    hi -= 32;
+  }
+  reverse8(src, dst, &lo, &hi);
+}
+
+__attribute__((target("ssse3"))) void reverse16BatchSsse3(const size_t &count,
+                                                           const uint8_t *src,
+                                                           uint8_t *dst) {
+  for (size_t i = 0; i < count; i++) {
+    const __m128i v =
+        _mm_loadu_si128(reinterpret_cast<const __m128i *>(src + 16 * i));
+    _mm_storeu_si128(reinterpret_cast<__m128i *>(dst + 16 * i),
+                     reverse128(v));
+  }
+}
+
+__attribute__((target("avx2"))) void reverse16BatchAvx2(const size_t &count,
+                                                        const uint8_t *src,
+                                                        uint8_t *dst) {
+  // Two 16 byte fields per register, each in its own lane
+  const __m256i shuffle = _mm256_set_epi8(0, 1, 2, 3, 4, 5, 6, 7,
+                                          8, 9, 10, 11, 12, 13, 14, 15,
+                                          0, 1, 2, 3, 4, 5, 6, 7,
+                                          8, 9, 10, 11, 12, 13, 14, 15);
+  size_t i = 0;
+  for (; i + 2 <= count; i += 2) {
+    const __m256i v =
+        _mm256_loadu_si256(reinterpret_cast<const __m256i *>(src + 16 * i));
+    _mm256_storeu_si256(reinterpret_cast<__m256i *>(dst + 16 * i),
+                        _mm256_shuffle_epi8(v, shuffle));
+  }
+  if (i < count) {
+    reverse16BatchSsse3(count - i, src + 16 * i, dst + 16 * i);
+  }
+}
+
+// Picked once from the CPU we run on
+enum class SimdLevel { NONE, SSSE3, AVX2 };
+
+SimdLevel simdLevelGet() {
+  static const SimdLevel level = []() {
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("avx2")) return SimdLevel::AVX2;
+    if (__builtin_cpu_supports("ssse3")) return SimdLevel::SSSE3;
+    return SimdLevel::NONE;
+  }();
+  return level;
+}
+
+#endif  // TDI_ENDIANNESS_X86
+
+void reverse(const size_t &size, const uint8_t *src, uint8_t *dst) {
+#ifdef TDI_ENDIANNESS_X86
+  // Below 32 bytes the vector paths only add a dispatch
+  if (size >= 32) {
+    switch (simdLevelGet()) {
+      case SimdLevel::AVX2:
+        reverseAvx2(size, src, dst);
+        return;
+      case SimdLevel::SSSE3:
+        reverseSsse3(size, src, dst);
+        return;
+      default:
+        break;
+    }
+  }
+#endif
+  size_t lo = 0;
+  size_t hi = size;
+  reverse8(src, dst, &lo, &hi);
+}
+
+void reverseBatch(const size_t &size,
+                  const size_t &count,
+                  const uint8_t *src,
+                  uint8_t *dst) {
+  switch (size) {
+    case 0:
+      return;
+    case 1:
+      if (src != dst) std::memcpy(dst, src, count);
+      return;
+    case 2:
+      for (size_t i = 0; i < count; i++) {
+        uint16_t v;
+        std::memcpy(&v, src + 2 * i, 2);
+        v = __builtin_bswap16(v);
+        std::memcpy(dst + 2 * i, &v, 2);
+      }
+      return;
+    case 4:
+      for (size_t i = 0; i < count; i++) {
+        uint32_t v;
+        std::memcpy(&v, src + 4 * i, 4);
+        v = __builtin_bswap32(v);
+        std::memcpy(dst + 4 * i, &v, 4);
+      }
+      return;
+    case 8:
+      for (size_t i = 0; i < count; i++) {
+        store64(dst + 8 * i, __builtin_bswap64(load64(src + 8 * i)));
+      }
+      return;
+#ifdef TDI_ENDIANNESS_X86
+    case 16:
+      switch (simdLevelGet()) {
+        case SimdLevel::AVX2:
+          reverse16BatchAvx2(count, src, dst);
+          return;
+        case SimdLevel::SSSE3:
+          reverse16BatchSsse3(count, src, dst);
+          return;
+        default:
+          break;
+      }
+      break;
+#endif
+    default:
+      break;
+  }
+  for (size_t i = 0; i < count; i++) {
+    reverse(size, src + size * i, dst + size * i);
+  }
+}
+
+inline void copy(const size_t &size, const uint8_t *src, uint8_t *dst) {
+  if (src != dst) std::memcpy(dst, src, size);
+}
+
+}  // anonymous namespace
+
+void TdiEndiannessHandler::toHostOrder(const size_t &size,
+                                       const uint8_t *value_ptr,
+                                       uint8_t *out_data) {
+  if (kSwap) {
+    reverse(size, value_ptr, out_data);
+  } else {
+    copy(size, value_ptr, out_data);
+  }
+}
+
+void TdiEndiannessHandler::toNetworkOrder(const size_t &size,
+                                          const uint8_t *value_ptr,
+                                          uint8_t *out_data) {
+  // Byte order conversion is its own inverse
+  toHostOrder(size, value_ptr, out_data);
+}
+
+void TdiEndiannessHandler::toHostOrderBatch(const size_t &size,
+                                            const size_t &count,
+                                            const uint8_t *value_ptr,
+                                            uint8_t *out_data) {
+  if (kSwap) {
+    reverseBatch(size, count, value_ptr, out_data);
+  } else {
+    copy(size * count, value_ptr, out_data);
+  }
+}
+
+void TdiEndiannessHandler::toNetworkOrderBatch(const size_t &size,
+                                               const size_t &count,
+                                               const uint8_t *value_ptr,
+                                               uint8_t *out_data) {
+  toHostOrderBatch(size, count, value_ptr, out_data);
+}
+
+void TdiEndiannessHandler::toHostOrderBatch(const size_t &size,
+                                            const size_t &count,
+                                            const uint8_t *value_ptr,
+                                            uint64_t *out_data) {
+  if (size > 8) {
+    LOG_ERROR(
+        "ERROR: %s:%d Trying to convert network order byte streams of more "
+        "than 8 bytes (%zu) into 64 bit data",
+        __func__,
+        __LINE__,
+        size);
+    TDI_DBGCHK(0);
+    return;
+  }
+  if (size == 8) {
+    for (size_t i = 0; i < count; i++) {
+      out_data[i] = be64toh(load64(value_ptr + 8 * i));
+    }
+    return;
+  }
+  for (size_t i = 0; i < count; i++) {
+    toHostOrder(size, value_ptr + size * i, &out_data[i]);
+  }
+}
+
+void TdiEndiannessHandler::toNetworkOrderBatch(const size_t &size,
+                                               const size_t &count,
+                                               const uint64_t *in_data,
+                                               uint8_t *value_ptr) {
+  if (size > 8) {
+    LOG_ERROR(
+        "ERROR: %s:%d Trying to convert 64 bit data into network order byte "
+        "streams of more than 8 bytes (%zu)",
+        __func__,
+        __LINE__,
+        size);
+    TDI_DBGCHK(0);
+    return;
+  }
+  if (size == 8) {
+    for (size_t i = 0; i < count; i++) {
+      store64(value_ptr + 8 * i, htobe64(in_data[i]));
+    }
+    return;
+  }
+  for (size_t i = 0; i < count; i++) {
+    toNetworkOrder(size, in_data[i], value_ptr + size * i);
+  }
+}
+
+}  // namespace tdi
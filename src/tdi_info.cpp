@@ -69,8 +69,8 @@ std::set<std::string> generateUniqueNames(const std::string &obj_name) {
   return full_name_list;
 }
 
-/* @brief This function converts a nameMap to a fullNameMap. A fullNameMap is a
- *mapping of
+/* @brief This function converts a nameMap to a fullNameIndex. A fullNameIndex
+ * is a mapping of
  * all possible names of a table entity to the table object's raw pointer.
  *
  * pipe0.SI.forward = <forward_table_1>
@@ -86,7 +86,8 @@ std::set<std::string> generateUniqueNames(const std::string &obj_name) {
 template <typename T>
 void populateFullNameMap(
     const std::map<std::string, std::unique_ptr<T>> &nameMap,
-    std::map<std::string, const T *> *fullNameMap) {
+    NameIndex<T> *fullNameIndex) {
+  std::map<std::string, const T *> full_name_map;
   std::set<std::string> names_to_remove;
   // We need to trim the possible names down since all are not possible.
   // Loop over all the tables
@@ -100,18 +101,20 @@ void populateFullNameMap(
     // then add them to the map. Else, just mark this name in a set kept to
     // remove these later
     for (const auto &prospective_name : possible_name_list) {
-      if ((*fullNameMap).find(prospective_name) != (*fullNameMap).end()) {
+      if (full_name_map.find(prospective_name) != full_name_map.end()) {
         names_to_remove.insert(prospective_name);
       } else {
-        (*fullNameMap)[prospective_name] = name_pair.second.get();
+        full_name_map[prospective_name] = name_pair.second.get();
       }
     }
   }
 
   // Remove the marked names from the map as well.
   for (const auto &name : names_to_remove) {
-    (*fullNameMap).erase(name);
+    full_name_map.erase(name);
   }
+  fullNameIndex->build(std::vector<std::pair<std::string, const T *>>(
+      full_name_map.begin(), full_name_map.end()));
 }
 
 }  // anonymous namespace
@@ -121,8 +124,30 @@ std::unique_ptr<const TdiInfo> TdiInfo::makeTdiInfo(
     std::unique_ptr<TdiInfoParser> tdi_info_parser,
     const tdi::TableFactory *factory) {
   try {
+    std::unique_ptr<const TdiInfo> tdi_info(new TdiInfo(
+        p4_name, std::move(tdi_info_parser), factory, nullptr, false, nullptr));
+    return tdi_info;
+  } catch (...) {
+    LOG_ERROR("%s:%d Failed to create TdiInfo", __func__, __LINE__);
+    return nullptr;
+  }
+}
+
+std::unique_ptr<const TdiInfo> TdiInfo::makeTdiInfo(
+    const std::string &p4_name,
+    std::unique_ptr<TdiInfoParser> tdi_info_parser,
+    std::unique_ptr<const tdi::TableFactory> factory,
+    const bool &lazy_tables,
+    const TdiInfo *prev_tdi_info) {
+  try {
+    const tdi::TableFactory *factory_ptr = factory.get();
     std::unique_ptr<const TdiInfo> tdi_info(
-        new TdiInfo(p4_name, std::move(tdi_info_parser), factory));
+        new TdiInfo(p4_name,
+                    std::move(tdi_info_parser),
+                    factory_ptr,
+                    std::move(factory),
+                    lazy_tables,
+                    prev_tdi_info));
     return tdi_info;
   } catch (...) {
     LOG_ERROR("%s:%d Failed to create TdiInfo", __func__, __LINE__);
@@ -132,18 +157,60 @@ std::unique_ptr<const TdiInfo> TdiInfo::makeTdiInfo(
 
 TdiInfo::TdiInfo(const std::string &p4_name,
                  std::unique_ptr<TdiInfoParser> tdi_info_parser,
-                 const tdi::TableFactory *factory)
-    : p4_name_(p4_name), tdi_info_parser_(std::move(tdi_info_parser)) {
+                 const tdi::TableFactory *factory,
+                 std::unique_ptr<const tdi::TableFactory> owned_factory,
+                 const bool &lazy_tables,
+                 const TdiInfo *prev_tdi_info)
+    : p4_name_(p4_name),
+      tdi_info_parser_(std::move(tdi_info_parser)),
+      lazy_tables_(lazy_tables),
+      owned_factory_(std::move(owned_factory)),
+      factory_(factory) {
   // Go over all table_info and learn_info in the parser object and
   // create Table and Learn objects for them
+  size_t num_carried = 0;
   for (const auto &kv : tdi_info_parser_->tableInfoMapGet()) {
+    // On a reload, tables whose schema did not change take over the state
+    // of the previous table
+    const tdi::Table *prev_table =
+        prevTableGet(prev_tdi_info, kv.first, kv.second.get());
+    if (prev_table) num_carried++;
+    if (lazy_tables_) {
+      // Only the names and IDs are set up, the factory is called on first
+      // lookup
+      const TableInfo *table_info = kv.second.get();
+      if (!table_info) {
+        LOG_ERROR("%s:%d Error creating Table:%s",
+                  __func__,
+                  __LINE__,
+                  kv.first.c_str());
+        continue;
+      }
+      std::unique_ptr<LazyTable> lazy_table(
+          new LazyTable(kv.first, table_info));
+      if (lazyTableIdMap.find(table_info->idGet()) != lazyTableIdMap.end()) {
+        LOG_ERROR("%s:%d Table:%s ID %d Already exists",
+                  __func__,
+                  __LINE__,
+                  kv.first.c_str(),
+                  table_info->idGet());
+      } else {
+        lazyTableIdMap[table_info->idGet()] = lazy_table.get();
+      }
+      // A table which was in use before stays in use, create it now
+      if (prev_table) tableMaterialize(*lazy_table, prev_table);
+      lazyTableMap[kv.first] = std::move(lazy_table);
+      continue;
+    }
     if (tableMap.find(kv.first) != tableMap.end()) {
       LOG_ERROR("%s:%d Table:%s Already exists",
                 __func__,
                 __LINE__,
                 kv.first.c_str());
     } else {
-      auto table = factory->makeTable(this, kv.second.get());
+      auto table =
+          prev_table ? factory->remakeTable(this, kv.second.get(), prev_table)
+                     : factory->makeTable(this, kv.second.get());
       if (!table) {
         LOG_ERROR("%s:%d Error creating Table:%s",
                   __func__,
@@ -163,7 +230,19 @@ TdiInfo::TdiInfo(const std::string &p4_name,
       tableMap[kv.first] = std::move(table);
     }
   }
-  populateFullNameMap<tdi::Table>(tableMap, &fullTableMap);
+  if (lazy_tables_) {
+    populateFullNameMap<LazyTable>(lazyTableMap, &fullLazyTableIndex);
+  } else {
+    populateFullNameMap<tdi::Table>(tableMap, &fullTableIndex);
+  }
+  if (prev_tdi_info) {
+    LOG_DBG("%s:%d Program %s reloaded, %zu of %zu tables unchanged",
+            __func__,
+            __LINE__,
+            p4_name_.c_str(),
+            num_carried,
+            tdi_info_parser_->tableInfoMapGet().size());
+  }
 
   // Creating Learn
   for (const auto &kv : tdi_info_parser_->learnInfoMapGet()) {
@@ -194,7 +273,54 @@ TdiInfo::TdiInfo(const std::string &p4_name,
       learnMap[kv.first] = std::move(learn);
     }
   }
-  populateFullNameMap<tdi::Learn>(learnMap, &fullLearnMap);
+  populateFullNameMap<tdi::Learn>(learnMap, &fullLearnIndex);
+}
+
+const tdi::Table *TdiInfo::prevTableGet(const TdiInfo *prev_tdi_info,
+                                        const std::string &name,
+                                        const TableInfo *table_info) {
+  if (!prev_tdi_info || !table_info) return nullptr;
+  const tdi::Table *prev_table = nullptr;
+  {
+    // A lazy TdiInfo may be adding tables concurrently. Its tables not
+    // created yet have no state to carry over
+    std::lock_guard<std::mutex> lock(prev_tdi_info->table_map_mtx_);
+    auto it = prev_tdi_info->tableMap.find(name);
+    if (it == prev_tdi_info->tableMap.end()) return nullptr;
+    prev_table = it->second.get();
+  }
+  if (!prev_table || !prev_table->tableInfoGet()->schemaEqual(*table_info)) {
+    return nullptr;
+  }
+  return prev_table;
+}
+
+const tdi::Table *TdiInfo::tableMaterialize(
+    const LazyTable &lazy_table, const tdi::Table *prev_table) const {
+  std::call_once(lazy_table.once, [this, &lazy_table, prev_table]() {
+    auto table = prev_table ? factory_->remakeTable(
+                                  this, lazy_table.table_info, prev_table)
+                            : factory_->makeTable(this, lazy_table.table_info);
+    if (!table) {
+      LOG_ERROR("%s:%d Error creating Table:%s",
+                __func__,
+                __LINE__,
+                lazy_table.name.c_str());
+      return;
+    }
+    lazy_table.table = table.get();
+    std::lock_guard<std::mutex> lock(table_map_mtx_);
+    tableMap[lazy_table.name] = std::move(table);
+  });
+  return lazy_table.table;
+}
+
+void TdiInfo::tablesMaterialize() const {
+  // Once every table has gone through its once_flag, tableMap does not
+  // change anymore and can be read without the lock
+  for (const auto &kv : lazyTableMap) {
+    tableMaterialize(*kv.second);
+  }
 }
 
 tdi_status_t TdiInfo::tablesGet(
@@ -203,6 +329,9 @@ tdi_status_t TdiInfo::tablesGet(
     LOG_ERROR("%s:%d nullptr arg passed", __func__, __LINE__);
     return TDI_INVALID_ARG;
   }
+  if (lazy_tables_) {
+    tablesMaterialize();
+  }
   for (auto const &item : tableMap) {
     table_vec_ret->push_back(item.second.get());
   }
@@ -218,18 +347,40 @@ tdi_status_t TdiInfo::tableFromNameGet(const std::string &name,
               name.c_str());
     return TDI_INVALID_ARG;
   }
-  auto it = this->fullTableMap.find(name);
-  if (it == this->fullTableMap.end()) {
+  if (lazy_tables_) {
+    auto lazy_table = this->fullLazyTableIndex.find(name);
+    auto table = lazy_table ? tableMaterialize(*lazy_table) : nullptr;
+    if (table == nullptr) {
+      LOG_ERROR(
+          "%s:%d Table \"%s\" not found", __func__, __LINE__, name.c_str());
+      return TDI_OBJECT_NOT_FOUND;
+    }
+    *table_ret = table;
+    return TDI_SUCCESS;
+  }
+  auto table = this->fullTableIndex.find(name);
+  if (table == nullptr) {
     LOG_ERROR("%s:%d Table \"%s\" not found", __func__, __LINE__, name.c_str());
     return TDI_OBJECT_NOT_FOUND;
   } else {
-    *table_ret = it->second;
+    *table_ret = table;
     return TDI_SUCCESS;
   }
 }
 
 tdi_status_t TdiInfo::tableFromIdGet(const tdi_id_t &id,
                                      const Table **table_ret) const {
+  if (lazy_tables_) {
+    auto it = lazyTableIdMap.find(id);
+    auto table =
+        it != lazyTableIdMap.end() ? tableMaterialize(*it->second) : nullptr;
+    if (table == nullptr) {
+      LOG_ERROR("%s:%d Table_id \"%d\" not found", __func__, __LINE__, id);
+      return TDI_OBJECT_NOT_FOUND;
+    }
+    *table_ret = table;
+    return TDI_SUCCESS;
+  }
   auto it = tableIdMap.find(id);
   if (it == tableIdMap.end()) {
     LOG_ERROR("%s:%d Table_id \"%d\" not found", __func__, __LINE__, id);
@@ -254,12 +405,13 @@ tdi_status_t TdiInfo::learnsGet(
 
 tdi_status_t TdiInfo::learnFromNameGet(std::string name,
                                        const Learn **learn_ret) const {
-  if (this->fullLearnMap.find(name) == this->fullLearnMap.end()) {
+  auto learn = this->fullLearnIndex.find(name);
+  if (learn == nullptr) {
     LOG_ERROR(
         "%s:%d Learn Obj \"%s\" not found", __func__, __LINE__, name.c_str());
     return TDI_OBJECT_NOT_FOUND;
   }
-  *learn_ret = this->fullLearnMap.at(name);
+  *learn_ret = learn;
   return TDI_SUCCESS;
 }
 
@@ -277,6 +429,9 @@ tdi_status_t TdiInfo::learnFromIdGet(tdi_id_t id,
 
 const std::map<std::string, std::unique_ptr<tdi::Table>> &TdiInfo::tableMapGet()
     const {
+  if (lazy_tables_) {
+    tablesMaterialize();
+  }
   return tableMap;
 }
 
@@ -22,12 +22,26 @@
 
 namespace tdi {
 
-DevMgr *DevMgr::dev_mgr_instance = nullptr;
+std::atomic<DevMgr *> DevMgr::dev_mgr_instance{nullptr};
 std::mutex DevMgr::dev_mgr_instance_mutex;
+const tdi_dev_id_t DevMgr::kMaxDevices;
 
 tdi_status_t Device::tdiInfoGet(const std::string &prog_name,
                                 const TdiInfo **tdi_info) const {
-  if (this->tdi_info_map_.find(prog_name) == this->tdi_info_map_.end()) {
+  std::shared_ptr<const TdiInfo> tdi_info_ref;
+  auto status = this->tdiInfoGet(prog_name, &tdi_info_ref);
+  if (status != TDI_SUCCESS) {
+    return status;
+  }
+  *tdi_info = tdi_info_ref.get();
+  return TDI_SUCCESS;
+}
+
+tdi_status_t Device::tdiInfoGet(
+    const std::string &prog_name,
+    std::shared_ptr<const TdiInfo> *tdi_info) const {
+  auto it = this->tdi_info_map_.find(prog_name);
+  if (it == this->tdi_info_map_.end()) {
     LOG_ERROR("%s:%d TDI Info Object not found for dev : %d",
               __func__,
               __LINE__,
@@ -35,7 +49,56 @@ tdi_status_t Device::tdiInfoGet(const std::string &prog_name,
     return TDI_OBJECT_NOT_FOUND;
   }
 
-  *tdi_info = this->tdi_info_map_.at(prog_name).get();
+  *tdi_info = std::atomic_load(&it->second);
+  return TDI_SUCCESS;
+}
+
+tdi_status_t Device::programReload(const tdi::ProgramConfig &program_config) {
+  auto it = this->tdi_info_map_.find(program_config.prog_name_);
+  if (it == this->tdi_info_map_.end()) {
+    LOG_ERROR("%s:%d Program %s not found for dev : %d",
+              __func__,
+              __LINE__,
+              program_config.prog_name_.c_str(),
+              this->device_id_);
+    return TDI_OBJECT_NOT_FOUND;
+  }
+  std::lock_guard<std::mutex> lock(reload_mtx_);
+  // Readers go on with prev_tdi_info while the new one is built
+  std::shared_ptr<const TdiInfo> prev_tdi_info = std::atomic_load(&it->second);
+  std::unique_ptr<const TdiInfo> tdi_info;
+  auto status =
+      this->tdiInfoCreate(program_config, prev_tdi_info.get(), &tdi_info);
+  if (status != TDI_SUCCESS || !tdi_info) {
+    LOG_ERROR("%s:%d Failed to reload program %s for dev : %d",
+              __func__,
+              __LINE__,
+              program_config.prog_name_.c_str(),
+              this->device_id_);
+    return status != TDI_SUCCESS ? status : TDI_UNEXPECTED;
+  }
+  std::atomic_store(&it->second,
+                    std::shared_ptr<const TdiInfo>(std::move(tdi_info)));
+  if (prev_tdi_info) {
+    retired_tdi_infos_.push_back(std::move(prev_tdi_info));
+  }
+  return TDI_SUCCESS;
+}
+
+std::future<tdi_status_t> Device::programReloadAsync(
+    const tdi::ProgramConfig &program_config) {
+  return std::async(std::launch::async, [this, program_config]() {
+    return this->programReload(program_config);
+  });
+}
+
+tdi_status_t Device::tdiInfoRetiredRelease() {
+  std::vector<std::shared_ptr<const TdiInfo>> retired;
+  {
+    std::lock_guard<std::mutex> lock(reload_mtx_);
+    retired.swap(retired_tdi_infos_);
+  }
+  // Destroyed here, or by the last holder of a reference
   return TDI_SUCCESS;
 }
 
@@ -70,28 +133,53 @@ tdi_status_t Device::createFlags(const uint64_t &flags_val,
   return TDI_SUCCESS;
 }
 
+DevMgr::DevMgr() {}
+
 DevMgr &DevMgr::getInstance() {
-  if (dev_mgr_instance == nullptr) {
-    dev_mgr_instance_mutex.lock();
-    if (dev_mgr_instance == nullptr) {
-      dev_mgr_instance = new DevMgr();
+  // The acquire pairs with the release below, so a thread that sees the
+  // pointer also sees the constructed DevMgr
+  DevMgr *instance = dev_mgr_instance.load(std::memory_order_acquire);
+  if (instance == nullptr) {
+    std::lock_guard<std::mutex> lock(dev_mgr_instance_mutex);
+    instance = dev_mgr_instance.load(std::memory_order_relaxed);
+    if (instance == nullptr) {
+      instance = new DevMgr();
+      dev_mgr_instance.store(instance, std::memory_order_release);
     }
-    dev_mgr_instance_mutex.unlock();
   }
-  return *(DevMgr::dev_mgr_instance);
+  return *instance;
 }
 
 tdi_status_t DevMgr::deviceGet(const tdi_dev_id_t &dev_id,
                                const tdi::Device **device) const {
-  if (this->dev_map_.find(dev_id) == this->dev_map_.end()) {
+  std::shared_ptr<const Device> dev;
+  auto status = this->deviceGet(dev_id, &dev);
+  if (status != TDI_SUCCESS) {
+    return status;
+  }
+  *device = dev.get();
+  return TDI_SUCCESS;
+}
+
+tdi_status_t DevMgr::deviceGet(
+    const tdi_dev_id_t &dev_id,
+    std::shared_ptr<const tdi::Device> *device) const {
+  if (device == nullptr) {
+    LOG_ERROR("%s:%d Please allocate space for out param", __func__, __LINE__);
+    return TDI_INVALID_ARG;
+  }
+  std::shared_ptr<const Device> dev;
+  if (dev_id < kMaxDevices) {
+    dev = std::atomic_load(&this->devices_[dev_id]);
+  }
+  if (dev == nullptr) {
     LOG_ERROR("%s:%d Device Object not found for dev : %d",
               __func__,
               __LINE__,
               dev_id);
     return TDI_OBJECT_NOT_FOUND;
   }
-
-  *device = this->dev_map_.at(dev_id).get();
+  *device = std::move(dev);
   return TDI_SUCCESS;
 }
 
@@ -101,18 +189,28 @@ tdi_status_t DevMgr::deviceIdListGet(
     LOG_ERROR("%s:%d Please allocate space for out param", __func__, __LINE__);
     return TDI_INVALID_ARG;
   }
-  for (const auto &pair : this->dev_map_) {
-    if ((*device_id_list).find(pair.first) == (*device_id_list).end()) {
-      (*device_id_list).insert(pair.first);
+  for (tdi_dev_id_t dev_id = 0; dev_id < kMaxDevices; dev_id++) {
+    if (std::atomic_load(&this->devices_[dev_id]) != nullptr) {
+      device_id_list->insert(dev_id);
     }
   }
   return TDI_SUCCESS;
 }
 
 tdi_status_t DevMgr::deviceRemove(const tdi_dev_id_t &dev_id) {
-
-  if (this->dev_map_.find(dev_id) != this->dev_map_.end())
-    this->dev_map_.erase(dev_id);
+  std::shared_ptr<Device> device;
+  {
+    std::lock_guard<std::mutex> lock(dev_map_mtx_);
+    auto it = this->dev_map_.find(dev_id);
+    if (it != this->dev_map_.end()) {
+      std::atomic_store(&this->devices_[dev_id],
+                        std::shared_ptr<const Device>());
+      device = std::move(it->second);
+      this->dev_map_.erase(it);
+    }
+  }
+  // Destroyed outside the lock, unless a reader still holds a reference
+  device.reset();
 
   LOG_DBG(
       "%s:%d  Device Remove called for dev : %d", __func__, __LINE__, dev_id);
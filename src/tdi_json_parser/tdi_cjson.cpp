@@ -25,6 +25,9 @@
 #include <tdi/common/tdi_json_parser/tdi_cjson.hpp>
 
 #include <target-sys/bf_sal/bf_sys_mem.h>
+#include <tdi/common/tdi_utils.hpp>
+
+#include "tdi_cjson_arena.hpp"
 
 namespace tdi {
 
@@ -34,7 +37,17 @@ CjsonObjHandler::CjsonObjHandler(const std::string &fileContent) {
     std::string error(cJSON_GetErrorPtr());
   }
 }
-CjsonObjHandler::~CjsonObjHandler() { cJSON_Delete(this->root); }
+CjsonObjHandler::CjsonObjHandler(std::unique_ptr<CjsonArena> arena)
+    : arena_(std::move(arena)) {
+  if (arena_) this->root = arena_->rootGet();
+}
+CjsonObjHandler::~CjsonObjHandler() {
+  // Arena nodes are freed with the arena
+  if (!arena_) cJSON_Delete(this->root);
+}
+bool CjsonObjHandler::exactValueGet(const cJSON *node, uint64_t *value) const {
+  return arena_ && CjsonArena::exactValueGet(node, value);
+}
 
 Cjson::Cjson(const Cjson &parent, const std::string &key) {
   root = cJSON_GetObjectItem(parent.root, key.c_str());
@@ -52,6 +65,14 @@ void Cjson::createCjsonFromFileInternal(const std::string &fileContent,
   obj.root = obj.cjson_mem_tracker->rootGet();
 }
 
+Cjson Cjson::createCjsonFromBuffer(const char *content, const size_t &len) {
+  Cjson obj;
+  obj.cjson_mem_tracker =
+      std::make_shared<CjsonObjHandler>(CjsonArena::parse(content, len));
+  obj.root = obj.cjson_mem_tracker->rootGet();
+  return obj;
+}
+
 Cjson::Cjson(const Cjson &parent, int &index) {
   root = cJSON_GetArrayItem(parent.root, index);
   this->cjson_mem_tracker = parent.cjson_mem_tracker;
@@ -78,29 +99,23 @@ std::string Cjson::getCjsonKey() const {
 
 std::vector<std::shared_ptr<Cjson>> Cjson::getCjsonChildVec() const {
   std::vector<std::shared_ptr<Cjson>> ret_vec;
-  if (root) {
-    int count = cJSON_GetArraySize(root);
-    if (count != 0) {
-      for (int i = 0; i < count; i++) {
-        ret_vec.push_back(std::make_shared<Cjson>(*this, i));
-      }
-    }
+  for (const auto &child : *this) {
+    ret_vec.push_back(std::make_shared<Cjson>(child));
   }
   return ret_vec;
 }
 std::vector<std::string> Cjson::getCjsonChildStringVec() const {
   std::vector<std::string> ret_vec;
-  if (root) {
-    int count = cJSON_GetArraySize(root);
-    if (count != 0) {
-      for (int i = 0; i < count; i++) {
-        ret_vec.push_back(std::string(Cjson(*this, i)));
-      }
-    }
+  for (const auto &child : *this) {
+    ret_vec.push_back(std::string(child));
   }
   return ret_vec;
 }
 void Cjson::addObject(const std::string &name, const Cjson &item) {
+  if (cjson_mem_tracker && cjson_mem_tracker->readOnly()) {
+    LOG_ERROR("%s:%d Cannot modify a read only document", __func__, __LINE__);
+    return;
+  }
   cJSON_AddItemReferenceToObject(this->root, name.c_str(), item.root);
 }
 
@@ -115,6 +130,11 @@ Cjson::operator int() const {
   }
 }
 Cjson::operator unsigned int() const {
+  uint64_t exact_value;
+  if (root && cjson_mem_tracker &&
+      cjson_mem_tracker->exactValueGet(root, &exact_value)) {
+    return static_cast<unsigned int>(exact_value);
+  }
   if (root && (root->type == cJSON_Number)) {
     // Hack.. We should be using the appropriate datatype
     // using double here only because cJSON trims int to
@@ -153,6 +173,11 @@ Cjson::operator bool() const {
 }
 
 Cjson::operator uint64_t() const {
+  uint64_t exact_value;
+  if (root && cjson_mem_tracker &&
+      cjson_mem_tracker->exactValueGet(root, &exact_value)) {
+    return exact_value;
+  }
   if (root && (root->type == cJSON_Number)) {
     // Hack.. We should be using the appropriate datatype
     // using double here only because cJSON trims int to
@@ -188,11 +213,19 @@ Cjson Cjson::operator[](const std::string &key) const {
   return (*this)[key.c_str()];
 }
 Cjson &Cjson::operator+=(const Cjson &other) {
+  if (cjson_mem_tracker && cjson_mem_tracker->readOnly()) {
+    LOG_ERROR("%s:%d Cannot modify a read only document", __func__, __LINE__);
+    return *this;
+  }
   cJSON_AddItemReferenceToArray(this->root, other.root);
   return *this;
 }
 
 void Cjson::updateChildNode(const std::string &key, const std::string &val) {
+  if (cjson_mem_tracker && cjson_mem_tracker->readOnly()) {
+    LOG_ERROR("%s:%d Cannot modify a read only document", __func__, __LINE__);
+    return;
+  }
   // remove key from this object(ex "name")
   cJSON_DeleteItemFromObject(this->root, key.c_str());
   // Now add a string object to this object with same key ("name")
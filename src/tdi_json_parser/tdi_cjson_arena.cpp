@@ -0,0 +1,329 @@
+/*
+ * Copyright(c) 2021 Intel Corporation.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this software except as stipulated in the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <climits>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+
+#include "tdi_cjson_arena.hpp"
+
+namespace tdi {
+
+namespace {
+
+inline int hexValue(const char &c) {
+  if (c >= '0' && c <= '9') return c - '0';
+  if (c >= 'a' && c <= 'f') return c - 'a' + 10;
+  if (c >= 'A' && c <= 'F') return c - 'A' + 10;
+  return -1;
+}
+
+inline bool isDigit(const char &c) { return c >= '0' && c <= '9'; }
+
+}  // anonymous namespace
+
+const size_t CjsonArena::kBlockSize;
+const size_t CjsonArena::kMaxDepth;
+
+std::unique_ptr<CjsonArena> CjsonArena::parse(const char *content,
+                                               const size_t &len) {
+  std::unique_ptr<CjsonArena> arena(new CjsonArena());
+  arena->pos_ = content;
+  arena->end_ = content + len;
+  arena->root_ = arena->valueParse(0);
+  if (!arena->root_) return nullptr;
+  // Like cJSON_Parse, anything after the root value is ignored
+  return arena;
+}
+
+bool CjsonArena::exactValueGet(const cJSON *node, uint64_t *value) {
+  const Node *arena_node = reinterpret_cast<const Node *>(node);
+  if (node->type != cJSON_Number || !arena_node->exact) return false;
+  *value = arena_node->exact_value;
+  return true;
+}
+
+void *CjsonArena::allocate(const size_t &size) {
+  // Keep every allocation aligned for Node
+  const size_t aligned = (size + alignof(Node) - 1) & ~(alignof(Node) - 1);
+  if (aligned > block_left_) {
+    const size_t block_size = aligned > kBlockSize ? aligned : kBlockSize;
+    blocks_.emplace_back(new char[block_size]);
+    block_pos_ = blocks_.back().get();
+    block_left_ = block_size;
+  }
+  void *ptr = block_pos_;
+  block_pos_ += aligned;
+  block_left_ -= aligned;
+  return ptr;
+}
+
+CjsonArena::Node *CjsonArena::nodeAllocate() {
+  Node *node = static_cast<Node *>(allocate(sizeof(Node)));
+  std::memset(node, 0, sizeof(Node));
+  return node;
+}
+
+void CjsonArena::whitespaceSkip() {
+  while (pos_ < end_ && static_cast<unsigned char>(*pos_) <= ' ') pos_++;
+}
+
+cJSON *CjsonArena::valueParse(const size_t &depth) {
+  whitespaceSkip();
+  if (pos_ >= end_ || depth > kMaxDepth) return nullptr;
+  const size_t left = end_ - pos_;
+  switch (*pos_) {
+    case '{':
+      return containerParse(depth, true);
+    case '[':
+      return containerParse(depth, false);
+    case '"': {
+      Node *node = nodeAllocate();
+      node->node.type = cJSON_String;
+      node->node.valuestring = stringParse();
+      return node->node.valuestring ? &node->node : nullptr;
+    }
+    case 't':
+      if (left >= 4 && !std::memcmp(pos_, "true", 4)) {
+        pos_ += 4;
+        Node *node = nodeAllocate();
+        node->node.type = cJSON_True;
+        node->node.valueint = 1;
+        return &node->node;
+      }
+      return nullptr;
+    case 'f':
+      if (left >= 5 && !std::memcmp(pos_, "false", 5)) {
+        pos_ += 5;
+        Node *node = nodeAllocate();
+        node->node.type = cJSON_False;
+        return &node->node;
+      }
+      return nullptr;
+    case 'n':
+      if (left >= 4 && !std::memcmp(pos_, "null", 4)) {
+        pos_ += 4;
+        Node *node = nodeAllocate();
+        node->node.type = cJSON_NULL;
+        return &node->node;
+      }
+      return nullptr;
+    default: {
+      Node *node = nodeAllocate();
+      return numberParse(node) ? &node->node : nullptr;
+    }
+  }
+}
+
+cJSON *CjsonArena::containerParse(const size_t &depth, const bool &object) {
+  const char close = object ? '}' : ']';
+  Node *container = nodeAllocate();
+  container->node.type = object ? cJSON_Object : cJSON_Array;
+  pos_++;
+  whitespaceSkip();
+  if (pos_ < end_ && *pos_ == close) {
+    pos_++;
+    return &container->node;
+  }
+  cJSON *last = nullptr;
+  while (true) {
+    char *key = nullptr;
+    if (object) {
+      whitespaceSkip();
+      if (pos_ >= end_ || *pos_ != '"') return nullptr;
+      key = stringParse();
+      if (!key) return nullptr;
+      whitespaceSkip();
+      if (pos_ >= end_ || *pos_ != ':') return nullptr;
+      pos_++;
+    }
+    cJSON *child = valueParse(depth + 1);
+    if (!child) return nullptr;
+    child->string = key;
+    if (last) {
+      last->next = child;
+      child->prev = last;
+    } else {
+      container->node.child = child;
+    }
+    last = child;
+    whitespaceSkip();
+    if (pos_ >= end_) return nullptr;
+    if (*pos_ == ',') {
+      pos_++;
+      continue;
+    }
+    if (*pos_ != close) return nullptr;
+    pos_++;
+    return &container->node;
+  }
+}
+
+char *CjsonArena::stringParse() {
+  // pos_ is on the opening quote
+  const char *start = ++pos_;
+  const char *quote = static_cast<const char *>(
+      std::memchr(start, '"', end_ - start));
+  if (!quote) return nullptr;
+  // Fast path, no escapes before the closing quote. memchr does the
+  // scanning a word or vector at a time
+  if (!std::memchr(start, '\\', quote - start)) {
+    const size_t len = quote - start;
+    char *out = static_cast<char *>(allocate(len + 1));
+    std::memcpy(out, start, len);
+    out[len] = '\0';
+    pos_ = quote + 1;
+    return out;
+  }
+
+  std::string decoded;
+  const char *p = start;
+  while (true) {
+    if (p >= end_) return nullptr;
+    const char c = *p++;
+    if (c == '"') break;
+    if (c != '\\') {
+      decoded.push_back(c);
+      continue;
+    }
+    if (p >= end_) return nullptr;
+    const char esc = *p++;
+    switch (esc) {
+      case 'b':
+        decoded.push_back('\b');
+        break;
+      case 'f':
+        decoded.push_back('\f');
+        break;
+      case 'n':
+        decoded.push_back('\n');
+        break;
+      case 'r':
+        decoded.push_back('\r');
+        break;
+      case 't':
+        decoded.push_back('\t');
+        break;
+      case 'u': {
+        uint32_t code = 0;
+        for (int i = 0; i < 4; i++) {
+          if (p >= end_ || hexValue(*p) < 0) return nullptr;
+          code = (code << 4) | hexValue(*p++);
+        }
+        // Surrogate pair
+        if (code >= 0xd800 && code <= 0xdbff && end_ - p >= 6 &&
+            p[0] == '\\' && p[1] == 'u') {
+          uint32_t low = 0;
+          bool valid = true;
+          for (int i = 2; i < 6; i++) {
+            if (hexValue(p[i]) < 0) {
+              valid = false;
+              break;
+            }
+            low = (low << 4) | hexValue(p[i]);
+          }
+          if (valid && low >= 0xdc00 && low <= 0xdfff) {
+            code = 0x10000 + (((code & 0x3ff) << 10) | (low & 0x3ff));
+            p += 6;
+          }
+        }
+        if (code < 0x80) {
+          decoded.push_back(static_cast<char>(code));
+        } else if (code < 0x800) {
+          decoded.push_back(static_cast<char>(0xc0 | (code >> 6)));
+          decoded.push_back(static_cast<char>(0x80 | (code & 0x3f)));
+        } else if (code < 0x10000) {
+          decoded.push_back(static_cast<char>(0xe0 | (code >> 12)));
+          decoded.push_back(static_cast<char>(0x80 | ((code >> 6) & 0x3f)));
+          decoded.push_back(static_cast<char>(0x80 | (code & 0x3f)));
+        } else {
+          decoded.push_back(static_cast<char>(0xf0 | (code >> 18)));
+          decoded.push_back(static_cast<char>(0x80 | ((code >> 12) & 0x3f)));
+          decoded.push_back(static_cast<char>(0x80 | ((code >> 6) & 0x3f)));
+          decoded.push_back(static_cast<char>(0x80 | (code & 0x3f)));
+        }
+        break;
+      }
+      default:
+        // \" \\ \/ and anything else stand for themselves
+        decoded.push_back(esc);
+        break;
+    }
+  }
+  char *out = static_cast<char *>(allocate(decoded.size() + 1));
+  std::memcpy(out, decoded.data(), decoded.size());
+  out[decoded.size()] = '\0';
+  pos_ = p;
+  return out;
+}
+
+bool CjsonArena::numberParse(Node *node) {
+  const char *p = pos_;
+  const bool negative = (p < end_ && *p == '-');
+  if (negative) p++;
+  if (p >= end_ || !isDigit(*p)) return false;
+  // Integer part, kept exactly while it fits
+  uint64_t magnitude = 0;
+  bool overflow = false;
+  for (; p < end_ && isDigit(*p); p++) {
+    const uint64_t digit = *p - '0';
+    if (magnitude > (UINT64_MAX - digit) / 10) overflow = true;
+    magnitude = magnitude * 10 + digit;
+  }
+  bool integer = true;
+  if (p < end_ && *p == '.') {
+    integer = false;
+    for (p++; p < end_ && isDigit(*p); p++) {
+    }
+  }
+  if (p < end_ && (*p == 'e' || *p == 'E')) {
+    integer = false;
+    p++;
+    if (p < end_ && (*p == '+' || *p == '-')) p++;
+    for (; p < end_ && isDigit(*p); p++) {
+    }
+  }
+
+  double value;
+  if (integer && magnitude <= (1ULL << 53)) {
+    // Exactly representable, so this is what strtod would give
+    value = negative ? -static_cast<double>(magnitude)
+                     : static_cast<double>(magnitude);
+  } else {
+    // strtod needs a terminated string, and gives the same double as cJSON
+    const std::string literal(pos_, p - pos_);
+    value = std::strtod(literal.c_str(), nullptr);
+  }
+  node->node.type = cJSON_Number;
+  node->node.valuedouble = value;
+  if (value >= INT_MAX) {
+    node->node.valueint = INT_MAX;
+  } else if (value <= INT_MIN) {
+    node->node.valueint = INT_MIN;
+  } else {
+    node->node.valueint = static_cast<int>(value);
+  }
+  if (integer && !overflow &&
+      (!negative || magnitude <= static_cast<uint64_t>(INT64_MAX) + 1)) {
+    node->exact = true;
+    node->exact_value = negative ? (~magnitude + 1) : magnitude;
+  }
+  pos_ = p;
+  return true;
+}
+
+}  // namespace tdi
@@ -0,0 +1,90 @@
+/*
+ * Copyright(c) 2021 Intel Corporation.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this software except as stipulated in the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+/** @file tdi_cjson_arena.hpp
+ *
+ *  @brief Contains the arena backed JSON reader used to load TDI schemas
+ */
+#ifndef _TDI_CJSON_ARENA_HPP
+#define _TDI_CJSON_ARENA_HPP
+
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+#include <target-utils/third-party/cJSON/cJSON.h>
+
+namespace tdi {
+
+/**
+ * @brief Read only JSON document whose nodes live in a few large blocks.
+ *
+ * The reader builds the same cJSON node layout as cJSON_Parse, so Cjson
+ * reads it unchanged, but it allocates by bumping a pointer and frees all
+ * nodes at once. Integer literals are also kept exactly, up to 64 bits,
+ * next to the double that cJSON would hold.
+ */
+class CjsonArena {
+ public:
+  /**
+   * @brief Parse a buffer, which need not be NUL terminated
+   *
+   * @return The document. nullptr if the buffer is not valid JSON
+   */
+  static std::unique_ptr<CjsonArena> parse(const char *content,
+                                           const size_t &len);
+
+  cJSON *rootGet() const { return root_; };
+
+  /**
+   * @brief Get the exact value of an integer node of this document
+   *
+   * @return false if the node is not an integer literal that fits in 64 bits
+   */
+  static bool exactValueGet(const cJSON *node, uint64_t *value);
+
+ private:
+  // cJSON must stay first, nodes are handed out as cJSON *
+  struct Node {
+    cJSON node;
+    uint64_t exact_value;
+    bool exact;
+  };
+
+  CjsonArena() = default;
+  void *allocate(const size_t &size);
+  Node *nodeAllocate();
+
+  // Recursive descent over [pos_, end_). Each returns nullptr on error
+  cJSON *valueParse(const size_t &depth);
+  cJSON *containerParse(const size_t &depth, const bool &object);
+  char *stringParse();
+  bool numberParse(Node *node);
+  void whitespaceSkip();
+
+  static const size_t kBlockSize = 64 * 1024;
+  static const size_t kMaxDepth = 512;
+
+  std::vector<std::unique_ptr<char[]>> blocks_;
+  char *block_pos_{nullptr};
+  size_t block_left_{0};
+  const char *pos_{nullptr};
+  const char *end_{nullptr};
+  cJSON *root_{nullptr};
+};
+
+}  // namespace tdi
+
+#endif  // _TDI_CJSON_ARENA_HPP
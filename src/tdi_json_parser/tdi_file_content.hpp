@@ -0,0 +1,82 @@
+/*
+ * Copyright(c) 2021 Intel Corporation.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this software except as stipulated in the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+/** @file tdi_file_content.hpp
+ *
+ *  @brief Contains a read only view of a file used by the schema loaders
+ */
+#ifndef _TDI_FILE_CONTENT_HPP
+#define _TDI_FILE_CONTENT_HPP
+
+#include <fstream>
+#include <iterator>
+#include <string>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace tdi {
+
+// Read only view of a whole file. The file is mapped when possible and read
+// into memory otherwise
+class FileContent {
+ public:
+  explicit FileContent(const std::string &path) {
+    int fd = open(path.c_str(), O_RDONLY);
+    if (fd < 0) return;
+    struct stat st;
+    if (fstat(fd, &st) == 0 && S_ISREG(st.st_mode) && st.st_size > 0) {
+      void *addr = mmap(nullptr, st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+      if (addr != MAP_FAILED) {
+        map_addr_ = addr;
+        map_len_ = st.st_size;
+        madvise(addr, map_len_, MADV_SEQUENTIAL);
+      }
+    }
+    close(fd);
+    if (map_addr_) {
+      valid_ = true;
+      return;
+    }
+    std::ifstream file(path);
+    if (file.fail()) return;
+    buffer_.assign((std::istreambuf_iterator<char>(file)),
+                   std::istreambuf_iterator<char>());
+    valid_ = true;
+  };
+  ~FileContent() {
+    if (map_addr_) munmap(map_addr_, map_len_);
+  };
+  FileContent(const FileContent &) = delete;
+  FileContent &operator=(const FileContent &) = delete;
+
+  bool valid() const { return valid_; };
+  const char *data() const {
+    return map_addr_ ? static_cast<const char *>(map_addr_) : buffer_.data();
+  };
+  size_t size() const { return map_addr_ ? map_len_ : buffer_.size(); };
+
+ private:
+  bool valid_{false};
+  void *map_addr_{nullptr};
+  size_t map_len_{0};
+  std::string buffer_;
+};
+
+}  // namespace tdi
+
+#endif  // _TDI_FILE_CONTENT_HPP
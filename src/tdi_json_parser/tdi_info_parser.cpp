@@ -14,11 +14,13 @@
  * limitations under the License.
  */
 
+#include <algorithm>
 #include <exception>
 #include <fstream>
 #include <iostream>
 #include <memory>
 #include <regex>
+#include <thread>
 
 #include <tdi/common/tdi_info.hpp>
 #include <tdi/common/tdi_json_parser/tdi_info_parser.hpp>
@@ -26,10 +28,24 @@
 #include <tdi/common/tdi_utils.hpp>
 #include <tdi/common/tdi_json_parser/tdi_cjson.hpp>
 
+#include "tdi_file_content.hpp"
+#include "tdi_schema_cache.hpp"
+
 namespace tdi {
 
 namespace {
 
+// Run fn(0) .. fn(count - 1) on the pool and wait for all of them, or
+// inline without a pool
+template <typename F>
+void parallelFor(TdiThreadPool *thread_pool, const size_t &count, F fn) {
+  if (!thread_pool || count < 2) {
+    for (size_t i = 0; i < count; i++) fn(i);
+    return;
+  }
+  thread_pool->parallelFor(0, count, fn);
+}
+
 tdi_field_data_type_e dataTypeStrToEnum(const std::string &type,
                                         const bool &repeated) {
   if (type == "bytes") {
@@ -59,9 +75,9 @@ tdi_field_data_type_e dataTypeStrToEnum(const std::string &type,
 // This function returns if a key field is a field slice or not
 bool checkIsFieldSlice(const tdi::Cjson &key_field) {
   tdi::Cjson key_annotations = key_field["annotations"];
-  for (const auto &annotation : key_annotations.getCjsonChildVec()) {
-    std::string annotation_name = (*annotation)["name"];
-    std::string annotation_value = (*annotation)["value"];
+  for (const auto &annotation : key_annotations) {
+    std::string annotation_name = annotation["name"];
+    std::string annotation_value = annotation["value"];
     if ((annotation_name == "isFieldSlice") && (annotation_value == "true")) {
       return true;
     }
@@ -71,8 +87,10 @@ bool checkIsFieldSlice(const tdi::Cjson &key_field) {
 
 }  // anonymous namespace
 
-TdiInfoParser::TdiInfoParser(std::unique_ptr<TdiInfoMapper> tdi_info_mapper)
-    : tdi_info_mapper_(std::move(tdi_info_mapper)) {}
+TdiInfoParser::TdiInfoParser(std::unique_ptr<TdiInfoMapper> tdi_info_mapper,
+                             const size_t &parse_threads)
+    : tdi_info_mapper_(std::move(tdi_info_mapper)),
+      parse_threads_(parse_threads) {}
 
 tdi_table_type_e TdiInfoParser::tableTypeStrToEnum(const std::string &type) {
   if (tdi_info_mapper_->tableEnumMapGet().find(type) !=
@@ -141,8 +159,8 @@ void TdiInfoParser::parseFieldWidth(const tdi::Cjson &node,
     }
   } else if (type_str == "string") {
     width = 0;
-    for (const auto &choice : node["type"]["choices"].getCjsonChildVec()) {
-      choices.push_back(static_cast<std::string>(*choice));
+    for (const auto &choice : node["type"]["choices"]) {
+      choices.push_back(static_cast<std::string>(choice));
     }
     // If string default value is listed populate it, else its empty
     if (node["type"]["default_value"].exists()) {
@@ -176,8 +194,8 @@ std::unique_ptr<KeyFieldInfo> TdiInfoParser::parseKeyField(
       matchTypeStrToEnum(table_key_cjson[tdi_json::TABLE_KEY_MATCH_TYPE]);
   tdi_field_data_type_e field_data_type;
   size_t width;
-  uint64_t default_value;
-  float default_fl_value;
+  uint64_t default_value = 0;
+  float default_fl_value = 0;
   std::string default_str_value;
   std::vector<std::string> choices;
   std::string data_type;
@@ -224,9 +242,9 @@ std::unique_ptr<KeyFieldInfo> TdiInfoParser::parseKeyField(
 std::set<tdi::Annotation> TdiInfoParser::parseAnnotations(
     const tdi::Cjson &annotation_cjson) {
   std::set<tdi::Annotation> annotations;
-  for (const auto &annotation : annotation_cjson.getCjsonChildVec()) {
-    std::string annotation_name = (*annotation)["name"];
-    std::string annotation_value = (*annotation)["value"];
+  for (const auto &annotation : annotation_cjson) {
+    std::string annotation_name = annotation["name"];
+    std::string annotation_value = annotation["value"];
     annotations.emplace(annotation_name, annotation_value);
   }
   return annotations;
@@ -250,8 +268,8 @@ std::unique_ptr<struct DataFieldInfo> TdiInfoParser::parseDataField(
   std::set<tdi_id_t> oneof_siblings;
   if (data_json["oneof"].exists()) {
     // Create a set of all the oneof members IDs
-    for (const auto &oneof_data : data_json["oneof"].getCjsonChildVec()) {
-      oneof_siblings.insert(static_cast<tdi_id_t>((*oneof_data)["id"]));
+    for (const auto &oneof_data : data_json["oneof"]) {
+      oneof_siblings.insert(static_cast<tdi_id_t>(oneof_data["id"]));
     }
     data_json = data_json["oneof"][oneof_index];
     // remove this field's ID from the siblings. One
@@ -265,8 +283,8 @@ std::unique_ptr<struct DataFieldInfo> TdiInfoParser::parseDataField(
   std::vector<std::string> choices;
   // Default value of the field. We currently only support listing upto 64 bits
   // of default value
-  uint64_t default_value;
-  float default_fl_value;
+  uint64_t default_value = 0;
+  float default_fl_value = 0;
   std::string default_str_value;
   parseFieldWidth(data_json,
                   field_data_type,
@@ -323,9 +341,9 @@ std::unique_ptr<ActionInfo> TdiInfoParser::parseAction(
 
   // get action profile data_json
   tdi::Cjson action_data_cjson = action_json["data"];
-  for (const auto &action_data : action_data_cjson.getCjsonChildVec()) {
+  for (const auto &action_data : action_data_cjson) {
     uint64_t oneof_index = 0;
-    auto data_field = parseDataField(*action_data, oneof_index);
+    auto data_field = parseDataField(action_data, oneof_index);
     if (data_fields.find(data_field->idGet()) != data_fields.end()) {
       LOG_ERROR("%s:%d ID \"%u\" Exists for data ",
                 __func__,
@@ -353,9 +371,8 @@ std::unique_ptr<tdi::LearnInfo> TdiInfoParser::parseLearn(
 
   // parse each field
   int oneof_size = 1;
-  for (const auto &field :
-       learn_tdi[tdi_json::LEARN_FIELDS].getCjsonChildVec()) {
-    auto learn_field = parseDataField(*field, oneof_size);
+  for (const auto &field : learn_tdi[tdi_json::LEARN_FIELDS]) {
+    auto learn_field = parseDataField(field, oneof_size);
     if (learn_field == nullptr) {
       continue;
     }
@@ -421,8 +438,8 @@ std::unique_ptr<tdi::TableInfo> TdiInfoParser::parseTable(
   // getting key   //
   ///////////////////
   tdi::Cjson table_key_cjson = table_tdi[tdi_json::TABLE_KEY];
-  for (const auto &key : table_key_cjson.getCjsonChildVec()) {
-    std::unique_ptr<KeyFieldInfo> key_field = parseKeyField(*key);
+  for (const auto &key : table_key_cjson) {
+    std::unique_ptr<KeyFieldInfo> key_field = parseKeyField(key);
     if (key_field == nullptr) {
       continue;
     }
@@ -443,15 +460,15 @@ std::unique_ptr<tdi::TableInfo> TdiInfoParser::parseTable(
   // getting data   //
   ////////////////////
   tdi::Cjson table_data_cjson = table_tdi[tdi_json::TABLE_DATA];
-  for (const auto &data_json : table_data_cjson.getCjsonChildVec()) {
+  for (const auto &data_json : table_data_cjson) {
     std::string data_name;
     int oneof_size = 1;
-    if ((*data_json)["oneof"].exists()) {
-      oneof_size = (*data_json)["oneof"].array_size();
+    if (data_json["oneof"].exists()) {
+      oneof_size = data_json["oneof"].array_size();
     }
     tdi::Cjson temp;
     for (int oneof_loop = 0; oneof_loop < oneof_size; oneof_loop++) {
-      auto data_field = parseDataField(*data_json, oneof_loop);
+      auto data_field = parseDataField(data_json, oneof_loop);
       tdi_id_t data_field_id = data_field->idGet();
       if (table_data_map.find(data_field_id) != table_data_map.end()) {
         LOG_ERROR("%s:%d Id \"%u\" Exists for common data of table %s",
@@ -470,8 +487,8 @@ std::unique_ptr<tdi::TableInfo> TdiInfoParser::parseTable(
   // getting depends on //
   ////////////////////////
   tdi::Cjson depends_on_cjson = table_tdi[tdi_json::TABLE_DEPENDS_ON];
-  for (const auto &tbl_id : depends_on_cjson.getCjsonChildVec()) {
-    depends_on_set.insert(*tbl_id);
+  for (const auto &tbl_id : depends_on_cjson) {
+    depends_on_set.insert(tbl_id);
   }
 
   ////////////////////////
@@ -496,8 +513,8 @@ std::unique_ptr<tdi::TableInfo> TdiInfoParser::parseTable(
   // getting action //
   ////////////////////
   tdi::Cjson table_action_spec_cjson = table_tdi[tdi_json::TABLE_ACTION_SPECS];
-  for (const auto &action : table_action_spec_cjson.getCjsonChildVec()) {
-    auto action_info = parseAction(*action);
+  for (const auto &action : table_action_spec_cjson) {
+    auto action_info = parseAction(action);
     auto elem = table_action_map.find(action_info->idGet());
     if (elem == table_action_map.end()) {
       table_action_map[action_info->idGet()] = (std::move(action_info));
@@ -540,35 +557,112 @@ std::unique_ptr<tdi::TableInfo> TdiInfoParser::parseTable(
 
 tdi_status_t TdiInfoParser::parseTdiInfo(
     const std::vector<std::string> &tdi_info_file_paths) {
+  return parseTdiInfo(tdi_info_file_paths, "");
+}
+
+tdi_status_t TdiInfoParser::parseTdiInfo(
+    const std::vector<std::string> &tdi_info_file_paths,
+    const std::string &schema_cache_dir) {
   // A. read file form a list of schema files
   if (tdi_info_file_paths.empty()) {
     LOG_CRIT("Unable to find any TDI Json Schema File");
     return TDI_OBJECT_NOT_FOUND;
   }
+  std::vector<std::unique_ptr<FileContent>> contents;
   for (auto const &tdiJsonFile : tdi_info_file_paths) {
-    std::ifstream file(tdiJsonFile);
-    if (file.fail()) {
+    std::unique_ptr<FileContent> content(new FileContent(tdiJsonFile));
+    if (!content->valid()) {
       LOG_CRIT("Unable to find TDI Json File %s", tdiJsonFile.c_str());
       return TDI_OBJECT_NOT_FOUND;
     }
-    std::string content((std::istreambuf_iterator<char>(file)),
-                        std::istreambuf_iterator<char>());
-    tdi::Cjson root_cjson = tdi::Cjson::createCjsonFromFile(content);
-    tdi::Cjson tables_cjson = root_cjson[tdi_json::TABLES];
-    for (const auto &table : tables_cjson.getCjsonChildVec()) {
-      // B. parse file to form tdi_table_info object
-      std::string table_name =
-          static_cast<std::string>((*table)[tdi_json::TABLE_NAME]);
-      table_info_map_[table_name] = this->parseTable(*table);
+    contents.push_back(std::move(content));
+  }
+
+  // A compiled image of the same inputs skips JSON parsing altogether
+  uint64_t cache_key = 0;
+  std::string cache_path;
+  if (!schema_cache_dir.empty()) {
+    cache_key = SchemaCache::keyGet(contents, tdi_info_mapper_.get());
+    cache_path = SchemaCache::pathGet(schema_cache_dir, cache_key);
+    if (SchemaCache::load(
+            cache_path, cache_key, &table_info_map_, &learn_info_map_) ==
+        TDI_SUCCESS) {
+      LOG_DBG("%s:%d Loaded TDI schema from cache %s",
+              __func__,
+              __LINE__,
+              cache_path.c_str());
+      return TDI_SUCCESS;
     }
+  }
+
+  // Files, then the table and learn nodes of all files, are independent of
+  // each other and are parsed on a pool. Results land in per item slots
+  // and are merged in file and node order, so the maps come out the same
+  // as with a serial parse
+  const size_t num_threads =
+      parse_threads_ ? parse_threads_ : std::thread::hardware_concurrency();
+  std::unique_ptr<TdiThreadPool> thread_pool;
+  if (num_threads > 1) {
+    thread_pool.reset(new TdiThreadPool(num_threads));
+  }
 
-    tdi::Cjson learns_cjson = root_cjson[tdi_json::LEARN_FILTERS];
-    for (const auto &learn : learns_cjson.getCjsonChildVec()) {
-      // C. parse file to form tdi_learn_info object
-      std::string learn_name = static_cast<std::string>((*learn)["name"]);
-      learn_info_map_[learn_name] = this->parseLearn(*learn);
+  std::vector<tdi::Cjson> roots(contents.size());
+  parallelFor(thread_pool.get(), roots.size(), [&](const size_t &i) {
+    // The arena document keeps 64 bit integers exact and does not need the
+    // file once parsed
+    roots[i] = tdi::Cjson::createCjsonFromBuffer(contents[i]->data(),
+                                                 contents[i]->size());
+  });
+  std::vector<tdi::Cjson> table_nodes;
+  std::vector<tdi::Cjson> learn_nodes;
+  for (size_t i = 0; i < roots.size(); i++) {
+    if (!roots[i].exists()) {
+      LOG_CRIT("Unable to parse TDI Json File %s",
+               tdi_info_file_paths[i].c_str());
+      return TDI_INVALID_ARG;
+    }
+    for (const auto &table : roots[i][tdi_json::TABLES]) {
+      table_nodes.push_back(table);
+    }
+    for (const auto &learn : roots[i][tdi_json::LEARN_FILTERS]) {
+      learn_nodes.push_back(learn);
     }
   }
+
+  // B. parse file to form tdi_table_info object
+  // C. parse file to form tdi_learn_info object
+  std::vector<std::unique_ptr<TableInfo>> tables(table_nodes.size());
+  std::vector<std::unique_ptr<LearnInfo>> learns(learn_nodes.size());
+  parallelFor(thread_pool.get(),
+              tables.size() + learns.size(),
+              [&](const size_t &i) {
+                if (i < tables.size()) {
+                  tables[i] = this->parseTable(table_nodes[i]);
+                } else {
+                  const size_t j = i - tables.size();
+                  learns[j] = this->parseLearn(learn_nodes[j]);
+                }
+              });
+  for (size_t i = 0; i < tables.size(); i++) {
+    std::string table_name =
+        static_cast<std::string>(table_nodes[i][tdi_json::TABLE_NAME]);
+    table_info_map_[table_name] = std::move(tables[i]);
+  }
+  for (size_t i = 0; i < learns.size(); i++) {
+    std::string learn_name = static_cast<std::string>(learn_nodes[i]["name"]);
+    learn_info_map_[learn_name] = std::move(learns[i]);
+  }
+
+  if (!schema_cache_dir.empty() &&
+      SchemaCache::store(
+          cache_path, cache_key, table_info_map_, learn_info_map_) !=
+          TDI_SUCCESS) {
+    // Not fatal, the next start parses the JSON again
+    LOG_WARN("%s:%d Unable to cache TDI schema in %s",
+             __func__,
+             __LINE__,
+             schema_cache_dir.c_str());
+  }
   return TDI_SUCCESS;
 }
 
@@ -0,0 +1,587 @@
+/*
+ * Copyright(c) 2021 Intel Corporation.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this software except as stipulated in the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+
+#include <unistd.h>
+
+#include <tdi/common/tdi_info.hpp>
+#include <tdi/common/tdi_utils.hpp>
+
+#include "tdi_file_content.hpp"
+#include "tdi_schema_cache.hpp"
+
+namespace tdi {
+
+namespace {
+
+const char kMagic[8] = {'T', 'D', 'I', 'S', 'C', 'H', 'M', 'A'};
+// Bump whenever the record layout or the parsing of tdi.json changes
+const uint32_t kVersion = 2;
+// Written in host order, tells a foreign endian image apart
+const uint32_t kByteOrder = 0x01020304;
+
+struct Header {
+  char magic[8];
+  uint32_t version;
+  uint32_t byte_order;
+  uint64_t key;
+  uint64_t payload_size;
+};
+
+inline uint64_t fnv1a(uint64_t hash, const void *data, const size_t &len) {
+  const uint8_t *bytes = static_cast<const uint8_t *>(data);
+  for (size_t i = 0; i < len; i++) {
+    hash ^= bytes[i];
+    hash *= 0x100000001b3ULL;
+  }
+  return hash;
+}
+
+inline uint64_t fnv1aString(const uint64_t &hash, const std::string &str) {
+  const uint64_t len = str.size();
+  return fnv1a(fnv1a(hash, &len, sizeof(len)), str.data(), str.size());
+}
+
+template <typename E>
+uint64_t enumMapHash(uint64_t hash, const std::map<std::string, E> &enum_map) {
+  for (const auto &kv : enum_map) {
+    const uint32_t value = static_cast<uint32_t>(kv.second);
+    hash = fnv1aString(hash, kv.first);
+    hash = fnv1a(hash, &value, sizeof(value));
+  }
+  return fnv1a(hash, "|", 1);
+}
+
+}  // anonymous namespace
+
+class SchemaCache::Writer {
+ public:
+  void u8(const bool &value) { buf_.push_back(value ? 1 : 0); };
+  void u32(const uint32_t &value) {
+    buf_.append(reinterpret_cast<const char *>(&value), sizeof(value));
+  };
+  void u64(const uint64_t &value) {
+    buf_.append(reinterpret_cast<const char *>(&value), sizeof(value));
+  };
+  void f32(const float &value) {
+    uint32_t bits;
+    std::memcpy(&bits, &value, sizeof(bits));
+    u32(bits);
+  };
+  void str(const std::string &value) {
+    u32(static_cast<uint32_t>(value.size()));
+    buf_.append(value);
+  };
+  void strVec(const std::vector<std::string> &values) {
+    u32(static_cast<uint32_t>(values.size()));
+    for (const auto &value : values) str(value);
+  };
+  const std::string &bufGet() const { return buf_; };
+
+ private:
+  std::string buf_;
+};
+
+class SchemaCache::Reader {
+ public:
+  Reader(const char *data, const size_t &len) : pos_(data), end_(data + len){};
+
+  bool u8() {
+    uint8_t value = 0;
+    copy(&value, sizeof(value));
+    return value != 0;
+  };
+  uint32_t u32() {
+    uint32_t value = 0;
+    copy(&value, sizeof(value));
+    return value;
+  };
+  uint64_t u64() {
+    uint64_t value = 0;
+    copy(&value, sizeof(value));
+    return value;
+  };
+  float f32() {
+    uint32_t bits = u32();
+    float value;
+    std::memcpy(&value, &bits, sizeof(value));
+    return value;
+  };
+  std::string str() {
+    const uint32_t len = u32();
+    if (!ok_ || len > static_cast<size_t>(end_ - pos_)) {
+      ok_ = false;
+      return std::string();
+    }
+    std::string value(pos_, len);
+    pos_ += len;
+    return value;
+  };
+  std::vector<std::string> strVec() {
+    std::vector<std::string> values;
+    const uint32_t count = countGet();
+    for (uint32_t i = 0; i < count && ok_; i++) values.push_back(str());
+    return values;
+  };
+  // Element count, checked against what is left so that a corrupt image
+  // cannot make us allocate or loop for long
+  uint32_t countGet() {
+    const uint32_t count = u32();
+    if (count > static_cast<size_t>(end_ - pos_)) {
+      ok_ = false;
+      return 0;
+    }
+    return count;
+  };
+  bool ok() const { return ok_; };
+  bool done() const { return pos_ == end_; };
+
+ private:
+  void copy(void *out, const size_t &len) {
+    if (!ok_ || len > static_cast<size_t>(end_ - pos_)) {
+      ok_ = false;
+      return;
+    }
+    std::memcpy(out, pos_, len);
+    pos_ += len;
+  };
+
+  const char *pos_;
+  const char *end_;
+  bool ok_{true};
+};
+
+uint64_t SchemaCache::keyGet(
+    const std::vector<std::unique_ptr<FileContent>> &contents,
+    TdiInfoMapper *tdi_info_mapper) {
+  uint64_t hash = 0xcbf29ce484222325ULL;
+  hash = fnv1a(hash, &kVersion, sizeof(kVersion));
+  for (const auto &content : contents) {
+    const uint64_t len = content->size();
+    hash = fnv1a(hash, &len, sizeof(len));
+    hash = fnv1a(hash, content->data(), content->size());
+  }
+  hash = enumMapHash(hash, tdi_info_mapper->tableEnumMapGet());
+  hash = enumMapHash(hash, tdi_info_mapper->matchEnumMapGet());
+  hash = enumMapHash(hash, tdi_info_mapper->operationsEnumMapGet());
+  hash = enumMapHash(hash, tdi_info_mapper->attributesEnumMapGet());
+  return hash;
+}
+
+std::string SchemaCache::pathGet(const std::string &cache_dir,
+                                 const uint64_t &key) {
+  char name[64];
+  std::snprintf(name,
+                sizeof(name),
+                "tdi_schema_%016llx.bin",
+                static_cast<unsigned long long>(key));
+  return cache_dir + "/" + name;
+}
+
+void SchemaCache::annotationsWrite(Writer *writer,
+                                   const std::set<Annotation> &annotations) {
+  writer->u32(static_cast<uint32_t>(annotations.size()));
+  for (const auto &annotation : annotations) {
+    writer->str(annotation.name_);
+    writer->str(annotation.value_);
+  }
+}
+
+void SchemaCache::keyFieldWrite(Writer *writer, const KeyFieldInfo &key_field) {
+  writer->u32(key_field.field_id_);
+  writer->str(key_field.name_);
+  writer->u64(key_field.size_bits_);
+  writer->u32(static_cast<uint32_t>(key_field.match_type_));
+  writer->u32(static_cast<uint32_t>(key_field.data_type_));
+  writer->u8(key_field.mandatory_);
+  writer->strVec(key_field.enum_choices_);
+  annotationsWrite(writer, key_field.annotations_);
+  writer->u64(key_field.default_value_);
+  writer->f32(key_field.default_fl_value_);
+  writer->str(key_field.default_str_value_);
+  writer->u8(key_field.is_field_slice_);
+  writer->u8(key_field.is_ptr_);
+  writer->u8(key_field.match_priority_);
+}
+
+void SchemaCache::dataFieldWrite(Writer *writer,
+                                 const DataFieldInfo &data_field) {
+  writer->u32(data_field.field_id_);
+  writer->str(data_field.name_);
+  writer->u64(data_field.size_bits_);
+  writer->u32(static_cast<uint32_t>(data_field.data_type_));
+  writer->u8(data_field.mandatory_);
+  writer->u8(data_field.read_only_);
+  writer->strVec(data_field.enum_choices_);
+  annotationsWrite(writer, data_field.annotations_);
+  writer->u64(data_field.default_value_);
+  writer->f32(data_field.default_fl_value_);
+  writer->str(data_field.default_str_value_);
+  writer->u8(data_field.repeated_);
+  writer->u8(data_field.container_valid_);
+  writer->u32(static_cast<uint32_t>(data_field.oneof_siblings_.size()));
+  for (const auto &sibling : data_field.oneof_siblings_) {
+    writer->u32(sibling);
+  }
+}
+
+void SchemaCache::dataFieldsWrite(
+    Writer *writer,
+    const std::map<tdi_id_t, std::unique_ptr<DataFieldInfo>> &data_fields) {
+  writer->u32(static_cast<uint32_t>(data_fields.size()));
+  for (const auto &kv : data_fields) {
+    dataFieldWrite(writer, *kv.second);
+  }
+}
+
+void SchemaCache::tableWrite(Writer *writer, const TableInfo &table_info) {
+  writer->u32(table_info.id_);
+  writer->str(table_info.name_);
+  writer->u32(static_cast<uint32_t>(table_info.table_type_));
+  writer->u64(table_info.size_);
+  writer->u8(table_info.has_const_default_action_);
+  writer->u8(table_info.is_const_);
+  writer->u32(static_cast<uint32_t>(table_info.table_key_map_.size()));
+  for (const auto &kv : table_info.table_key_map_) {
+    keyFieldWrite(writer, *kv.second);
+  }
+  dataFieldsWrite(writer, table_info.table_data_map_);
+  writer->u32(static_cast<uint32_t>(table_info.table_action_map_.size()));
+  for (const auto &kv : table_info.table_action_map_) {
+    const ActionInfo &action_info = *kv.second;
+    writer->u32(action_info.action_id_);
+    writer->str(action_info.name_);
+    dataFieldsWrite(writer, action_info.data_fields_);
+    annotationsWrite(writer, action_info.annotations_);
+  }
+  writer->u32(static_cast<uint32_t>(table_info.depends_on_set_.size()));
+  for (const auto &table_id : table_info.depends_on_set_) {
+    writer->u32(table_id);
+  }
+  const auto &api_map = table_info.table_apis_.api_target_attributes_map_;
+  writer->u32(static_cast<uint32_t>(api_map.size()));
+  for (const auto &kv : api_map) {
+    writer->u32(static_cast<uint32_t>(kv.first));
+    writer->strVec(kv.second);
+  }
+  writer->u32(static_cast<uint32_t>(table_info.operations_type_set_.size()));
+  for (const auto &operation : table_info.operations_type_set_) {
+    writer->u32(static_cast<uint32_t>(operation));
+  }
+  writer->u32(static_cast<uint32_t>(table_info.attributes_type_set_.size()));
+  for (const auto &attribute : table_info.attributes_type_set_) {
+    writer->u32(static_cast<uint32_t>(attribute));
+  }
+  annotationsWrite(writer, table_info.annotations_);
+}
+
+void SchemaCache::learnWrite(Writer *writer, const LearnInfo &learn_info) {
+  writer->u32(learn_info.id_);
+  writer->str(learn_info.name_);
+  dataFieldsWrite(writer, learn_info.learn_field_map_);
+  annotationsWrite(writer, learn_info.annotations_);
+}
+
+std::set<Annotation> SchemaCache::annotationsRead(Reader *reader) {
+  std::set<Annotation> annotations;
+  const uint32_t count = reader->countGet();
+  for (uint32_t i = 0; i < count && reader->ok(); i++) {
+    std::string name = reader->str();
+    std::string value = reader->str();
+    annotations.emplace(name, value);
+  }
+  return annotations;
+}
+
+std::unique_ptr<KeyFieldInfo> SchemaCache::keyFieldRead(Reader *reader) {
+  // Arguments are read in order, so no reads inside the constructor call
+  const tdi_id_t id = reader->u32();
+  const std::string name = reader->str();
+  const size_t size_bits = reader->u64();
+  const auto match_type = static_cast<tdi_match_type_e>(reader->u32());
+  const auto data_type = static_cast<tdi_field_data_type_e>(reader->u32());
+  const bool mandatory = reader->u8();
+  const std::vector<std::string> choices = reader->strVec();
+  const std::set<Annotation> annotations = annotationsRead(reader);
+  const uint64_t default_value = reader->u64();
+  const float default_fl_value = reader->f32();
+  const std::string default_str_value = reader->str();
+  const bool is_field_slice = reader->u8();
+  const bool is_ptr = reader->u8();
+  const bool match_priority = reader->u8();
+  return std::unique_ptr<KeyFieldInfo>(new KeyFieldInfo(id,
+                                                        name,
+                                                        size_bits,
+                                                        match_type,
+                                                        data_type,
+                                                        mandatory,
+                                                        choices,
+                                                        annotations,
+                                                        default_value,
+                                                        default_fl_value,
+                                                        default_str_value,
+                                                        is_field_slice,
+                                                        is_ptr,
+                                                        match_priority));
+}
+
+std::unique_ptr<DataFieldInfo> SchemaCache::dataFieldRead(Reader *reader) {
+  const tdi_id_t id = reader->u32();
+  const std::string name = reader->str();
+  const size_t size_bits = reader->u64();
+  const auto data_type = static_cast<tdi_field_data_type_e>(reader->u32());
+  const bool mandatory = reader->u8();
+  const bool read_only = reader->u8();
+  const std::vector<std::string> choices = reader->strVec();
+  const std::set<Annotation> annotations = annotationsRead(reader);
+  const uint64_t default_value = reader->u64();
+  const float default_fl_value = reader->f32();
+  const std::string default_str_value = reader->str();
+  const bool repeated = reader->u8();
+  const bool container_valid = reader->u8();
+  std::set<tdi_id_t> oneof_siblings;
+  const uint32_t sibling_count = reader->countGet();
+  for (uint32_t i = 0; i < sibling_count && reader->ok(); i++) {
+    oneof_siblings.insert(reader->u32());
+  }
+  return std::unique_ptr<DataFieldInfo>(new DataFieldInfo(id,
+                                                          name,
+                                                          size_bits,
+                                                          data_type,
+                                                          mandatory,
+                                                          read_only,
+                                                          choices,
+                                                          annotations,
+                                                          default_value,
+                                                          default_fl_value,
+                                                          default_str_value,
+                                                          repeated,
+                                                          container_valid,
+                                                          oneof_siblings));
+}
+
+std::map<tdi_id_t, std::unique_ptr<DataFieldInfo>> SchemaCache::dataFieldsRead(
+    Reader *reader) {
+  std::map<tdi_id_t, std::unique_ptr<DataFieldInfo>> data_fields;
+  const uint32_t count = reader->countGet();
+  for (uint32_t i = 0; i < count && reader->ok(); i++) {
+    auto data_field = dataFieldRead(reader);
+    const tdi_id_t id = data_field->idGet();
+    data_fields[id] = std::move(data_field);
+  }
+  return data_fields;
+}
+
+std::unique_ptr<TableInfo> SchemaCache::tableRead(Reader *reader) {
+  const tdi_id_t id = reader->u32();
+  const std::string name = reader->str();
+  const auto table_type = static_cast<tdi_table_type_e>(reader->u32());
+  const size_t size = reader->u64();
+  const bool has_const_default_action = reader->u8();
+  const bool is_const = reader->u8();
+
+  std::map<tdi_id_t, std::unique_ptr<KeyFieldInfo>> table_key_map;
+  const uint32_t key_count = reader->countGet();
+  for (uint32_t i = 0; i < key_count && reader->ok(); i++) {
+    auto key_field = keyFieldRead(reader);
+    const tdi_id_t field_id = key_field->idGet();
+    table_key_map[field_id] = std::move(key_field);
+  }
+  auto table_data_map = dataFieldsRead(reader);
+
+  std::map<tdi_id_t, std::unique_ptr<ActionInfo>> table_action_map;
+  const uint32_t action_count = reader->countGet();
+  for (uint32_t i = 0; i < action_count && reader->ok(); i++) {
+    const tdi_id_t action_id = reader->u32();
+    const std::string action_name = reader->str();
+    auto data_fields = dataFieldsRead(reader);
+    auto annotations = annotationsRead(reader);
+    table_action_map[action_id] = std::unique_ptr<ActionInfo>(new ActionInfo(
+        action_id, action_name, std::move(data_fields), annotations));
+  }
+
+  std::set<tdi_id_t> depends_on_set;
+  const uint32_t depends_count = reader->countGet();
+  for (uint32_t i = 0; i < depends_count && reader->ok(); i++) {
+    depends_on_set.insert(reader->u32());
+  }
+  std::map<tdi_table_api_type_e, std::vector<std::string>> api_map;
+  const uint32_t api_count = reader->countGet();
+  for (uint32_t i = 0; i < api_count && reader->ok(); i++) {
+    const auto api = static_cast<tdi_table_api_type_e>(reader->u32());
+    api_map[api] = reader->strVec();
+  }
+  std::set<tdi_operations_type_e> operations_type_set;
+  const uint32_t operations_count = reader->countGet();
+  for (uint32_t i = 0; i < operations_count && reader->ok(); i++) {
+    operations_type_set.insert(
+        static_cast<tdi_operations_type_e>(reader->u32()));
+  }
+  std::set<tdi_attributes_type_e> attributes_type_set;
+  const uint32_t attributes_count = reader->countGet();
+  for (uint32_t i = 0; i < attributes_count && reader->ok(); i++) {
+    attributes_type_set.insert(
+        static_cast<tdi_attributes_type_e>(reader->u32()));
+  }
+  auto annotations = annotationsRead(reader);
+
+  return std::unique_ptr<TableInfo>(new TableInfo(id,
+                                                  name,
+                                                  table_type,
+                                                  size,
+                                                  has_const_default_action,
+                                                  is_const,
+                                                  std::move(table_key_map),
+                                                  std::move(table_data_map),
+                                                  std::move(table_action_map),
+                                                  depends_on_set,
+                                                  SupportedApis(api_map),
+                                                  operations_type_set,
+                                                  attributes_type_set,
+                                                  annotations));
+}
+
+std::unique_ptr<LearnInfo> SchemaCache::learnRead(Reader *reader) {
+  const tdi_id_t id = reader->u32();
+  const std::string name = reader->str();
+  auto learn_field_map = dataFieldsRead(reader);
+  auto annotations = annotationsRead(reader);
+  return std::unique_ptr<LearnInfo>(
+      new LearnInfo(id, name, std::move(learn_field_map), annotations));
+}
+
+std::string SchemaCache::tableImageGet(const TableInfo &table_info) {
+  Writer writer;
+  tableWrite(&writer, table_info);
+  return writer.bufGet();
+}
+
+tdi_status_t SchemaCache::load(
+    const std::string &path,
+    const uint64_t &key,
+    std::map<std::string, std::unique_ptr<TableInfo>> *table_info_map,
+    std::map<std::string, std::unique_ptr<LearnInfo>> *learn_info_map) {
+  FileContent content(path);
+  if (!content.valid()) {
+    return TDI_OBJECT_NOT_FOUND;
+  }
+  Header header;
+  if (content.size() < sizeof(header)) {
+    LOG_WARN("%s:%d Schema cache %s is truncated",
+             __func__,
+             __LINE__,
+             path.c_str());
+    return TDI_INVALID_ARG;
+  }
+  std::memcpy(&header, content.data(), sizeof(header));
+  if (std::memcmp(header.magic, kMagic, sizeof(kMagic)) ||
+      header.version != kVersion || header.byte_order != kByteOrder ||
+      header.key != key ||
+      header.payload_size != content.size() - sizeof(header)) {
+    LOG_WARN("%s:%d Schema cache %s does not match the schema",
+             __func__,
+             __LINE__,
+             path.c_str());
+    return TDI_INVALID_ARG;
+  }
+
+  Reader reader(content.data() + sizeof(header), header.payload_size);
+  std::map<std::string, std::unique_ptr<TableInfo>> tables;
+  std::map<std::string, std::unique_ptr<LearnInfo>> learns;
+  const uint32_t table_count = reader.countGet();
+  for (uint32_t i = 0; i < table_count && reader.ok(); i++) {
+    const std::string name = reader.str();
+    tables[name] = tableRead(&reader);
+  }
+  const uint32_t learn_count = reader.countGet();
+  for (uint32_t i = 0; i < learn_count && reader.ok(); i++) {
+    const std::string name = reader.str();
+    learns[name] = learnRead(&reader);
+  }
+  if (!reader.ok() || !reader.done()) {
+    LOG_WARN("%s:%d Schema cache %s is corrupt",
+             __func__,
+             __LINE__,
+             path.c_str());
+    return TDI_INVALID_ARG;
+  }
+  *table_info_map = std::move(tables);
+  *learn_info_map = std::move(learns);
+  return TDI_SUCCESS;
+}
+
+tdi_status_t SchemaCache::store(
+    const std::string &path,
+    const uint64_t &key,
+    const std::map<std::string, std::unique_ptr<TableInfo>> &table_info_map,
+    const std::map<std::string, std::unique_ptr<LearnInfo>> &learn_info_map) {
+  Writer writer;
+  writer.u32(static_cast<uint32_t>(table_info_map.size()));
+  for (const auto &kv : table_info_map) {
+    if (!kv.second) {
+      // Tables that failed to parse are not cached, the JSON has to be
+      // parsed again so that the errors are reported
+      return TDI_INVALID_ARG;
+    }
+    writer.str(kv.first);
+    tableWrite(&writer, *kv.second);
+  }
+  writer.u32(static_cast<uint32_t>(learn_info_map.size()));
+  for (const auto &kv : learn_info_map) {
+    if (!kv.second) return TDI_INVALID_ARG;
+    writer.str(kv.first);
+    learnWrite(&writer, *kv.second);
+  }
+
+  Header header;
+  std::memcpy(header.magic, kMagic, sizeof(kMagic));
+  header.version = kVersion;
+  header.byte_order = kByteOrder;
+  header.key = key;
+  header.payload_size = writer.bufGet().size();
+
+  // Write aside and rename, so that concurrent readers see either no image
+  // or a complete one
+  const std::string tmp_path = path + "." + std::to_string(getpid());
+  {
+    std::ofstream file(tmp_path, std::ios::binary | std::ios::trunc);
+    file.write(reinterpret_cast<const char *>(&header), sizeof(header));
+    file.write(writer.bufGet().data(), writer.bufGet().size());
+    if (!file.good()) {
+      file.close();
+      std::remove(tmp_path.c_str());
+      LOG_WARN("%s:%d Unable to write schema cache %s",
+               __func__,
+               __LINE__,
+               tmp_path.c_str());
+      return TDI_UNEXPECTED;
+    }
+  }
+  if (std::rename(tmp_path.c_str(), path.c_str()) != 0) {
+    std::remove(tmp_path.c_str());
+    LOG_WARN("%s:%d Unable to write schema cache %s",
+             __func__,
+             __LINE__,
+             path.c_str());
+    return TDI_UNEXPECTED;
+  }
+  return TDI_SUCCESS;
+}
+
+}  // namespace tdi
@@ -0,0 +1,114 @@
+/*
+ * Copyright(c) 2021 Intel Corporation.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this software except as stipulated in the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+/** @file tdi_schema_cache.hpp
+ *
+ *  @brief Contains the compiled binary cache of parsed TDI schemas
+ */
+#ifndef _TDI_SCHEMA_CACHE_HPP
+#define _TDI_SCHEMA_CACHE_HPP
+
+#include <map>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include <tdi/common/tdi_defs.h>
+#include <tdi/common/tdi_json_parser/tdi_learn_info.hpp>
+#include <tdi/common/tdi_json_parser/tdi_table_info.hpp>
+
+namespace tdi {
+
+class FileContent;
+class TdiInfoMapper;
+
+/**
+ * @brief Compiled image of the TableInfo and LearnInfo objects parsed from a
+ * set of tdi.json files.
+ *
+ * The image is a versioned header followed by a flat host order record
+ * stream without pointers, so it can be mapped and decoded in place. It is
+ * keyed by a hash of the JSON inputs and of the target's info mapper, since
+ * the enums stored depend on both. Any image that does not match is ignored
+ * and the JSON is parsed again.
+ */
+class SchemaCache {
+ public:
+  /**
+   * @brief Hash of the schema inputs
+   */
+  static uint64_t keyGet(
+      const std::vector<std::unique_ptr<FileContent>> &contents,
+      TdiInfoMapper *tdi_info_mapper);
+
+  /**
+   * @brief Path of the image of a key inside a cache directory
+   */
+  static std::string pathGet(const std::string &cache_dir,
+                             const uint64_t &key);
+
+  /**
+   * @brief Load an image. Maps are only filled on success
+   *
+   * @return TDI_OBJECT_NOT_FOUND if there is no image, TDI_INVALID_ARG if it
+   * is stale or corrupt
+   */
+  static tdi_status_t load(
+      const std::string &path,
+      const uint64_t &key,
+      std::map<std::string, std::unique_ptr<TableInfo>> *table_info_map,
+      std::map<std::string, std::unique_ptr<LearnInfo>> *learn_info_map);
+
+  /**
+   * @brief Write an image. The file is replaced atomically so readers never
+   * see a partial image
+   */
+  static tdi_status_t store(
+      const std::string &path,
+      const uint64_t &key,
+      const std::map<std::string, std::unique_ptr<TableInfo>> &table_info_map,
+      const std::map<std::string, std::unique_ptr<LearnInfo>> &learn_info_map);
+
+  /**
+   * @brief Image of a single table. Equal images mean equal schemas
+   */
+  static std::string tableImageGet(const TableInfo &table_info);
+
+ private:
+  class Writer;
+  class Reader;
+
+  static void annotationsWrite(Writer *writer,
+                               const std::set<Annotation> &annotations);
+  static void keyFieldWrite(Writer *writer, const KeyFieldInfo &key_field);
+  static void dataFieldWrite(Writer *writer, const DataFieldInfo &data_field);
+  static void dataFieldsWrite(
+      Writer *writer,
+      const std::map<tdi_id_t, std::unique_ptr<DataFieldInfo>> &data_fields);
+  static void tableWrite(Writer *writer, const TableInfo &table_info);
+  static void learnWrite(Writer *writer, const LearnInfo &learn_info);
+
+  static std::set<Annotation> annotationsRead(Reader *reader);
+  static std::unique_ptr<KeyFieldInfo> keyFieldRead(Reader *reader);
+  static std::unique_ptr<DataFieldInfo> dataFieldRead(Reader *reader);
+  static std::map<tdi_id_t, std::unique_ptr<DataFieldInfo>> dataFieldsRead(
+      Reader *reader);
+  static std::unique_ptr<TableInfo> tableRead(Reader *reader);
+  static std::unique_ptr<LearnInfo> learnRead(Reader *reader);
+};
+
+}  // namespace tdi
+
+#endif  // _TDI_SCHEMA_CACHE_HPP
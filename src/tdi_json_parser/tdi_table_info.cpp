@@ -14,6 +14,7 @@
  * limitations under the License.
  */
 
+#include <algorithm>
 #include <exception>
 #include <fstream>
 #include <iostream>
@@ -25,6 +26,8 @@
 #include <tdi/common/tdi_json_parser/tdi_table_info.hpp>
 #include <tdi/common/tdi_utils.hpp>
 
+#include "tdi_schema_cache.hpp"
+
 namespace tdi {
 
 bool Annotation::operator<(const Annotation &other) const {
@@ -41,65 +44,44 @@ tdi_status_t Annotation::fullNameGet(std::string *full_name) const {
   return TDI_SUCCESS;
 }
 
-std::vector<tdi_id_t> TableInfo::keyFieldIdListGet() const {
-  std::vector<tdi_id_t> id_vec;
-  for (const auto &kv : table_key_map_) {
-    id_vec.push_back(kv.first);
-  }
-  std::sort(id_vec.begin(), id_vec.end());
-  return id_vec;
-}
-
 const KeyFieldInfo *TableInfo::keyFieldGet(const std::string &name) const {
-  if (name_key_map_.find(name) == name_key_map_.end()) {
+  const auto key_field = key_name_index_.find(name);
+  if (key_field == nullptr) {
     LOG_ERROR("%s:%d %s Field \"%s\" not found in key field list",
               __func__,
               __LINE__,
               nameGet().c_str(),
               name.c_str());
-    return nullptr;
   }
-  return name_key_map_.at(name);
+  return key_field;
 }
 
 const KeyFieldInfo *TableInfo::keyFieldGet(const tdi_id_t &field_id) const {
-  if (table_key_map_.find(field_id) == table_key_map_.end()) {
+  const auto key_field = key_index_.find(field_id);
+  if (key_field == nullptr) {
     LOG_ERROR("%s:%d %s Field \"%d\" not found in key field list",
               __func__,
               __LINE__,
               nameGet().c_str(),
               field_id);
-    return nullptr;
   }
-  return table_key_map_.at(field_id).get();
+  return key_field;
 }
 
-std::vector<tdi_id_t> TableInfo::dataFieldIdListGet(
+const std::vector<tdi_id_t> &TableInfo::dataFieldIdListGet(
     const tdi_id_t &action_id) const {
-  std::vector<tdi_id_t> id_vec;
   if (action_id) {
-    if (table_action_map_.find(action_id) == table_action_map_.end()) {
-      LOG_ERROR("%s:%d %s Action Id %d Not Found",
-                __func__,
-                __LINE__,
-                nameGet().c_str(),
-                action_id);
-    } else {
-      for (const auto &kv : table_action_map_.at(action_id)->data_fields_) {
-        id_vec.push_back(kv.first);
-      }
+    const auto action_info = action_index_.find(action_id);
+    if (action_info) {
+      return action_info->data_id_list_;
     }
+    LOG_ERROR("%s:%d %s Action Id %d Not Found",
+              __func__,
+              __LINE__,
+              nameGet().c_str(),
+              action_id);
   }
-  // Also include common data fields
-  for (const auto &kv : table_data_map_) {
-    id_vec.push_back(kv.first);
-  }
-  std::sort(id_vec.begin(), id_vec.end());
-  return id_vec;
-}
-
-std::vector<tdi_id_t> TableInfo::dataFieldIdListGet() const {
-  return this->dataFieldIdListGet(0);
+  return data_id_list_;
 }
 
 tdi_id_t TableInfo::dataFieldIdGet(const std::string &name) const {
@@ -117,23 +99,20 @@ tdi_id_t TableInfo::dataFieldIdGet(const std::string &name,
 
 const DataFieldInfo *TableInfo::dataFieldGet(const std::string &name,
                                              const tdi_id_t &action_id) const {
-  if (action_id &&
-      table_action_map_.find(action_id) != table_action_map_.end()) {
-    auto action_info = table_action_map_.at(action_id).get();
-    if (action_info->data_fields_names_.find(name) !=
-        action_info->data_fields_names_.end()) {
-      return action_info->data_fields_names_.at(name);
-    }
-  }
-  if (name_data_map_.find(name) != name_data_map_.end()) {
-    return name_data_map_.at(name);
+  const ActionInfo *action_info =
+      action_id ? action_index_.find(action_id) : nullptr;
+  // The index of an action also holds the common data fields
+  const auto data_field = action_info
+                              ? action_info->data_name_index_.find(name)
+                              : data_name_index_.find(name);
+  if (data_field == nullptr) {
+    LOG_ERROR("%s:%d %s Field \"%s\" not found in data field list",
+              __func__,
+              __LINE__,
+              nameGet().c_str(),
+              name.c_str());
   }
-  LOG_ERROR("%s:%d %s Field \"%s\" not found in data field list",
-            __func__,
-            __LINE__,
-            nameGet().c_str(),
-            name.c_str());
-  return nullptr;
+  return data_field;
 }
 
 const DataFieldInfo *TableInfo::dataFieldGet(const std::string &name) const {
@@ -142,23 +121,19 @@ const DataFieldInfo *TableInfo::dataFieldGet(const std::string &name) const {
 
 const DataFieldInfo *TableInfo::dataFieldGet(const tdi_id_t &field_id,
                                              const tdi_id_t &action_id) const {
-  if (action_id &&
-      table_action_map_.find(action_id) != table_action_map_.end()) {
-    auto action_info = table_action_map_.at(action_id).get();
-    if (action_info->data_fields_.find(field_id) !=
-        action_info->data_fields_.end()) {
-      return action_info->data_fields_.at(field_id).get();
-    }
-  }
-  if (table_data_map_.find(field_id) != table_data_map_.end()) {
-    return table_data_map_.at(field_id).get();
+  const ActionInfo *action_info =
+      action_id ? action_index_.find(action_id) : nullptr;
+  // The index of an action also holds the common data fields
+  const auto data_field = action_info ? action_info->data_index_.find(field_id)
+                                      : data_index_.find(field_id);
+  if (data_field == nullptr) {
+    LOG_ERROR("%s:%d %s Field \"%d\" not found in data field list",
+              __func__,
+              __LINE__,
+              nameGet().c_str(),
+              field_id);
   }
-  LOG_ERROR("%s:%d %s Field \"%d\" not found in data field list",
-            __func__,
-            __LINE__,
-            nameGet().c_str(),
-            field_id);
-  return nullptr;
+  return data_field;
 }
 
 const DataFieldInfo *TableInfo::dataFieldGet(const tdi_id_t &field_id) const {
@@ -166,36 +141,118 @@ const DataFieldInfo *TableInfo::dataFieldGet(const tdi_id_t &field_id) const {
 }
 
 const ActionInfo *TableInfo::actionGet(const std::string &name) const {
-  if (name_action_map_.find(name) != name_action_map_.end()) {
-    return name_action_map_.at(name);
+  const auto action_info = action_name_index_.find(name);
+  if (action_info == nullptr) {
+    LOG_ERROR("%s:%d %s Action  \"%s\" not found",
+              __func__,
+              __LINE__,
+              nameGet().c_str(),
+              name.c_str());
   }
-  LOG_ERROR("%s:%d %s Action  \"%s\" not found",
-            __func__,
-            __LINE__,
-            nameGet().c_str(),
-            name.c_str());
-  return nullptr;
+  return action_info;
 }
 
 const ActionInfo *TableInfo::actionGet(const tdi_id_t &action_id) const {
-  if (table_action_map_.find(action_id) != table_action_map_.end()) {
-    return table_action_map_.at(action_id).get();
+  const auto action_info = action_index_.find(action_id);
+  if (action_info == nullptr) {
+    LOG_ERROR("%s:%d %s Action  \"%d\" not found",
+              __func__,
+              __LINE__,
+              nameGet().c_str(),
+              action_id);
   }
-  LOG_ERROR("%s:%d %s Action  \"%d\" not found",
-            __func__,
-            __LINE__,
-            nameGet().c_str(),
-            action_id);
-  return nullptr;
+  return action_info;
 }
 
-std::vector<tdi_id_t> TableInfo::actionIdListGet() const {
-  std::vector<tdi_id_t> id_vec;
+bool TableInfo::schemaEqual(const TableInfo &other) const {
+  if (this == &other) return true;
+  if (id_ != other.id_ || name_ != other.name_) return false;
+  return SchemaCache::tableImageGet(*this) ==
+         SchemaCache::tableImageGet(other);
+}
+
+void TableInfo::indexBuild() {
+  std::vector<std::pair<tdi_id_t, const KeyFieldInfo *>> key_entries;
+  for (const auto &kv : table_key_map_) {
+    key_entries.emplace_back(kv.first, kv.second.get());
+    key_id_list_.push_back(kv.first);
+  }
+  key_index_.build(key_entries);
+
+  std::vector<std::pair<tdi_id_t, const DataFieldInfo *>> common_entries;
+  for (const auto &kv : table_data_map_) {
+    common_entries.emplace_back(kv.first, kv.second.get());
+    data_id_list_.push_back(kv.first);
+  }
+  data_index_.build(common_entries);
+
+  std::vector<std::pair<tdi_id_t, const ActionInfo *>> action_entries;
   for (const auto &kv : table_action_map_) {
-    id_vec.push_back(kv.first);
+    ActionInfo *action_info = kv.second.get();
+    action_entries.emplace_back(kv.first, action_info);
+    action_id_list_.push_back(kv.first);
+    // Action fields shadow common fields with the same ID
+    std::vector<std::pair<tdi_id_t, const DataFieldInfo *>> data_entries;
+    for (const auto &field_kv : action_info->data_fields_) {
+      data_entries.emplace_back(field_kv.first, field_kv.second.get());
+    }
+    for (const auto &entry : common_entries) {
+      if (action_info->data_fields_.find(entry.first) ==
+          action_info->data_fields_.end()) {
+        data_entries.push_back(entry);
+      }
+    }
+    action_info->data_index_.build(data_entries);
+    action_info->data_id_list_.clear();
+    for (const auto &entry : data_entries) {
+      action_info->data_id_list_.push_back(entry.first);
+    }
+    std::sort(action_info->data_id_list_.begin(),
+              action_info->data_id_list_.end());
+  }
+  action_index_.build(action_entries);
+
+  const std::vector<std::pair<std::string, const KeyFieldInfo *>> key_names(
+      name_key_map_.begin(), name_key_map_.end());
+  key_name_index_.build(key_names);
+  const std::vector<std::pair<std::string, const DataFieldInfo *>>
+      common_names(name_data_map_.begin(), name_data_map_.end());
+  data_name_index_.build(common_names);
+  const std::vector<std::pair<std::string, const ActionInfo *>> action_names(
+      name_action_map_.begin(), name_action_map_.end());
+  action_name_index_.build(action_names);
+  for (const auto &kv : table_action_map_) {
+    ActionInfo *action_info = kv.second.get();
+    std::vector<std::pair<std::string, const DataFieldInfo *>> data_names(
+        action_info->data_fields_names_.begin(),
+        action_info->data_fields_names_.end());
+    for (const auto &entry : common_names) {
+      if (action_info->data_fields_names_.find(entry.first) ==
+          action_info->data_fields_names_.end()) {
+        data_names.push_back(entry);
+      }
+    }
+    action_info->data_name_index_.build(data_names);
+  }
+
+  std::vector<tdi_id_t> data_ids;
+  for (const auto &kv : table_data_map_) {
+    dataFieldIdsCollect(*kv.second, &data_ids);
+  }
+  for (const auto &kv : table_action_map_) {
+    for (const auto &field_kv : kv.second->data_fields_) {
+      dataFieldIdsCollect(*field_kv.second, &data_ids);
+    }
+  }
+  data_ordinals_.build(std::move(data_ids));
+}
+
+void TableInfo::dataFieldIdsCollect(const DataFieldInfo &data_field,
+                                    std::vector<tdi_id_t> *ids) {
+  ids->push_back(data_field.idGet());
+  for (const auto &kv : data_field.container_) {
+    dataFieldIdsCollect(*kv.second, ids);
   }
-  std::sort(id_vec.begin(), id_vec.end());
-  return id_vec;
 }
 
 #if 0
@@ -14,6 +14,7 @@
  * limitations under the License.
  */
 
+#include <atomic>
 #include <iostream>
 #include <gtest/gtest.h>
 #include <gmock/gmock.h>
@@ -23,15 +24,24 @@
 #include <memory>
 #include <ostream>
 #include <string>
+#include <thread>
 #include <tuple>
 #include <vector>
 #include <cstring>  // std::memcmp
+#include <set>
 
+#include <dirent.h>
+#include <unistd.h>
+#include <tdi/common/c_frontend/tdi_table.h>
 #include <tdi/common/tdi_defs.h>
 #include <tdi/common/tdi_json_parser/tdi_info_parser.hpp>
 #include <tdi/common/tdi_info.hpp>
+#include <tdi/common/tdi_packed_table_key.hpp>
+#include <tdi/common/tdi_session.hpp>
 #include <tdi/common/tdi_table.hpp>
+#include <tdi/common/tdi_target.hpp>
 
+#include "c_frontend/tdi_state_c.hpp"
 #include "tdi_info_test.hpp"
 
 // using ::testing::WithParamInterface;
@@ -98,6 +108,56 @@ TEST_P(TnaExactMatchInfo, tableFromNameGet) {
   status = tdi_info->tableFromNameGet("forward", &table);
   ASSERT_EQ(status, TDI_SUCCESS);
   ASSERT_EQ(table->tableInfoGet()->nameGet(), "pipe.SwitchIngress.forward");
+
+  status = tdi_info->tableFromNameGet("Ingress.forward", &table);
+  ASSERT_EQ(status, TDI_OBJECT_NOT_FOUND);
+}
+
+/**
+ * @brief Test lazy TdiInfo. Tables are created on first lookup, once, even
+ * with concurrent lookups
+ */
+TEST_P(TnaExactMatchInfo, lazyTableFromNameGet) {
+  auto parser = std::unique_ptr<TdiInfoParser>(
+      new TdiInfoParser(std::unique_ptr<tdi::TdiInfoMapper>(
+          new tdi::tna::dummy::TdiInfoMapper())));
+  ASSERT_EQ(parser->parseTdiInfo(std::vector<std::string>(
+                {std::string(JSONDIR) + "/" + target_name + "/" +
+                 program_name + "/tdi.json"})),
+            TDI_SUCCESS);
+  auto lazy_info = tdi::TdiInfo::makeTdiInfo(
+      program_name,
+      std::move(parser),
+      std::unique_ptr<const tdi::TableFactory>(
+          new tdi::tna::dummy::TableFactory()),
+      true);
+  ASSERT_NE(lazy_info, nullptr);
+  ASSERT_TRUE(lazy_info->tableMap.empty());
+
+  const int num_threads = 4;
+  std::vector<const tdi::Table *> found(num_threads, nullptr);
+  std::vector<std::thread> threads;
+  for (int i = 0; i < num_threads; i++) {
+    threads.emplace_back([&lazy_info, &found, i]() {
+      lazy_info->tableFromNameGet("forward", &found[i]);
+    });
+  }
+  for (auto &thread : threads) thread.join();
+  ASSERT_NE(found[0], nullptr);
+  for (const auto &table : found) ASSERT_EQ(table, found[0]);
+  ASSERT_EQ(found[0]->tableInfoGet()->nameGet(), "pipe.SwitchIngress.forward");
+  ASSERT_EQ(lazy_info->tableMap.size(), 1u);
+
+  const tdi::Table *table;
+  ASSERT_EQ(lazy_info->tableFromIdGet(37882547, &table), TDI_SUCCESS);
+  ASSERT_EQ(table, found[0]);
+  ASSERT_EQ(lazy_info->tableFromNameGet("Ingress.forward", &table),
+            TDI_OBJECT_NOT_FOUND);
+
+  // Listing creates the remaining tables, same set as eager mode
+  std::vector<const tdi::Table *> table_vec;
+  ASSERT_EQ(lazy_info->tablesGet(&table_vec), TDI_SUCCESS);
+  ASSERT_EQ(table_vec.size(), tdi_info->tableMapGet().size());
 }
 
 /**
@@ -134,6 +194,44 @@ TEST_P(TnaExactMatchInfo, tableInfo_tableTypeGet) {
             TDI_DUMMY_TABLE_TYPE_MATCH_DIRECT);
 }
 
+/**
+ * @brief Test that parsing several files on a pool gives the serial result
+ */
+TEST_P(TnaExactMatchInfo, parallelParse) {
+  std::vector<std::string> paths;
+  for (const auto &program :
+       {"tna_exact_match", "tna_counter", "tna_lpm", "tna_range"}) {
+    paths.push_back(std::string(JSONDIR) + "/" + target_name + "/" +
+                    program + "/tdi.json");
+  }
+  auto parse = [&](const size_t &parse_threads) {
+    auto parser = std::unique_ptr<TdiInfoParser>(
+        new TdiInfoParser(std::unique_ptr<tdi::TdiInfoMapper>(
+                              new tdi::tna::dummy::TdiInfoMapper()),
+                          parse_threads));
+    EXPECT_EQ(parser->parseTdiInfo(paths), TDI_SUCCESS);
+    return parser;
+  };
+  auto serial = parse(1);
+  auto parallel = parse(4);
+
+  ASSERT_GT(serial->tableInfoMapGet().size(), 4u);
+  ASSERT_EQ(serial->tableInfoMapGet().size(),
+            parallel->tableInfoMapGet().size());
+  for (const auto &kv : serial->tableInfoMapGet()) {
+    ASSERT_EQ(parallel->tableInfoMapGet().count(kv.first), 1u) << kv.first;
+    const TableInfo *expected = kv.second.get();
+    const TableInfo *actual = parallel->tableInfoMapGet().at(kv.first).get();
+    ASSERT_EQ(actual->idGet(), expected->idGet());
+    ASSERT_EQ(actual->nameGet(), expected->nameGet());
+    ASSERT_EQ(actual->keyFieldIdListGet(), expected->keyFieldIdListGet());
+    ASSERT_EQ(actual->dataFieldIdListGet(), expected->dataFieldIdListGet());
+    ASSERT_EQ(actual->actionIdListGet(), expected->actionIdListGet());
+  }
+  ASSERT_EQ(serial->learnInfoMapGet().size(),
+            parallel->learnInfoMapGet().size());
+}
+
 TEST_P(TnaCounterInfo, tableInfo_tableTypeGet) {
   const tdi::Table *table;
   auto status = tdi_info->tableFromNameGet("indirect_counter", &table);
@@ -142,5 +240,1498 @@ TEST_P(TnaCounterInfo, tableInfo_tableTypeGet) {
             TDI_DUMMY_TABLE_TYPE_COUNTER);
 }
 
+/**
+ * @brief Test TableInfo field and action lookups by ID, on sparse IDs
+ */
+TEST_P(TnaRangeInfo, tableInfo_fieldGet) {
+  const tdi::Table *table;
+  auto status = tdi_info->tableFromNameGet("pipe.SwitchIngress.acl", &table);
+  ASSERT_EQ(status, TDI_SUCCESS);
+  auto table_info = table->tableInfoGet();
+
+  ASSERT_EQ(table_info->keyFieldGet(1)->nameGet(), "hdr.ipv4.protocol");
+  ASSERT_EQ(table_info->keyFieldGet(3)->nameGet(), "hdr.tcp.dst_port");
+  ASSERT_EQ(table_info->keyFieldGet(65537)->nameGet(), "$MATCH_PRIORITY");
+  ASSERT_EQ(table_info->keyFieldGet(4), nullptr);
+  ASSERT_EQ(table_info->keyFieldGet(65536), nullptr);
+  ASSERT_EQ(table_info->keyFieldGet(0), nullptr);
+
+  ASSERT_EQ(table_info->actionGet(24302497)->nameGet(),
+            "SwitchIngress.permit");
+  ASSERT_EQ(table_info->actionGet(24302496), nullptr);
+  ASSERT_EQ(table_info->dataFieldGet(1, 24302497)->nameGet(), "dst_port");
+  ASSERT_EQ(table_info->dataFieldGet(3, 24302497), nullptr);
+  // Above 2^53, so only exact integer parsing keeps it
+  ASSERT_EQ(table_info->dataFieldGet(2, 24302497)->defaultValueGet(),
+            0xfedcba9876543211ULL);
+  ASSERT_EQ(table_info->dataFieldGet(1), nullptr);
+
+  ASSERT_EQ(table_info->keyFieldGet("hdr.tcp.src_port")->idGet(), 2);
+  ASSERT_EQ(table_info->keyFieldGet("src_port"), nullptr);
+  ASSERT_EQ(table_info->actionGet("SwitchIngress.permit")->idGet(), 24302497);
+  ASSERT_EQ(table_info->dataFieldGet("dst_port", 24302497)->idGet(), 1);
+  ASSERT_EQ(table_info->dataFieldGet("dst_port"), nullptr);
+
+  ASSERT_EQ(table_info->keyFieldIdListGet(),
+            std::vector<tdi_id_t>({1, 2, 3, 65537}));
+  ASSERT_EQ(table_info->actionIdListGet(),
+            std::vector<tdi_id_t>({21257015, 24302497}));
+  ASSERT_EQ(table_info->dataFieldIdListGet(24302497),
+            std::vector<tdi_id_t>({1, 2}));
+  ASSERT_TRUE(table_info->dataFieldIdListGet().empty());
+  // Lists are built at parse time, not on every call
+  ASSERT_EQ(&table_info->dataFieldIdListGet(24302497),
+            &table_info->dataFieldIdListGet(24302497));
+}
+
+TEST_P(TnaRangeInfo, schemaCacheWarmStart) {
+  char cache_dir[] = "/tmp/tdi_schema_cache_XXXXXX";
+  ASSERT_NE(mkdtemp(cache_dir), nullptr);
+  const std::vector<std::string> paths = {std::string(JSONDIR) + "/" +
+                                          target_name + "/" + program_name +
+                                          "/tdi.json"};
+  auto parse = [&]() {
+    auto parser = std::unique_ptr<TdiInfoParser>(new TdiInfoParser(
+        std::unique_ptr<tdi::TdiInfoMapper>(
+            new tdi::tna::dummy::TdiInfoMapper())));
+    EXPECT_EQ(parser->parseTdiInfo(paths, cache_dir), TDI_SUCCESS);
+    return parser;
+  };
+  // First one parses the JSON and writes the image, second one reads it
+  auto cold = parse();
+  std::vector<std::string> images;
+  DIR *dir = opendir(cache_dir);
+  ASSERT_NE(dir, nullptr);
+  while (struct dirent *entry = readdir(dir)) {
+    if (entry->d_name[0] != '.') images.push_back(entry->d_name);
+  }
+  closedir(dir);
+  ASSERT_EQ(images.size(), 1u);
+  auto warm = parse();
+
+  ASSERT_EQ(cold->tableInfoMapGet().size(), warm->tableInfoMapGet().size());
+  for (const auto &kv : cold->tableInfoMapGet()) {
+    const TableInfo *expected = kv.second.get();
+    ASSERT_EQ(warm->tableInfoMapGet().count(kv.first), 1u) << kv.first;
+    const TableInfo *actual = warm->tableInfoMapGet().at(kv.first).get();
+    ASSERT_EQ(actual->idGet(), expected->idGet());
+    ASSERT_EQ(actual->nameGet(), expected->nameGet());
+    ASSERT_EQ(actual->tableTypeGet(), expected->tableTypeGet());
+    ASSERT_EQ(actual->sizeGet(), expected->sizeGet());
+    ASSERT_EQ(actual->keyFieldIdListGet(), expected->keyFieldIdListGet());
+    for (const auto &id : expected->keyFieldIdListGet()) {
+      ASSERT_EQ(actual->keyFieldGet(id)->nameGet(),
+                expected->keyFieldGet(id)->nameGet());
+      ASSERT_EQ(actual->keyFieldGet(id)->matchTypeGet(),
+                expected->keyFieldGet(id)->matchTypeGet());
+    }
+    ASSERT_EQ(actual->actionIdListGet(), expected->actionIdListGet());
+    for (const auto &action_id : expected->actionIdListGet()) {
+      ASSERT_EQ(actual->actionGet(action_id)->nameGet(),
+                expected->actionGet(action_id)->nameGet());
+      ASSERT_EQ(actual->dataFieldIdListGet(action_id),
+                expected->dataFieldIdListGet(action_id));
+      for (const auto &id : expected->dataFieldIdListGet(action_id)) {
+        ASSERT_EQ(actual->dataFieldGet(id, action_id)->defaultValueGet(),
+                  expected->dataFieldGet(id, action_id)->defaultValueGet());
+      }
+    }
+  }
+  ASSERT_EQ(warm->tableInfoMapGet()
+                .at("pipe.SwitchIngress.acl")
+                ->dataFieldGet(2, 24302497)
+                ->defaultValueGet(),
+            0xfedcba9876543211ULL);
+
+  for (const auto &image : images) {
+    std::remove((std::string(cache_dir) + "/" + image).c_str());
+  }
+  rmdir(cache_dir);
+}
+
+namespace {
+// Dummy tables do not look at the session or the target, so the tests use
+// trivial ones instead of going through a Device
+class TestTarget : public tdi::Target {
+ public:
+  TestTarget() : tdi::Target(0){};
+};
+
+class TestSession : public tdi::Session {
+ public:
+  TestSession() : tdi::Session({}){};
+  tdi_status_t create() override { return TDI_SUCCESS; };
+  tdi_status_t destroy() override { return TDI_SUCCESS; };
+  tdi_status_t completeOperations() const override { return TDI_SUCCESS; };
+  tdi_handle_t handleGet(const tdi_mgr_type_e & /*mgr_type*/) const override {
+    return 0;
+  };
+  tdi_status_t beginBatch() const override { return TDI_SUCCESS; };
+  tdi_status_t flushBatch() const override { return TDI_SUCCESS; };
+  tdi_status_t endBatch(bool /*hwSynchronous*/) const override {
+    return TDI_SUCCESS;
+  };
+  tdi_status_t beginTransaction(bool /*isAtomic*/) const override {
+    return TDI_SUCCESS;
+  };
+  tdi_status_t verifyTransaction() const override { return TDI_SUCCESS; };
+  tdi_status_t commitTransaction(bool /*hwSynchronous*/) const override {
+    return TDI_SUCCESS;
+  };
+  tdi_status_t abortTransaction() const override { return TDI_SUCCESS; };
+};
+
+// A table which allocates keys and data but can't reset them, like most
+// tables of real targets
+class NoResetTable : public tdi::tna::dummy::MatchActionDirect {
+ public:
+  NoResetTable(const tdi::TdiInfo *tdi_info, const tdi::TableInfo *table_info)
+      : tdi::tna::dummy::MatchActionDirect(tdi_info, table_info){};
+  using tdi::tna::dummy::MatchActionDirect::dataReset;
+  tdi_status_t keyReset(tdi::TableKey *key) const override {
+    return tdi::Table::keyReset(key);
+  };
+  tdi_status_t dataReset(tdi::TableData *data) const override {
+    return tdi::Table::dataReset(data);
+  };
+};
+}  // Anonymous namespace
+
+/**
+ * @brief Test entry add/get/mod/del on the exact match engine of the dummy
+ * MatchActionDirect table
+ */
+TEST_P(TnaExactMatchInfo, dummyExactMatchEntryOps) {
+  const tdi::Table *table;
+  auto status = tdi_info->tableFromNameGet("pipe.SwitchIngress.forward", &table);
+  ASSERT_EQ(status, TDI_SUCCESS);
+  TestSession session;
+  TestTarget dev_tgt;
+  tdi::Flags flags(0);
+  const tdi_id_t hit_id = 32848556;
+  const tdi_id_t miss_id = 17988458;
+
+  std::unique_ptr<tdi::TableKey> key;
+  std::unique_ptr<tdi::TableData> data;
+  ASSERT_EQ(table->keyAllocate(&key), TDI_SUCCESS);
+  ASSERT_EQ(table->dataAllocate(hit_id, &data), TDI_SUCCESS);
+
+  // Key field is 48 bits wide
+  ASSERT_NE(key->setValue(1, tdi::KeyFieldValueExact<const uint64_t>(
+                                 0x1000000000000ULL)),
+            TDI_SUCCESS);
+  const uint32_t num_entries = 1000;
+  for (uint32_t i = 0; i < num_entries; i++) {
+    ASSERT_EQ(key->setValue(1, tdi::KeyFieldValueExact<const uint64_t>(i)),
+              TDI_SUCCESS);
+    ASSERT_EQ(data->setValue(1, static_cast<uint64_t>(i % 512)), TDI_SUCCESS);
+    ASSERT_EQ(table->entryAdd(session, dev_tgt, flags, *key, *data),
+              TDI_SUCCESS);
+  }
+  ASSERT_EQ(table->entryAdd(session, dev_tgt, flags, *key, *data),
+            TDI_ALREADY_EXISTS);
+  uint32_t count = 0;
+  ASSERT_EQ(table->usageGet(session, dev_tgt, flags, &count), TDI_SUCCESS);
+  ASSERT_EQ(count, num_entries);
+
+  for (uint32_t i = 0; i < num_entries; i += 7) {
+    uint64_t port = 0;
+    ASSERT_EQ(key->setValue(1, tdi::KeyFieldValueExact<const uint64_t>(i)),
+              TDI_SUCCESS);
+    ASSERT_EQ(table->dataReset(data.get()), TDI_SUCCESS);
+    ASSERT_EQ(table->entryGet(session, dev_tgt, flags, *key, data.get()),
+              TDI_SUCCESS);
+    ASSERT_EQ(data->actionIdGet(), hit_id);
+    ASSERT_EQ(data->getValue(1, &port), TDI_SUCCESS);
+    ASSERT_EQ(port, i % 512);
+  }
+
+  // Change the action of one entry and delete every other entry
+  ASSERT_EQ(key->setValue(1, tdi::KeyFieldValueExact<const uint64_t>(3)),
+            TDI_SUCCESS);
+  ASSERT_EQ(table->dataReset(miss_id, data.get()), TDI_SUCCESS);
+  ASSERT_EQ(data->setValue(1, static_cast<uint64_t>(5)), TDI_SUCCESS);
+  ASSERT_EQ(table->entryMod(session, dev_tgt, flags, *key, *data),
+            TDI_SUCCESS);
+  ASSERT_EQ(table->dataReset(data.get()), TDI_SUCCESS);
+  ASSERT_EQ(table->entryGet(session, dev_tgt, flags, *key, data.get()),
+            TDI_SUCCESS);
+  ASSERT_EQ(data->actionIdGet(), miss_id);
+  for (uint32_t i = 0; i < num_entries; i += 2) {
+    ASSERT_EQ(key->setValue(1, tdi::KeyFieldValueExact<const uint64_t>(i)),
+              TDI_SUCCESS);
+    ASSERT_EQ(table->entryDel(session, dev_tgt, flags, *key), TDI_SUCCESS);
+    ASSERT_EQ(table->entryGet(session, dev_tgt, flags, *key, data.get()),
+              TDI_OBJECT_NOT_FOUND);
+  }
+  ASSERT_EQ(table->usageGet(session, dev_tgt, flags, &count), TDI_SUCCESS);
+  ASSERT_EQ(count, num_entries / 2);
+
+  // Walk the table and check every remaining key is visited once
+  std::vector<std::unique_ptr<tdi::TableKey>> keys(num_entries);
+  std::vector<std::unique_ptr<tdi::TableData>> datas(num_entries);
+  tdi::Table::keyDataPairs pairs;
+  for (uint32_t i = 0; i < num_entries; i++) {
+    table->keyAllocate(&keys[i]);
+    table->dataAllocate(&datas[i]);
+    pairs.push_back(std::make_pair(keys[i].get(), datas[i].get()));
+  }
+  ASSERT_EQ(table->entryGetFirst(session, dev_tgt, flags, key.get(),
+                                 data.get()),
+            TDI_SUCCESS);
+  uint32_t num_returned = 0;
+  ASSERT_EQ(table->entryGetNextN(session, dev_tgt, flags, *key, num_entries,
+                                 &pairs, &num_returned),
+            TDI_SUCCESS);
+  ASSERT_EQ(num_returned, num_entries / 2 - 1);
+  std::set<uint64_t> seen;
+  tdi::KeyFieldValueExact<uint64_t> first(0);
+  ASSERT_EQ(key->getValue(1, &first), TDI_SUCCESS);
+  seen.insert(first.value_);
+  for (uint32_t i = 0; i < num_returned; i++) {
+    tdi::KeyFieldValueExact<uint64_t> value(0);
+    ASSERT_EQ(pairs[i].first->getValue(1, &value), TDI_SUCCESS);
+    ASSERT_EQ(value.value_ % 2, 1);
+    seen.insert(value.value_);
+  }
+  ASSERT_EQ(seen.size(), num_entries / 2);
+
+  ASSERT_EQ(table->clear(session, dev_tgt, flags), TDI_SUCCESS);
+  ASSERT_EQ(table->usageGet(session, dev_tgt, flags, &count), TDI_SUCCESS);
+  ASSERT_EQ(count, 0);
+}
+
+/**
+ * @brief Test that the direct setters of the packed key and the
+ * KeyFieldValue setters write the same bytes
+ */
+TEST_P(TnaExactMatchInfo, packedTableKeySet) {
+  const tdi::Table *table;
+  ASSERT_EQ(tdi_info->tableFromNameGet("pipe.SwitchIngress.forward", &table),
+            TDI_SUCCESS);
+  std::unique_ptr<tdi::TableKey> key;
+  std::unique_ptr<tdi::TableKey> direct_key;
+  std::unique_ptr<tdi::TableKey> stream_key;
+  ASSERT_EQ(table->keyAllocate(&key), TDI_SUCCESS);
+  ASSERT_EQ(table->keyAllocate(&direct_key), TDI_SUCCESS);
+  ASSERT_EQ(table->keyAllocate(&stream_key), TDI_SUCCESS);
+  auto packed_key = dynamic_cast<tdi::PackedTableKey *>(key.get());
+  auto packed_direct_key =
+      dynamic_cast<tdi::PackedTableKey *>(direct_key.get());
+  auto packed_stream_key =
+      dynamic_cast<tdi::PackedTableKey *>(stream_key.get());
+  ASSERT_NE(packed_key, nullptr);
+  ASSERT_NE(packed_direct_key, nullptr);
+  ASSERT_NE(packed_stream_key, nullptr);
+
+  const uint64_t mac = 0x0a0b0c0d0e0fULL;
+  const uint8_t mac_bytes[6] = {0x0a, 0x0b, 0x0c, 0x0d, 0x0e, 0x0f};
+  ASSERT_EQ(key->setValue(1, tdi::KeyFieldValueExact<const uint64_t>(mac)),
+            TDI_SUCCESS);
+  ASSERT_EQ(packed_direct_key->setValue(1, mac), TDI_SUCCESS);
+  ASSERT_EQ(packed_stream_key->setValue(1, mac_bytes, sizeof(mac_bytes)),
+            TDI_SUCCESS);
+  const size_t size = 2 * packed_key->layoutGet()->sizeGet();
+  ASSERT_EQ(size, 12u);
+  ASSERT_EQ(std::memcmp(packed_key->valueGet(), mac_bytes, 6), 0);
+  ASSERT_EQ(
+      std::memcmp(packed_key->valueGet(), packed_direct_key->valueGet(), size),
+      0);
+  ASSERT_EQ(
+      std::memcmp(packed_key->valueGet(), packed_stream_key->valueGet(), size),
+      0);
+
+  ASSERT_EQ(packed_direct_key->setValue(2, mac), TDI_INVALID_ARG);
+  ASSERT_EQ(packed_direct_key->setValue(1, 1ULL << 48), TDI_INVALID_ARG);
+  ASSERT_EQ(packed_stream_key->setValue(1, mac_bytes, 5), TDI_INVALID_ARG);
+  // Failed sets leave the key as it was
+  ASSERT_EQ(
+      std::memcmp(packed_key->valueGet(), packed_direct_key->valueGet(), size),
+      0);
+}
+
+/**
+ * @brief Keys and data objects are recycled through the pools of a table
+ */
+TEST_P(TnaExactMatchInfo, dummyObjectPool) {
+  const tdi::Table *table;
+  ASSERT_EQ(tdi_info->tableFromNameGet("pipe.SwitchIngress.forward", &table),
+            TDI_SUCCESS);
+  size_t key_count;
+  size_t data_count;
+  // Pools are disabled by default, release just frees
+  std::unique_ptr<tdi::TableKey> key;
+  ASSERT_EQ(table->keyPoolAllocate(&key), TDI_SUCCESS);
+  ASSERT_EQ(table->keyPoolRelease(std::move(key)), TDI_SUCCESS);
+  ASSERT_EQ(table->poolUsageGet(&key_count, &data_count), TDI_SUCCESS);
+  ASSERT_EQ(key_count, 0u);
+  ASSERT_EQ(data_count, 0u);
+
+  ASSERT_EQ(table->keyPoolSizeSet(4), TDI_SUCCESS);
+  ASSERT_EQ(table->dataPoolSizeSet(2), TDI_SUCCESS);
+  ASSERT_EQ(table->poolUsageGet(&key_count, &data_count), TDI_SUCCESS);
+  ASSERT_EQ(key_count, 4u);
+  ASSERT_EQ(data_count, 2u);
+
+  // A released key comes back reset
+  std::unique_ptr<tdi::TableKey> fresh_key;
+  ASSERT_EQ(table->keyAllocate(&fresh_key), TDI_SUCCESS);
+  ASSERT_EQ(table->keyPoolAllocate(&key), TDI_SUCCESS);
+  ASSERT_EQ(table->poolUsageGet(&key_count, &data_count), TDI_SUCCESS);
+  ASSERT_EQ(key_count, 3u);
+  ASSERT_EQ(key->setValue(1, tdi::KeyFieldValueExact<const uint64_t>(7)),
+            TDI_SUCCESS);
+  ASSERT_TRUE(*key != *fresh_key);
+  const tdi::TableKey *released_key = key.get();
+  ASSERT_EQ(table->keyPoolRelease(std::move(key)), TDI_SUCCESS);
+  ASSERT_EQ(table->keyPoolAllocate(&key), TDI_SUCCESS);
+  ASSERT_EQ(key.get(), released_key);
+  ASSERT_TRUE(*key == *fresh_key);
+  ASSERT_EQ(table->keyPoolRelease(std::move(key)), TDI_SUCCESS);
+
+  // Pooled data objects are reset like new ones with the same arguments
+  const tdi_id_t action_id = table->tableInfoGet()->actionIdListGet().front();
+  std::unique_ptr<tdi::TableData> data;
+  ASSERT_EQ(table->dataPoolAllocate({}, action_id, &data), TDI_SUCCESS);
+  ASSERT_EQ(data->actionIdGet(), action_id);
+  ASSERT_TRUE(data->allFieldsSetGet());
+  ASSERT_EQ(table->dataPoolRelease(std::move(data)), TDI_SUCCESS);
+  ASSERT_EQ(table->dataPoolAllocate({}, 0, &data), TDI_SUCCESS);
+  ASSERT_EQ(data->actionIdGet(), 0u);
+  ASSERT_EQ(table->dataPoolRelease(std::move(data)), TDI_SUCCESS);
+
+  // Objects of another table are freed and refused
+  const tdi::Table *other_table;
+  ASSERT_EQ(tdi_info->tableFromNameGet("pipe.SwitchIngress.ipRoute",
+                                       &other_table),
+            TDI_SUCCESS);
+  ASSERT_EQ(other_table->keyAllocate(&key), TDI_SUCCESS);
+  ASSERT_EQ(table->keyPoolRelease(std::move(key)), TDI_INVALID_ARG);
+  ASSERT_EQ(table->poolUsageGet(&key_count, &data_count), TDI_SUCCESS);
+  ASSERT_EQ(key_count, 4u);
+  ASSERT_EQ(data_count, 2u);
+
+  // Threads allocating and releasing concurrently each keep at most the
+  // pool size
+  std::vector<std::thread> threads;
+  for (int t = 0; t < 4; t++) {
+    threads.emplace_back([table]() {
+      for (int i = 0; i < 1000; i++) {
+        std::unique_ptr<tdi::TableKey> thread_keys[6];
+        for (auto &thread_key : thread_keys) {
+          if (table->keyPoolAllocate(&thread_key) != TDI_SUCCESS) return;
+        }
+        for (auto &thread_key : thread_keys) {
+          if (table->keyPoolRelease(std::move(thread_key)) != TDI_SUCCESS) {
+            return;
+          }
+        }
+      }
+    });
+  }
+  for (auto &thread : threads) thread.join();
+  ASSERT_EQ(table->poolUsageGet(&key_count, &data_count), TDI_SUCCESS);
+  ASSERT_GE(key_count, 4u);
+  ASSERT_LE(key_count, 5 * 4u);
+
+  ASSERT_EQ(table->keyPoolSizeSet(0), TDI_SUCCESS);
+  ASSERT_EQ(table->dataPoolSizeSet(0), TDI_SUCCESS);
+  ASSERT_EQ(table->poolUsageGet(&key_count, &data_count), TDI_SUCCESS);
+  ASSERT_EQ(key_count, 0u);
+  ASSERT_EQ(data_count, 0u);
+
+  // Tables which can't reset objects refuse the pool and release still
+  // succeeds
+  NoResetTable no_reset_table(tdi_info.get(), table->tableInfoGet());
+  ASSERT_EQ(no_reset_table.keyPoolSizeSet(4), TDI_NOT_SUPPORTED);
+  ASSERT_EQ(no_reset_table.dataPoolSizeSet(2), TDI_NOT_SUPPORTED);
+  ASSERT_EQ(no_reset_table.poolUsageGet(&key_count, &data_count),
+            TDI_SUCCESS);
+  ASSERT_EQ(key_count, 0u);
+  ASSERT_EQ(data_count, 0u);
+  ASSERT_EQ(no_reset_table.keyPoolAllocate(&key), TDI_SUCCESS);
+  ASSERT_EQ(no_reset_table.keyPoolRelease(std::move(key)), TDI_SUCCESS);
+  ASSERT_EQ(no_reset_table.dataPoolAllocate({}, 0, &data), TDI_SUCCESS);
+  ASSERT_EQ(no_reset_table.dataPoolRelease(std::move(data)), TDI_SUCCESS);
+}
+
+/**
+ * @brief Test a program reload on a dummy device. The old TdiInfo stays
+ * usable and its unchanged tables share their entries with the new ones
+ */
+TEST_P(TnaExactMatchInfo, dummyProgramReload) {
+  const std::string path = std::string(JSONDIR) + "/" + target_name + "/" +
+                           program_name + "/tdi.json";
+  tdi::ProgramConfig program_config(program_name, {path}, {});
+  tdi::tna::dummy::Device device(
+      0, TDI_ARCH_TYPE_TNA, {program_config}, {}, nullptr);
+  TestSession session;
+  TestTarget dev_tgt;
+  tdi::Flags flags(0);
+  const tdi_id_t hit_id = 32848556;
+
+  std::shared_ptr<const tdi::TdiInfo> old_info;
+  ASSERT_EQ(device.tdiInfoGet(program_name, &old_info), TDI_SUCCESS);
+  const tdi::Table *old_table;
+  ASSERT_EQ(old_info->tableFromNameGet("forward", &old_table), TDI_SUCCESS);
+  std::unique_ptr<tdi::TableKey> key;
+  std::unique_ptr<tdi::TableData> data;
+  ASSERT_EQ(old_table->keyAllocate(&key), TDI_SUCCESS);
+  ASSERT_EQ(old_table->dataAllocate(hit_id, &data), TDI_SUCCESS);
+  ASSERT_EQ(key->setValue(1, tdi::KeyFieldValueExact<const uint64_t>(7)),
+            TDI_SUCCESS);
+  ASSERT_EQ(data->setValue(1, static_cast<uint64_t>(9)), TDI_SUCCESS);
+  ASSERT_EQ(old_table->entryAdd(session, dev_tgt, flags, *key, *data),
+            TDI_SUCCESS);
+
+  ASSERT_EQ(device.programReloadAsync(program_config).get(), TDI_SUCCESS);
+  std::shared_ptr<const tdi::TdiInfo> new_info;
+  ASSERT_EQ(device.tdiInfoGet(program_name, &new_info), TDI_SUCCESS);
+  ASSERT_NE(new_info, old_info);
+  const tdi::TdiInfo *raw_info;
+  ASSERT_EQ(device.tdiInfoGet(program_name, &raw_info), TDI_SUCCESS);
+  ASSERT_EQ(raw_info, new_info.get());
+  const tdi::Table *new_table;
+  ASSERT_EQ(new_info->tableFromNameGet("forward", &new_table), TDI_SUCCESS);
+  ASSERT_NE(new_table, old_table);
+  ASSERT_TRUE(
+      new_table->tableInfoGet()->schemaEqual(*old_table->tableInfoGet()));
+
+  // The entry added through the old table is carried over
+  std::unique_ptr<tdi::TableKey> new_key;
+  std::unique_ptr<tdi::TableData> new_data;
+  ASSERT_EQ(new_table->keyAllocate(&new_key), TDI_SUCCESS);
+  ASSERT_EQ(new_table->dataAllocate(&new_data), TDI_SUCCESS);
+  ASSERT_EQ(new_key->setValue(1, tdi::KeyFieldValueExact<const uint64_t>(7)),
+            TDI_SUCCESS);
+  uint64_t port = 0;
+  ASSERT_EQ(
+      new_table->entryGet(session, dev_tgt, flags, *new_key, new_data.get()),
+      TDI_SUCCESS);
+  ASSERT_EQ(new_data->actionIdGet(), hit_id);
+  ASSERT_EQ(new_data->getValue(1, &port), TDI_SUCCESS);
+  ASSERT_EQ(port, 9u);
+  // And both tables see the same entries during the grace period
+  ASSERT_EQ(old_table->entryDel(session, dev_tgt, flags, *key), TDI_SUCCESS);
+  uint32_t count = 1;
+  ASSERT_EQ(new_table->usageGet(session, dev_tgt, flags, &count),
+            TDI_SUCCESS);
+  ASSERT_EQ(count, 0u);
+
+  // The reference keeps the old TdiInfo alive past the grace period
+  ASSERT_EQ(device.tdiInfoRetiredRelease(), TDI_SUCCESS);
+  ASSERT_EQ(old_info->tableFromNameGet("forward", &old_table), TDI_SUCCESS);
+  ASSERT_EQ(old_table->usageGet(session, dev_tgt, flags, &count),
+            TDI_SUCCESS);
+
+  tdi::ProgramConfig unknown_config("unknown", {path}, {});
+  ASSERT_EQ(device.programReload(unknown_config), TDI_OBJECT_NOT_FOUND);
+}
+
+/**
+ * @brief Test adding and removing devices while other threads look them up
+ */
+TEST_P(TnaExactMatchInfo, devMgrConcurrentLookup) {
+  const std::string path = std::string(JSONDIR) + "/" + target_name + "/" +
+                           program_name + "/tdi.json";
+  tdi::ProgramConfig program_config(program_name, {path}, {});
+  auto &dev_mgr = tdi::DevMgr::getInstance();
+  ASSERT_EQ(&dev_mgr, &tdi::DevMgr::getInstance());
+  const tdi_dev_id_t dev_id = 7;
+
+  std::atomic<bool> done(false);
+  std::atomic<uint32_t> found(0);
+  std::vector<std::thread> readers;
+  for (int i = 0; i < 4; i++) {
+    readers.emplace_back([&]() {
+      while (!done.load()) {
+        // The reference keeps the Device alive across a concurrent remove
+        std::shared_ptr<const tdi::Device> device;
+        if (dev_mgr.deviceGet(dev_id, &device) == TDI_SUCCESS) {
+          const tdi::TdiInfo *info = nullptr;
+          if (device->tdiInfoGet(program_name, &info) == TDI_SUCCESS &&
+              info != nullptr) {
+            found++;
+          }
+        }
+      }
+    });
+  }
+  for (int i = 0; i < 20; i++) {
+    ASSERT_EQ(dev_mgr.deviceAdd<tdi::tna::dummy::Device>(
+                  dev_id, TDI_ARCH_TYPE_TNA, {program_config}, {}, nullptr),
+              TDI_SUCCESS);
+    ASSERT_EQ(dev_mgr.deviceAdd<tdi::tna::dummy::Device>(
+                  dev_id, TDI_ARCH_TYPE_TNA, {program_config}, {}, nullptr),
+              TDI_ALREADY_EXISTS);
+    std::set<tdi_dev_id_t> dev_ids;
+    ASSERT_EQ(dev_mgr.deviceIdListGet(&dev_ids), TDI_SUCCESS);
+    ASSERT_EQ(dev_ids.count(dev_id), 1u);
+    ASSERT_EQ(dev_mgr.deviceRemove(dev_id), TDI_SUCCESS);
+  }
+  done = true;
+  for (auto &reader : readers) {
+    reader.join();
+  }
+  // A held reference outlives the removal
+  ASSERT_EQ(dev_mgr.deviceAdd<tdi::tna::dummy::Device>(
+                dev_id, TDI_ARCH_TYPE_TNA, {program_config}, {}, nullptr),
+            TDI_SUCCESS);
+  std::shared_ptr<const tdi::Device> held;
+  ASSERT_EQ(dev_mgr.deviceGet(dev_id, &held), TDI_SUCCESS);
+  std::weak_ptr<const tdi::Device> watched = held;
+  ASSERT_EQ(dev_mgr.deviceRemove(dev_id), TDI_SUCCESS);
+  ASSERT_FALSE(watched.expired());
+  const tdi::TdiInfo *held_info = nullptr;
+  ASSERT_EQ(held->tdiInfoGet(program_name, &held_info), TDI_SUCCESS);
+  held.reset();
+  ASSERT_TRUE(watched.expired());
+
+  const tdi::Device *device = nullptr;
+  ASSERT_EQ(dev_mgr.deviceGet(dev_id, &device), TDI_OBJECT_NOT_FOUND);
+  ASSERT_EQ(dev_mgr.deviceGet(tdi::DevMgr::kMaxDevices, &device),
+            TDI_OBJECT_NOT_FOUND);
+  ASSERT_EQ(dev_mgr.deviceAdd<tdi::tna::dummy::Device>(
+                tdi::DevMgr::kMaxDevices,
+                TDI_ARCH_TYPE_TNA,
+                {program_config},
+                {},
+                nullptr),
+            TDI_INVALID_ARG);
+}
+
+/**
+ * @brief Test the C frontend session registry from several threads
+ */
+TEST(TdiCFrontEnd, sessionStateConcurrent) {
+  auto &c_state = tdi::tdi_c::TdiCFrontEndSessionState::getInstance();
+  ASSERT_EQ(c_state.getSharedPtr(nullptr), nullptr);
+
+  const int num_threads = 4;
+  const int num_sessions = 200;
+  std::atomic<int> failures(0);
+  std::vector<std::thread> threads;
+  for (int t = 0; t < num_threads; t++) {
+    threads.emplace_back([&]() {
+      std::vector<std::shared_ptr<tdi::Session>> sessions;
+      for (int i = 0; i < num_sessions; i++) {
+        sessions.push_back(std::make_shared<TestSession>());
+        c_state.insertShared(sessions.back());
+      }
+      for (const auto &session : sessions) {
+        if (c_state.getSharedPtr(session.get()) != session) failures++;
+        c_state.removeShared(session.get());
+        if (c_state.getSharedPtr(session.get()) != nullptr) failures++;
+      }
+    });
+  }
+  for (auto &thread : threads) {
+    thread.join();
+  }
+  ASSERT_EQ(failures.load(), 0);
+
+  // The registry keeps a session alive until it is removed
+  auto session = std::make_shared<TestSession>();
+  const tdi::Session *session_raw = session.get();
+  c_state.insertShared(session);
+  c_state.insertShared(session);
+  session.reset();
+  auto session_ref = c_state.getSharedPtr(session_raw);
+  ASSERT_EQ(session_ref.get(), session_raw);
+  ASSERT_EQ(session_ref.use_count(), 2);
+  c_state.removeShared(session_raw);
+  c_state.removeShared(session_raw);
+  ASSERT_EQ(session_ref.use_count(), 1);
+}
+
+/**
+ * @brief Test task submission, batches and parallelFor on the work-stealing
+ * pool, including parallelFor from inside a task of the same pool
+ */
+TEST(TdiThreadPool, workStealing) {
+  tdi::TdiThreadPool thread_pool(4, {0});
+  ASSERT_EQ(thread_pool.numThreadsGet(), 4u);
+  auto sum = thread_pool.submitTask([](int a, int b) { return a + b; }, 2, 3);
+  ASSERT_EQ(sum.get(), 5);
+
+  std::vector<std::function<size_t()>> fns;
+  for (size_t i = 0; i < 100; i++) {
+    fns.push_back([i]() { return i * i; });
+  }
+  auto futures = thread_pool.submitTasks(std::move(fns));
+  ASSERT_EQ(futures.size(), 100u);
+  for (size_t i = 0; i < futures.size(); i++) {
+    ASSERT_EQ(futures[i].get(), i * i);
+  }
+
+  std::vector<std::atomic<uint32_t>> hits(100010);
+  for (auto &hit : hits) hit = 0;
+  thread_pool.parallelFor(
+      10, hits.size(), [&hits](const size_t &i) { hits[i]++; });
+  for (size_t i = 0; i < hits.size(); i++) {
+    ASSERT_EQ(hits[i].load(), i < 10 ? 0u : 1u);
+  }
+
+  // Every task runs a parallelFor of its own on the same pool
+  std::vector<std::future<uint64_t>> nested;
+  for (int t = 0; t < 8; t++) {
+    nested.push_back(thread_pool.submitTask([&thread_pool]() {
+      std::atomic<uint64_t> total(0);
+      thread_pool.parallelFor(
+          0, 1000, [&total](const size_t &i) { total += i; }, 7);
+      return total.load();
+    }));
+  }
+  for (auto &future : nested) {
+    ASSERT_EQ(future.get(), 499500u);
+  }
+
+  ASSERT_THROW(thread_pool.parallelFor(0,
+                                       1000,
+                                       [](const size_t &i) {
+                                         if (i == 500) {
+                                           throw std::runtime_error("fail");
+                                         }
+                                       }),
+               std::runtime_error);
+}
+
+/**
+ * @brief Test byte order conversion of fields of any width, in place and
+ * in batches, against a plain byte reversal
+ */
+TEST(TdiEndiannessHandler, anyWidth) {
+  for (size_t size = 0; size <= 100; size++) {
+    std::vector<uint8_t> value(size);
+    for (size_t i = 0; i < size; i++) value[i] = static_cast<uint8_t>(i * 7);
+    std::vector<uint8_t> host(size);
+    tdi::TdiEndiannessHandler::toHostOrder(size, value.data(), host.data());
+    std::vector<uint8_t> expected(value.rbegin(), value.rend());
+    ASSERT_EQ(host, expected) << "size " << size;
+    tdi::TdiEndiannessHandler::toNetworkOrder(size, host.data(), host.data());
+    ASSERT_EQ(host, value) << "size " << size;
+  }
+
+  // IPv6 addresses and odd widths in batches
+  for (const size_t size : {2, 4, 6, 8, 16, 17}) {
+    const size_t count = 9;
+    std::vector<uint8_t> values(size * count);
+    for (size_t i = 0; i < values.size(); i++) {
+      values[i] = static_cast<uint8_t>(i * 13 + 1);
+    }
+    std::vector<uint8_t> host(values.size());
+    tdi::TdiEndiannessHandler::toHostOrderBatch(
+        size, count, values.data(), host.data());
+    for (size_t i = 0; i < count; i++) {
+      std::vector<uint8_t> field(size);
+      tdi::TdiEndiannessHandler::toHostOrder(
+          size, values.data() + size * i, field.data());
+      ASSERT_EQ(std::memcmp(field.data(), host.data() + size * i, size), 0)
+          << "size " << size << " field " << i;
+    }
+    tdi::TdiEndiannessHandler::toNetworkOrderBatch(
+        size, count, host.data(), host.data());
+    ASSERT_EQ(host, values) << "size " << size;
+
+    if (size > 8) continue;
+    std::vector<uint64_t> host_values(count);
+    tdi::TdiEndiannessHandler::toHostOrderBatch(
+        size, count, values.data(), host_values.data());
+    std::vector<uint8_t> network(values.size());
+    for (size_t i = 0; i < count; i++) {
+      uint64_t host_value = 0;
+      tdi::TdiEndiannessHandler::toHostOrder(
+          size, values.data() + size * i, &host_value);
+      ASSERT_EQ(host_values[i], host_value);
+    }
+    tdi::TdiEndiannessHandler::toNetworkOrderBatch(
+        size, count, host_values.data(), network.data());
+    ASSERT_EQ(network, values) << "size " << size;
+  }
+}
+
+/**
+ * @brief Test the batch add, mod and delete calls and their per entry
+ * statuses
+ */
+TEST_P(TnaExactMatchInfo, dummyBatchEntryOps) {
+  const tdi::Table *table;
+  auto status = tdi_info->tableFromNameGet("pipe.SwitchIngress.forward", &table);
+  ASSERT_EQ(status, TDI_SUCCESS);
+  TestSession session;
+  TestTarget dev_tgt;
+  tdi::Flags flags(0);
+  const tdi_id_t hit_id = 32848556;
+
+  const uint32_t num_entries = 500;
+  std::vector<std::unique_ptr<tdi::TableKey>> key_objs(num_entries);
+  std::vector<std::unique_ptr<tdi::TableData>> data_objs(num_entries);
+  std::vector<const tdi::TableKey *> keys;
+  std::vector<const tdi::TableData *> datas;
+  for (uint32_t i = 0; i < num_entries; i++) {
+    ASSERT_EQ(table->keyAllocate(&key_objs[i]), TDI_SUCCESS);
+    ASSERT_EQ(table->dataAllocate(hit_id, &data_objs[i]), TDI_SUCCESS);
+    // The last key repeats the first one
+    const uint64_t mac = i % (num_entries - 1);
+    ASSERT_EQ(key_objs[i]->setValue(
+                  1, tdi::KeyFieldValueExact<const uint64_t>(mac)),
+              TDI_SUCCESS);
+    ASSERT_EQ(data_objs[i]->setValue(1, static_cast<uint64_t>(i % 512)),
+              TDI_SUCCESS);
+    keys.push_back(key_objs[i].get());
+    datas.push_back(data_objs[i].get());
+  }
+  keys.push_back(nullptr);
+  datas.push_back(data_objs[0].get());
+
+  std::vector<tdi_status_t> statuses;
+  ASSERT_EQ(table->entryAddBatch(session, dev_tgt, flags, keys, datas,
+                                 &statuses),
+            TDI_ALREADY_EXISTS);
+  ASSERT_EQ(statuses.size(), keys.size());
+  for (uint32_t i = 0; i < num_entries - 1; i++) {
+    ASSERT_EQ(statuses[i], TDI_SUCCESS);
+  }
+  ASSERT_EQ(statuses[num_entries - 1], TDI_ALREADY_EXISTS);
+  ASSERT_EQ(statuses[num_entries], TDI_INVALID_ARG);
+  uint32_t count = 0;
+  ASSERT_EQ(table->usageGet(session, dev_tgt, flags, &count), TDI_SUCCESS);
+  ASSERT_EQ(count, num_entries - 1);
+
+  // Mismatched keys and data are rejected as a whole
+  datas.pop_back();
+  ASSERT_EQ(table->entryModBatch(session, dev_tgt, flags, keys, datas,
+                                 &statuses),
+            TDI_INVALID_ARG);
+  keys.pop_back();
+  keys.pop_back();
+  datas.pop_back();
+  for (uint32_t i = 0; i < num_entries - 1; i++) {
+    ASSERT_EQ(data_objs[i]->setValue(1, static_cast<uint64_t>(7)),
+              TDI_SUCCESS);
+  }
+  ASSERT_EQ(table->entryModBatch(session, dev_tgt, flags, keys, datas,
+                                 &statuses),
+            TDI_SUCCESS);
+  std::unique_ptr<tdi::TableData> data;
+  ASSERT_EQ(table->dataAllocate(&data), TDI_SUCCESS);
+  uint64_t port = 0;
+  ASSERT_EQ(table->entryGet(session, dev_tgt, flags, *keys[42], data.get()),
+            TDI_SUCCESS);
+  ASSERT_EQ(data->getValue(1, &port), TDI_SUCCESS);
+  ASSERT_EQ(port, 7);
+
+  // Read back every entry plus one that was never added
+  std::unique_ptr<tdi::TableKey> missing;
+  ASSERT_EQ(table->keyAllocate(&missing), TDI_SUCCESS);
+  ASSERT_EQ(missing->setValue(1, tdi::KeyFieldValueExact<const uint64_t>(
+                                     0xabcdefULL)),
+            TDI_SUCCESS);
+  std::vector<const tdi::TableKey *> get_keys(keys);
+  std::vector<tdi::TableData *> get_datas;
+  get_keys.push_back(missing.get());
+  for (uint32_t i = 0; i < get_keys.size(); i++) {
+    ASSERT_EQ(data_objs[i]->setValue(1, static_cast<uint64_t>(0)),
+              TDI_SUCCESS);
+    get_datas.push_back(data_objs[i].get());
+  }
+  ASSERT_EQ(table->entryGetBatch(session, dev_tgt, flags, get_keys,
+                                 get_datas, &statuses),
+            TDI_OBJECT_NOT_FOUND);
+  for (uint32_t i = 0; i < keys.size(); i++) {
+    ASSERT_EQ(statuses[i], TDI_SUCCESS);
+    ASSERT_EQ(get_datas[i]->getValue(1, &port), TDI_SUCCESS);
+    ASSERT_EQ(port, 7);
+  }
+  ASSERT_EQ(statuses.back(), TDI_OBJECT_NOT_FOUND);
+
+  // Same through the C frontend
+  std::vector<tdi_status_t> c_statuses(get_keys.size());
+  ASSERT_EQ(tdi_table_entry_get_batch(
+                reinterpret_cast<const tdi_table_hdl *>(table),
+                reinterpret_cast<const tdi_session_hdl *>(&session),
+                reinterpret_cast<const tdi_target_hdl *>(&dev_tgt),
+                reinterpret_cast<const tdi_flags_hdl *>(&flags),
+                reinterpret_cast<const tdi_table_key_hdl **>(get_keys.data()),
+                reinterpret_cast<tdi_table_data_hdl **>(get_datas.data()),
+                static_cast<uint32_t>(get_keys.size()),
+                c_statuses.data()),
+            TDI_OBJECT_NOT_FOUND);
+  ASSERT_EQ(c_statuses, statuses);
+
+  ASSERT_EQ(table->entryDelBatch(session, dev_tgt, flags, keys, &statuses),
+            TDI_SUCCESS);
+  ASSERT_EQ(table->entryDelBatch(session, dev_tgt, flags, keys, &statuses),
+            TDI_OBJECT_NOT_FOUND);
+  ASSERT_EQ(statuses.back(), TDI_OBJECT_NOT_FOUND);
+  ASSERT_EQ(table->usageGet(session, dev_tgt, flags, &count), TDI_SUCCESS);
+  ASSERT_EQ(count, 0);
+}
+
+/**
+ * @brief Test paging through a table with live and snapshot cursors
+ */
+TEST_P(TnaExactMatchInfo, dummyCursorWalk) {
+  const tdi::Table *table;
+  auto status = tdi_info->tableFromNameGet("pipe.SwitchIngress.forward", &table);
+  ASSERT_EQ(status, TDI_SUCCESS);
+  TestSession session;
+  TestTarget dev_tgt;
+  tdi::Flags flags(0);
+  const tdi_id_t hit_id = 32848556;
+
+  std::unique_ptr<tdi::TableKey> key;
+  std::unique_ptr<tdi::TableData> data;
+  ASSERT_EQ(table->keyAllocate(&key), TDI_SUCCESS);
+  ASSERT_EQ(table->dataAllocate(hit_id, &data), TDI_SUCCESS);
+  const uint32_t num_entries = 1000;
+  for (uint32_t i = 0; i < num_entries; i++) {
+    ASSERT_EQ(key->setValue(1, tdi::KeyFieldValueExact<const uint64_t>(i)),
+              TDI_SUCCESS);
+    ASSERT_EQ(data->setValue(1, static_cast<uint64_t>(i % 512)), TDI_SUCCESS);
+    ASSERT_EQ(table->entryAdd(session, dev_tgt, flags, *key, *data),
+              TDI_SUCCESS);
+  }
+
+  // One page worth of key and data objects, reused for every page
+  const uint32_t page_size = 64;
+  std::vector<std::unique_ptr<tdi::TableKey>> key_objs(page_size);
+  std::vector<std::unique_ptr<tdi::TableData>> data_objs(page_size);
+  std::vector<tdi::TableKey *> keys;
+  std::vector<tdi::TableData *> datas;
+  for (uint32_t i = 0; i < page_size; i++) {
+    ASSERT_EQ(table->keyAllocate(&key_objs[i]), TDI_SUCCESS);
+    ASSERT_EQ(table->dataAllocate(&data_objs[i]), TDI_SUCCESS);
+    keys.push_back(key_objs[i].get());
+    datas.push_back(data_objs[i].get());
+  }
+  auto walk = [&](tdi::TableCursor *cursor,
+                  std::set<uint64_t> *seen) -> tdi_status_t {
+    uint32_t num_returned = 0;
+    do {
+      auto sts =
+          cursor->next(page_size, keys.data(), datas.data(), &num_returned);
+      if (sts != TDI_SUCCESS) return sts;
+      for (uint32_t i = 0; i < num_returned; i++) {
+        tdi::KeyFieldValueExact<uint64_t> mac(0);
+        uint64_t port = 0;
+        keys[i]->getValue(1, &mac);
+        datas[i]->getValue(1, &port);
+        if (port != mac.value_ % 512) return TDI_INVALID_ARG;
+        seen->insert(mac.value_);
+      }
+    } while (num_returned == page_size);
+    return TDI_SUCCESS;
+  };
+
+  std::unique_ptr<tdi::TableCursor> live, snapshot;
+  ASSERT_EQ(table->cursorAllocate(session, dev_tgt, flags, false, &live),
+            TDI_SUCCESS);
+  ASSERT_EQ(table->cursorAllocate(session, dev_tgt, flags, true, &snapshot),
+            TDI_SUCCESS);
+  ASSERT_TRUE(snapshot->snapshotGet());
+  std::set<uint64_t> seen;
+  ASSERT_EQ(walk(live.get(), &seen), TDI_SUCCESS);
+  ASSERT_EQ(seen.size(), num_entries);
+
+  // Deletes show up on a live cursor but not on the snapshot
+  for (uint32_t i = 0; i < num_entries; i += 2) {
+    ASSERT_EQ(key->setValue(1, tdi::KeyFieldValueExact<const uint64_t>(i)),
+              TDI_SUCCESS);
+    ASSERT_EQ(table->entryDel(session, dev_tgt, flags, *key), TDI_SUCCESS);
+  }
+  seen.clear();
+  ASSERT_EQ(walk(snapshot.get(), &seen), TDI_SUCCESS);
+  ASSERT_EQ(seen.size(), num_entries);
+  seen.clear();
+  ASSERT_EQ(live->reset(), TDI_SUCCESS);
+  ASSERT_EQ(walk(live.get(), &seen), TDI_SUCCESS);
+  ASSERT_EQ(seen.size(), num_entries / 2);
+  seen.clear();
+  ASSERT_EQ(snapshot->reset(), TDI_SUCCESS);
+  ASSERT_EQ(walk(snapshot.get(), &seen), TDI_SUCCESS);
+  ASSERT_EQ(seen.size(), num_entries / 2);
+  ASSERT_EQ(table->clear(session, dev_tgt, flags), TDI_SUCCESS);
+}
+
+/**
+ * @brief Test hashing, equality and ordering of keys, with ternary values
+ * compared under their mask, and equality of data objects over their
+ * active fields
+ */
+TEST_P(TnaCounterInfo, keyDataEquality) {
+  const tdi::Table *table;
+  ASSERT_EQ(tdi_info->tableFromNameGet("pipe.SwitchIngress.forward", &table),
+            TDI_SUCCESS);
+  const tdi_id_t src_addr_id = 1;
+  const tdi_id_t priority_id = 65537;
+  const tdi_id_t hit_id = 32848556;
+
+  auto make_key = [&](const uint64_t &value,
+                      const uint64_t &mask,
+                      std::unique_ptr<tdi::TableKey> *key) {
+    ASSERT_EQ(table->keyAllocate(key), TDI_SUCCESS);
+    ASSERT_EQ((*key)->setValue(
+                  src_addr_id,
+                  tdi::KeyFieldValueTernary<const uint64_t>(value, mask)),
+              TDI_SUCCESS);
+    ASSERT_EQ((*key)->setValue(priority_id,
+                               tdi::KeyFieldValueExact<const uint64_t>(5)),
+              TDI_SUCCESS);
+  };
+  std::unique_ptr<tdi::TableKey> key;
+  std::unique_ptr<tdi::TableKey> same_key;
+  std::unique_ptr<tdi::TableKey> other_key;
+  make_key(0x0a0b0c0d0e0fULL, 0xffff00000000ULL, &key);
+  // Differs only in bits outside the mask
+  make_key(0x0a0b00000000ULL, 0xffff00000000ULL, &same_key);
+  make_key(0x0a0b00000000ULL, 0xffffff000000ULL, &other_key);
+  ASSERT_TRUE(*key == *same_key);
+  ASSERT_EQ(std::hash<tdi::TableKey>()(*key),
+            std::hash<tdi::TableKey>()(*same_key));
+  ASSERT_FALSE(*key < *same_key);
+  ASSERT_FALSE(*same_key < *key);
+  ASSERT_TRUE(*key != *other_key);
+  ASSERT_NE(*key < *other_key, *other_key < *key);
+
+  // Keys of another table never compare equal
+  const tdi::Table *other_table;
+  ASSERT_EQ(
+      tdi_info->tableFromNameGet("pipe.SwitchIngress.forward_exact",
+                                 &other_table),
+      TDI_SUCCESS);
+  std::unique_ptr<tdi::TableKey> other_table_key;
+  ASSERT_EQ(other_table->keyAllocate(&other_table_key), TDI_SUCCESS);
+  ASSERT_TRUE(*key != *other_table_key);
+  ASSERT_NE(*key < *other_table_key, *other_table_key < *key);
+
+  std::unique_ptr<tdi::TableData> data;
+  std::unique_ptr<tdi::TableData> same_data;
+  std::unique_ptr<tdi::TableData> hit_only_data;
+  ASSERT_EQ(table->dataAllocate(hit_id, &data), TDI_SUCCESS);
+  ASSERT_EQ(table->dataAllocate(hit_id, &same_data), TDI_SUCCESS);
+  ASSERT_EQ(table->dataAllocate({1}, hit_id, &hit_only_data), TDI_SUCCESS);
+  ASSERT_TRUE(*data == *same_data);
+  ASSERT_EQ(data->setValue(1, static_cast<uint64_t>(3)), TDI_SUCCESS);
+  ASSERT_TRUE(*data != *same_data);
+  ASSERT_EQ(same_data->setValue(1, static_cast<uint64_t>(3)), TDI_SUCCESS);
+  ASSERT_TRUE(*data == *same_data);
+  ASSERT_EQ(hit_only_data->setValue(1, static_cast<uint64_t>(3)),
+            TDI_SUCCESS);
+  // Same values, but the counter fields are only active in data
+  ASSERT_TRUE(*data != *hit_only_data);
+  // The explicit list of all the fields of the action is the same
+  std::vector<tdi_id_t> all_fields =
+      table->tableInfoGet()->dataFieldIdListGet(hit_id);
+  std::unique_ptr<tdi::TableData> listed_data;
+  ASSERT_EQ(table->dataAllocate(all_fields, hit_id, &listed_data),
+            TDI_SUCCESS);
+  ASSERT_EQ(listed_data->setValue(1, static_cast<uint64_t>(3)), TDI_SUCCESS);
+  ASSERT_TRUE(*data == *listed_data);
+}
+
+/**
+ * Byte array values are adopted on set and viewed in place on get
+ */
+TEST_P(TnaCounterInfo, dataValueView) {
+  const tdi::Table *table;
+  ASSERT_EQ(tdi_info->tableFromNameGet("pipe.SwitchIngress.forward", &table),
+            TDI_SUCCESS);
+  const tdi_id_t hit_id = 32848556;
+  const tdi::DataFieldInfo *field_info =
+      table->tableInfoGet()->dataFieldGet(1, hit_id);
+  ASSERT_NE(field_info, nullptr);
+  const size_t size = (field_info->sizeGet() + 7) / 8;
+  ASSERT_GE(size, 1u);
+
+  std::unique_ptr<tdi::TableData> data;
+  ASSERT_EQ(table->dataAllocate(hit_id, &data), TDI_SUCCESS);
+  const uint8_t *view;
+  size_t view_size;
+  ASSERT_EQ(data->getValueView(1, &view, &view_size), TDI_OBJECT_NOT_FOUND);
+
+  // A vector of the wrong size is refused and left as it was
+  std::vector<uint8_t> bad_bytes(size + 1, 0x5a);
+  ASSERT_EQ(data->setValue(1, std::move(bad_bytes)), TDI_INVALID_ARG);
+  ASSERT_EQ(bad_bytes.size(), size + 1);
+
+  std::vector<uint8_t> bytes(size, 0);
+  bytes.back() = 0x2a;
+  const uint8_t *buffer = bytes.data();
+  ASSERT_EQ(data->setValue(1, std::move(bytes)), TDI_SUCCESS);
+  ASSERT_EQ(data->getValueView(1, &view, &view_size), TDI_SUCCESS);
+  // The dummy target keeps the vector it was given
+  ASSERT_EQ(view, buffer);
+  ASSERT_EQ(view_size, size);
+  ASSERT_EQ(view[size - 1], 0x2a);
+  uint64_t value = 0;
+  ASSERT_EQ(data->getValue(1, &value), TDI_SUCCESS);
+  ASSERT_EQ(value, 0x2au);
+  std::vector<uint8_t> copied(size);
+  ASSERT_EQ(data->getValue(1, size, copied.data()), TDI_SUCCESS);
+  ASSERT_EQ(std::memcmp(copied.data(), view, size), 0);
+
+  // Inactive fields have no view
+  std::unique_ptr<tdi::TableData> other_data;
+  const auto &all_fields = table->tableInfoGet()->dataFieldIdListGet(hit_id);
+  ASSERT_GE(all_fields.size(), 2u);
+  const tdi_id_t other_id = all_fields[0] == 1 ? all_fields[1] : all_fields[0];
+  ASSERT_EQ(table->dataAllocate({other_id}, hit_id, &other_data),
+            TDI_SUCCESS);
+  ASSERT_EQ(other_data->getValueView(1, &view, &view_size),
+            TDI_INVALID_ARG);
+}
+
+/**
+ * Active fields of data objects are tracked by field ordinal
+ */
+TEST_P(TnaCounterInfo, dataActiveFields) {
+  const tdi::Table *table;
+  ASSERT_EQ(tdi_info->tableFromNameGet("pipe.SwitchIngress.forward", &table),
+            TDI_SUCCESS);
+  const tdi_id_t hit_id = 32848556;
+  const auto &all_fields = table->tableInfoGet()->dataFieldIdListGet(hit_id);
+  ASSERT_GE(all_fields.size(), 2u);
+
+  const tdi::IdOrdinals &ordinals =
+      table->tableInfoGet()->dataFieldOrdinalsGet();
+  ASSERT_GE(ordinals.sizeGet(), all_fields.size());
+  std::set<size_t> seen;
+  for (const auto &field_id : all_fields) {
+    size_t ordinal;
+    ASSERT_TRUE(ordinals.find(field_id, &ordinal));
+    ASSERT_LT(ordinal, ordinals.sizeGet());
+    ASSERT_EQ(ordinals.idGet(ordinal), field_id);
+    ASSERT_TRUE(seen.insert(ordinal).second);
+  }
+
+  const std::vector<tdi_id_t> fields = {all_fields[1], all_fields[0]};
+  std::unique_ptr<tdi::TableData> data;
+  ASSERT_EQ(table->dataAllocate(fields, hit_id, &data), TDI_SUCCESS);
+  ASSERT_FALSE(data->allFieldsSetGet());
+  ASSERT_EQ(data->activeFieldsGet(),
+            std::set<tdi_id_t>(fields.begin(), fields.end()));
+  for (const auto &field_id : all_fields) {
+    bool is_active;
+    ASSERT_EQ(data->isActive(field_id, &is_active), TDI_SUCCESS);
+    ASSERT_EQ(is_active,
+              field_id == all_fields[0] || field_id == all_fields[1]);
+  }
+
+  const std::set<tdi_id_t> &active_fields = data->activeFieldsGet();
+  data->removeActiveField(all_fields[0]);
+  // The getter rebuilds the set in place, concurrent readers included
+  std::vector<std::thread> readers;
+  std::atomic<int> mismatches(0);
+  for (int i = 0; i < 4; i++) {
+    readers.emplace_back([&]() {
+      if (&data->activeFieldsGet() != &active_fields ||
+          data->activeFieldsGet() != std::set<tdi_id_t>({all_fields[1]})) {
+        mismatches++;
+      }
+    });
+  }
+  for (auto &reader : readers) reader.join();
+  ASSERT_EQ(mismatches.load(), 0);
+  ASSERT_EQ(&active_fields, &data->activeFieldsGet());
+  ASSERT_EQ(active_fields, std::set<tdi_id_t>({all_fields[1]}));
+  bool is_active;
+  ASSERT_EQ(data->isActive(all_fields[0], &is_active), TDI_SUCCESS);
+  ASSERT_FALSE(is_active);
+  ASSERT_EQ(data->isActive(all_fields[1], &is_active), TDI_SUCCESS);
+  ASSERT_TRUE(is_active);
+  ASSERT_EQ(data->activeFieldsGet(), std::set<tdi_id_t>({all_fields[1]}));
+
+  // Reset to all fields clears the removed ones too
+  ASSERT_EQ(data->reset(hit_id), TDI_SUCCESS);
+  ASSERT_TRUE(data->allFieldsSetGet());
+  ASSERT_TRUE(data->activeFieldsGet().empty());
+  for (const auto &field_id : all_fields) {
+    ASSERT_EQ(data->isActive(field_id, &is_active), TDI_SUCCESS);
+    ASSERT_TRUE(is_active);
+  }
+  // Removing from all fields only marks the field removed
+  data->removeActiveField(all_fields[1]);
+  ASSERT_TRUE(data->allFieldsSetGet());
+  ASSERT_EQ(data->isActive(all_fields[1], &is_active), TDI_SUCCESS);
+  ASSERT_FALSE(is_active);
+  ASSERT_EQ(data->isActive(all_fields[0], &is_active), TDI_SUCCESS);
+  ASSERT_TRUE(is_active);
+}
+
+/**
+ * @brief Test priority based lookups on the ternary classifier of the dummy
+ * MatchActionDirect table
+ */
+TEST_P(TnaCounterInfo, dummyTernaryMatchLookup) {
+  const tdi::Table *table;
+  auto status = tdi_info->tableFromNameGet("pipe.SwitchIngress.forward", &table);
+  ASSERT_EQ(status, TDI_SUCCESS);
+  auto dummy_table =
+      static_cast<const tdi::tna::dummy::MatchActionDirect *>(table);
+  TestSession session;
+  TestTarget dev_tgt;
+  tdi::Flags flags(0);
+  const tdi_id_t src_addr_id = 1;
+  const tdi_id_t priority_id = 65537;
+  const tdi_id_t hit_id = 32848556;
+
+  std::unique_ptr<tdi::TableKey> key;
+  std::unique_ptr<tdi::TableData> data;
+  ASSERT_EQ(table->keyAllocate(&key), TDI_SUCCESS);
+  ASSERT_EQ(table->dataAllocate(hit_id, &data), TDI_SUCCESS);
+
+  // (value, mask, priority, port)
+  const std::vector<std::tuple<uint64_t, uint64_t, uint64_t, uint64_t>> rules =
+      {std::make_tuple(0x0a0000000000ULL, 0xff0000000000ULL, 10, 1),
+       std::make_tuple(0x0a0b00000000ULL, 0xffff00000000ULL, 5, 2),
+       std::make_tuple(0x000000000000ULL, 0x000000000000ULL, 100, 3),
+       std::make_tuple(0x0a0b00000000ULL, 0xffff00000000ULL, 7, 4),
+       std::make_tuple(0x00000000000fULL, 0x00000000000fULL, 1, 5)};
+  for (const auto &rule : rules) {
+    const uint64_t value = std::get<0>(rule);
+    const uint64_t mask = std::get<1>(rule);
+    ASSERT_EQ(key->setValue(src_addr_id,
+                            tdi::KeyFieldValueTernary<const uint64_t>(
+                                value, mask)),
+              TDI_SUCCESS);
+    ASSERT_EQ(key->setValue(priority_id,
+                            tdi::KeyFieldValueExact<const uint64_t>(
+                                std::get<2>(rule))),
+              TDI_SUCCESS);
+    ASSERT_EQ(data->setValue(1, std::get<3>(rule)), TDI_SUCCESS);
+    ASSERT_EQ(table->entryAdd(session, dev_tgt, flags, *key, *data),
+              TDI_SUCCESS);
+  }
+
+  const uint64_t full_mask = 0xffffffffffffULL;
+  auto lookup_port = [&](const uint64_t &addr, uint64_t *port) {
+    std::unique_ptr<tdi::TableKey> lookup_key;
+    tdi_handle_t handle;
+    table->keyAllocate(&lookup_key);
+    lookup_key->setValue(src_addr_id,
+                         tdi::KeyFieldValueTernary<const uint64_t>(
+                             addr, full_mask));
+    auto sts = dummy_table->entryLookup(*lookup_key, &handle);
+    if (sts != TDI_SUCCESS) return sts;
+    sts = table->entryGet(session, dev_tgt, flags, handle, lookup_key.get(),
+                          data.get());
+    if (sts != TDI_SUCCESS) return sts;
+    return data->getValue(1, port);
+  };
+  uint64_t port = 0;
+  ASSERT_EQ(lookup_port(0x0a0b01020304ULL, &port), TDI_SUCCESS);
+  ASSERT_EQ(port, 2);
+  ASSERT_EQ(lookup_port(0x0a0c01020304ULL, &port), TDI_SUCCESS);
+  ASSERT_EQ(port, 1);
+  ASSERT_EQ(lookup_port(0x010203040506ULL, &port), TDI_SUCCESS);
+  ASSERT_EQ(port, 3);
+  ASSERT_EQ(lookup_port(0x0a0b0102030fULL, &port), TDI_SUCCESS);
+  ASSERT_EQ(port, 5);
+
+  // Deleting the best rule exposes the next one with the same mask
+  const uint64_t value = 0x0a0b0c0d0e0fULL;
+  const uint64_t mask = 0xffff00000000ULL;
+  ASSERT_EQ(key->setValue(src_addr_id,
+                          tdi::KeyFieldValueTernary<const uint64_t>(value,
+                                                                    mask)),
+            TDI_SUCCESS);
+  ASSERT_EQ(key->setValue(priority_id,
+                          tdi::KeyFieldValueExact<const uint64_t>(5)),
+            TDI_SUCCESS);
+  ASSERT_EQ(table->entryDel(session, dev_tgt, flags, *key), TDI_SUCCESS);
+  ASSERT_EQ(lookup_port(0x0a0b01020304ULL, &port), TDI_SUCCESS);
+  ASSERT_EQ(port, 4);
+
+  // Values are stored masked
+  uint64_t out_value = 0, out_mask = 0;
+  tdi::KeyFieldValueTernary<uint64_t> ternary(out_value, out_mask);
+  ASSERT_EQ(key->getValue(src_addr_id, &ternary), TDI_SUCCESS);
+  ASSERT_EQ(ternary.value_, 0x0a0b00000000ULL);
+  ASSERT_EQ(ternary.mask_, 0xffff00000000ULL);
+
+  ASSERT_EQ(table->clear(session, dev_tgt, flags), TDI_SUCCESS);
+  tdi_handle_t handle;
+  ASSERT_EQ(dummy_table->entryLookup(*key, &handle), TDI_OBJECT_NOT_FOUND);
+}
+
+/**
+ * @brief Test longest prefix lookups on the LPM engine of the dummy
+ * MatchActionDirect table, for 32 and 128 bit prefixes
+ */
+TEST_P(TnaLpmInfo, dummyLpmMatchLookup) {
+  const tdi::Table *table;
+  auto status =
+      tdi_info->tableFromNameGet("pipe.SwitchIngress.ipRoute", &table);
+  ASSERT_EQ(status, TDI_SUCCESS);
+  auto dummy_table =
+      static_cast<const tdi::tna::dummy::MatchActionDirect *>(table);
+  TestSession session;
+  TestTarget dev_tgt;
+  tdi::Flags flags(0);
+  const tdi_id_t vrf_id = 1;
+  const tdi_id_t dst_addr_id = 2;
+  const tdi_id_t route_id = 31369524;
+
+  std::unique_ptr<tdi::TableKey> key;
+  std::unique_ptr<tdi::TableData> data;
+  ASSERT_EQ(table->keyAllocate(&key), TDI_SUCCESS);
+  ASSERT_EQ(table->dataAllocate(route_id, &data), TDI_SUCCESS);
+
+  // (vrf, prefix, prefix_len, port)
+  const std::vector<std::tuple<uint64_t, uint64_t, uint16_t, uint64_t>>
+      routes = {std::make_tuple(1, 0x00000000ULL, 0, 1),
+                std::make_tuple(1, 0x0a000000ULL, 8, 2),
+                std::make_tuple(1, 0x0a0b0000ULL, 16, 3),
+                std::make_tuple(1, 0x0a0b0c00ULL, 23, 4),
+                std::make_tuple(1, 0x0a0b0c0dULL, 32, 5),
+                std::make_tuple(2, 0x0a000000ULL, 8, 6)};
+  for (const auto &route : routes) {
+    ASSERT_EQ(key->setValue(vrf_id,
+                            tdi::KeyFieldValueExact<const uint64_t>(
+                                std::get<0>(route))),
+              TDI_SUCCESS);
+    ASSERT_EQ(key->setValue(dst_addr_id,
+                            tdi::KeyFieldValueLPM<const uint64_t>(
+                                std::get<1>(route), std::get<2>(route))),
+              TDI_SUCCESS);
+    ASSERT_EQ(data->setValue(1, std::get<3>(route)), TDI_SUCCESS);
+    ASSERT_EQ(table->entryAdd(session, dev_tgt, flags, *key, *data),
+              TDI_SUCCESS);
+  }
+  // Prefix lengths wider than the field are rejected
+  ASSERT_NE(key->setValue(dst_addr_id,
+                          tdi::KeyFieldValueLPM<const uint64_t>(0, 33)),
+            TDI_SUCCESS);
+
+  auto lookup_port = [&](const uint64_t &vrf,
+                         const uint64_t &addr,
+                         uint64_t *port) {
+    std::unique_ptr<tdi::TableKey> lookup_key;
+    tdi_handle_t handle;
+    table->keyAllocate(&lookup_key);
+    lookup_key->setValue(vrf_id, tdi::KeyFieldValueExact<const uint64_t>(vrf));
+    lookup_key->setValue(dst_addr_id,
+                         tdi::KeyFieldValueLPM<const uint64_t>(addr, 32));
+    auto sts = dummy_table->entryLookup(*lookup_key, &handle);
+    if (sts != TDI_SUCCESS) return sts;
+    sts = table->entryGet(session, dev_tgt, flags, handle, lookup_key.get(),
+                          data.get());
+    if (sts != TDI_SUCCESS) return sts;
+    return data->getValue(1, port);
+  };
+  uint64_t port = 0;
+  ASSERT_EQ(lookup_port(1, 0x0a0b0c0dULL, &port), TDI_SUCCESS);
+  ASSERT_EQ(port, 5);
+  ASSERT_EQ(lookup_port(1, 0x0a0b0d01ULL, &port), TDI_SUCCESS);
+  ASSERT_EQ(port, 4);
+  ASSERT_EQ(lookup_port(1, 0x0a0b0e01ULL, &port), TDI_SUCCESS);
+  ASSERT_EQ(port, 3);
+  ASSERT_EQ(lookup_port(1, 0x0a010101ULL, &port), TDI_SUCCESS);
+  ASSERT_EQ(port, 2);
+  ASSERT_EQ(lookup_port(1, 0x01020304ULL, &port), TDI_SUCCESS);
+  ASSERT_EQ(port, 1);
+  ASSERT_EQ(lookup_port(2, 0x0a0b0c0dULL, &port), TDI_SUCCESS);
+  ASSERT_EQ(port, 6);
+  ASSERT_EQ(lookup_port(2, 0x0b000000ULL, &port), TDI_OBJECT_NOT_FOUND);
+
+  // Withdrawing a route falls back to the next shorter prefix
+  ASSERT_EQ(key->setValue(vrf_id, tdi::KeyFieldValueExact<const uint64_t>(1)),
+            TDI_SUCCESS);
+  ASSERT_EQ(key->setValue(dst_addr_id,
+                          tdi::KeyFieldValueLPM<const uint64_t>(0x0a0b0c0dULL,
+                                                                23)),
+            TDI_SUCCESS);
+  ASSERT_EQ(table->entryDel(session, dev_tgt, flags, *key), TDI_SUCCESS);
+  ASSERT_EQ(lookup_port(1, 0x0a0b0c0dULL, &port), TDI_SUCCESS);
+  ASSERT_EQ(port, 5);
+  ASSERT_EQ(lookup_port(1, 0x0a0b0d01ULL, &port), TDI_SUCCESS);
+  ASSERT_EQ(port, 3);
+
+  // Prefixes are stored masked
+  tdi::KeyFieldValueLPM<uint64_t> lpm(0, 0);
+  ASSERT_EQ(key->getValue(dst_addr_id, &lpm), TDI_SUCCESS);
+  ASSERT_EQ(lpm.value_, 0x0a0b0c00ULL);
+  ASSERT_EQ(lpm.prefix_len_, 23);
+
+  // 128 bit prefixes go through the pointer variants
+  ASSERT_EQ(tdi_info->tableFromNameGet("pipe.SwitchIngress.ipv6Route", &table),
+            TDI_SUCCESS);
+  dummy_table = static_cast<const tdi::tna::dummy::MatchActionDirect *>(table);
+  std::unique_ptr<tdi::TableKey> v6_key;
+  ASSERT_EQ(table->keyAllocate(&v6_key), TDI_SUCCESS);
+  ASSERT_EQ(table->dataAllocate(route_id, &data), TDI_SUCCESS);
+  uint8_t addr[16] = {0x20, 0x01, 0x0d, 0xb8, 0xff};
+  ASSERT_EQ(v6_key->setValue(1,
+                             tdi::KeyFieldValueLPM<const uint8_t *>(
+                                 addr, 36, sizeof(addr))),
+            TDI_SUCCESS);
+  ASSERT_EQ(data->setValue(1, static_cast<uint64_t>(7)), TDI_SUCCESS);
+  ASSERT_EQ(table->entryAdd(session, dev_tgt, flags, *v6_key, *data),
+            TDI_SUCCESS);
+
+  uint8_t out[16] = {0};
+  tdi::KeyFieldValueLPM<uint8_t *> lpm_ptr(out, 0, sizeof(out));
+  ASSERT_EQ(v6_key->getValue(1, &lpm_ptr), TDI_SUCCESS);
+  ASSERT_EQ(lpm_ptr.prefix_len_, 36);
+  ASSERT_EQ(out[4], 0xf0);
+
+  uint8_t host[16] = {0x20, 0x01, 0x0d, 0xb8, 0xf1, 0x23};
+  tdi_handle_t handle;
+  ASSERT_EQ(v6_key->setValue(1,
+                             tdi::KeyFieldValueLPM<const uint8_t *>(
+                                 host, 128, sizeof(host))),
+            TDI_SUCCESS);
+  ASSERT_EQ(dummy_table->entryLookup(*v6_key, &handle), TDI_SUCCESS);
+  host[4] = 0xe1;
+  ASSERT_EQ(v6_key->setValue(1,
+                             tdi::KeyFieldValueLPM<const uint8_t *>(
+                                 host, 128, sizeof(host))),
+            TDI_SUCCESS);
+  ASSERT_EQ(dummy_table->entryLookup(*v6_key, &handle), TDI_OBJECT_NOT_FOUND);
+}
+
+/**
+ * @brief Test priority based lookups and overlap queries on the range
+ * engine of the dummy MatchActionDirect table
+ */
+TEST_P(TnaRangeInfo, dummyRangeMatchLookup) {
+  const tdi::Table *table;
+  auto status = tdi_info->tableFromNameGet("pipe.SwitchIngress.acl", &table);
+  ASSERT_EQ(status, TDI_SUCCESS);
+  auto dummy_table =
+      static_cast<const tdi::tna::dummy::MatchActionDirect *>(table);
+  TestSession session;
+  TestTarget dev_tgt;
+  tdi::Flags flags(0);
+  const tdi_id_t protocol_id = 1;
+  const tdi_id_t src_port_id = 2;
+  const tdi_id_t dst_port_id = 3;
+  const tdi_id_t priority_id = 65537;
+  const tdi_id_t permit_id = 24302497;
+
+  std::unique_ptr<tdi::TableKey> key;
+  std::unique_ptr<tdi::TableData> data;
+  ASSERT_EQ(table->keyAllocate(&key), TDI_SUCCESS);
+  ASSERT_EQ(table->dataAllocate(permit_id, &data), TDI_SUCCESS);
+
+  auto key_set = [&](const uint64_t &protocol,
+                     const uint64_t &protocol_mask,
+                     const uint64_t &src_low,
+                     const uint64_t &src_high,
+                     const uint64_t &dst_low,
+                     const uint64_t &dst_high,
+                     tdi::TableKey *out) {
+    auto sts = out->setValue(protocol_id,
+                             tdi::KeyFieldValueTernary<const uint64_t>(
+                                 protocol, protocol_mask));
+    if (sts != TDI_SUCCESS) return sts;
+    sts = out->setValue(
+        src_port_id,
+        tdi::KeyFieldValueRange<const uint64_t>(src_low, src_high));
+    if (sts != TDI_SUCCESS) return sts;
+    return out->setValue(
+        dst_port_id,
+        tdi::KeyFieldValueRange<const uint64_t>(dst_low, dst_high));
+  };
+
+  // (protocol, mask, src low, src high, dst low, dst high, priority, port)
+  const std::vector<std::vector<uint64_t>> rules = {
+      {6, 0xff, 0, 65535, 80, 80, 10, 1},
+      {0, 0x00, 1024, 65535, 0, 65535, 20, 2},
+      {6, 0xff, 0, 65535, 0, 1023, 15, 3},
+      {17, 0xff, 53, 53, 0, 65535, 5, 4}};
+  for (const auto &rule : rules) {
+    ASSERT_EQ(key_set(rule[0],
+                      rule[1],
+                      rule[2],
+                      rule[3],
+                      rule[4],
+                      rule[5],
+                      key.get()),
+              TDI_SUCCESS);
+    ASSERT_EQ(key->setValue(priority_id,
+                            tdi::KeyFieldValueExact<const uint64_t>(rule[6])),
+              TDI_SUCCESS);
+    ASSERT_EQ(data->setValue(1, rule[7]), TDI_SUCCESS);
+    ASSERT_EQ(table->entryAdd(session, dev_tgt, flags, *key, *data),
+              TDI_SUCCESS);
+  }
+  // Low bounds above high bounds are rejected
+  ASSERT_NE(key->setValue(src_port_id,
+                          tdi::KeyFieldValueRange<const uint64_t>(10, 9)),
+            TDI_SUCCESS);
+
+  auto port_get = [&](const tdi_handle_t &handle, uint64_t *port) {
+    std::unique_ptr<tdi::TableKey> entry_key;
+    table->keyAllocate(&entry_key);
+    auto sts = table->entryGet(
+        session, dev_tgt, flags, handle, entry_key.get(), data.get());
+    if (sts != TDI_SUCCESS) return sts;
+    return data->getValue(1, port);
+  };
+  auto lookup_port = [&](const uint64_t &protocol,
+                         const uint64_t &src_port,
+                         const uint64_t &dst_port,
+                         uint64_t *port) {
+    std::unique_ptr<tdi::TableKey> lookup_key;
+    tdi_handle_t handle;
+    table->keyAllocate(&lookup_key);
+    key_set(protocol,
+            0xff,
+            src_port,
+            src_port,
+            dst_port,
+            dst_port,
+            lookup_key.get());
+    auto sts = dummy_table->entryLookup(*lookup_key, &handle);
+    if (sts != TDI_SUCCESS) return sts;
+    return port_get(handle, port);
+  };
+  uint64_t port = 0;
+  ASSERT_EQ(lookup_port(6, 40000, 80, &port), TDI_SUCCESS);
+  ASSERT_EQ(port, 1);
+  ASSERT_EQ(lookup_port(6, 40000, 443, &port), TDI_SUCCESS);
+  ASSERT_EQ(port, 3);
+  ASSERT_EQ(lookup_port(6, 40000, 8080, &port), TDI_SUCCESS);
+  ASSERT_EQ(port, 2);
+  ASSERT_EQ(lookup_port(17, 53, 5000, &port), TDI_SUCCESS);
+  ASSERT_EQ(port, 4);
+  ASSERT_EQ(lookup_port(17, 100, 100, &port), TDI_OBJECT_NOT_FOUND);
+
+  // Rules a TCP rule on destination ports 1000-2000 would shadow or be
+  // shadowed by
+  std::unique_ptr<tdi::TableKey> query;
+  ASSERT_EQ(table->keyAllocate(&query), TDI_SUCCESS);
+  ASSERT_EQ(key_set(6, 0xff, 0, 65535, 1000, 2000, query.get()), TDI_SUCCESS);
+  std::vector<tdi_handle_t> handles;
+  ASSERT_EQ(dummy_table->entryOverlapGet(*query, &handles), TDI_SUCCESS);
+  std::set<uint64_t> ports;
+  for (const auto &handle : handles) {
+    ASSERT_EQ(port_get(handle, &port), TDI_SUCCESS);
+    ports.insert(port);
+  }
+  ASSERT_EQ(ports, std::set<uint64_t>({2, 3}));
+
+  // Bounds read back as set
+  uint64_t low = 0, high = 0;
+  tdi::KeyFieldValueRange<uint64_t> range(low, high);
+  ASSERT_EQ(query->getValue(dst_port_id, &range), TDI_SUCCESS);
+  ASSERT_EQ(range.low_, 1000);
+  ASSERT_EQ(range.high_, 2000);
+
+  // Deleting the best rule exposes the next one
+  ASSERT_EQ(key_set(6, 0xff, 0, 65535, 80, 80, key.get()), TDI_SUCCESS);
+  ASSERT_EQ(key->setValue(priority_id,
+                          tdi::KeyFieldValueExact<const uint64_t>(10)),
+            TDI_SUCCESS);
+  ASSERT_EQ(table->entryDel(session, dev_tgt, flags, *key), TDI_SUCCESS);
+  ASSERT_EQ(lookup_port(6, 40000, 80, &port), TDI_SUCCESS);
+  ASSERT_EQ(port, 3);
+
+  ASSERT_EQ(table->clear(session, dev_tgt, flags), TDI_SUCCESS);
+  ASSERT_EQ(lookup_port(6, 40000, 8080, &port), TDI_OBJECT_NOT_FOUND);
+}
+
 }  // namespace tdi_test
 }  // namespace tdi
@@ -122,6 +122,8 @@ class TdiInfoTest
 class TnaExactMatchInfo : public TdiInfoTest {};
 class TnaCounterInfo : public TdiInfoTest {};
 class TnaPort : public TdiInfoTest {};
+class TnaLpmInfo : public TdiInfoTest {};
+class TnaRangeInfo : public TdiInfoTest {};
 
 INSTANTIATE_TEST_CASE_P(TdiJsonTest,
                         TnaExactMatchInfo,
@@ -138,6 +140,16 @@ INSTANTIATE_TEST_CASE_P(TdiJsonTest,
                         ::testing::Values(std::make_tuple("tdi_ports.json",
                                                           "shared")));
 
+INSTANTIATE_TEST_CASE_P(TdiJsonTest,
+                        TnaLpmInfo,
+                        ::testing::Values(std::make_tuple("tdi.json",
+                                                          "tna_lpm")));
+
+INSTANTIATE_TEST_CASE_P(TdiJsonTest,
+                        TnaRangeInfo,
+                        ::testing::Values(std::make_tuple("tdi.json",
+                                                          "tna_range")));
+
 }  // namespace tdi_test
 }  // namespace tdi
 
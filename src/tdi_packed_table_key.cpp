@@ -0,0 +1,535 @@
+/*
+ * Copyright(c) 2021 Intel Corporation.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this software except as stipulated in the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <functional>
+
+#include <tdi/common/tdi_packed_table_key.hpp>
+#include <tdi/common/tdi_utils.hpp>
+
+namespace tdi {
+
+namespace {
+
+const std::string kMatchPriorityFieldName = "$MATCH_PRIORITY";
+
+// Mask of the valid bits in the most significant byte of a field
+inline uint8_t topByteMask(const PackedKeyFieldLayout &field) {
+  return (field.size_bits % 8) ? static_cast<uint8_t>(
+                                     (1u << (field.size_bits % 8)) - 1)
+                               : 0xff;
+}
+
+tdi_status_t fieldBytesFromValue(const PackedKeyFieldLayout &field,
+                                 const uint64_t &value,
+                                 uint8_t *out) {
+  if (field.size_bytes > sizeof(uint64_t)) {
+    LOG_ERROR("%s:%d Field %d of %zu bits can only be set as a byte stream",
+              __func__,
+              __LINE__,
+              field.id,
+              field.size_bits);
+    return TDI_INVALID_ARG;
+  }
+  if (field.size_bits < 64 && (value >> field.size_bits)) {
+    LOG_ERROR("%s:%d Value exceeds the %zu bits of field %d",
+              __func__,
+              __LINE__,
+              field.size_bits,
+              field.id);
+    return TDI_INVALID_ARG;
+  }
+  TdiEndiannessHandler::toNetworkOrder(field.size_bytes, value, out);
+  return TDI_SUCCESS;
+}
+
+tdi_status_t fieldBytesFromPtr(const PackedKeyFieldLayout &field,
+                               const uint8_t *value,
+                               const size_t &size,
+                               uint8_t *out) {
+  if (value == nullptr || size != field.size_bytes) {
+    LOG_ERROR("%s:%d Size %zu does not match the %zu bytes of field %d",
+              __func__,
+              __LINE__,
+              size,
+              field.size_bytes,
+              field.id);
+    return TDI_INVALID_ARG;
+  }
+  if (value[0] & ~topByteMask(field)) {
+    LOG_ERROR("%s:%d Value exceeds the %zu bits of field %d",
+              __func__,
+              __LINE__,
+              field.size_bits,
+              field.id);
+    return TDI_INVALID_ARG;
+  }
+  std::memcpy(out, value, size);
+  return TDI_SUCCESS;
+}
+
+// Mask of the first prefix_len bits of a field, counted from the most
+// significant bit of its width
+void prefixMaskFill(const PackedKeyFieldLayout &field,
+                    const size_t &prefix_len,
+                    uint8_t *out) {
+  const size_t pad = field.size_bytes * 8 - field.size_bits;
+  std::memset(out, 0, field.size_bytes);
+  for (size_t bit = pad; bit < pad + prefix_len; bit++) {
+    out[bit / 8] |= static_cast<uint8_t>(0x80 >> (bit % 8));
+  }
+}
+
+size_t prefixLenGet(const PackedKeyFieldLayout &field, const uint8_t *mask) {
+  size_t prefix_len = 0;
+  for (size_t i = 0; i < field.size_bytes; i++) {
+    prefix_len += __builtin_popcount(mask[i]);
+  }
+  return prefix_len;
+}
+
+// Hash of a byte string, a word at a time
+uint64_t bytesHash(const uint8_t *data, const size_t &size, uint64_t seed) {
+  const uint64_t kMul = 0x9ddfea08eb382d69ULL;
+  uint64_t hash = seed ^ (size * kMul);
+  size_t i = 0;
+  for (; i + 8 <= size; i += 8) {
+    uint64_t word;
+    std::memcpy(&word, data + i, sizeof(word));
+    hash = (hash ^ word) * kMul;
+    hash ^= hash >> 47;
+  }
+  if (i < size) {
+    uint64_t word = 0;
+    std::memcpy(&word, data + i, size - i);
+    hash = (hash ^ word) * kMul;
+    hash ^= hash >> 47;
+  }
+  hash *= kMul;
+  return hash ^ (hash >> 47);
+}
+
+}  // namespace
+
+PackedKeyLayout::PackedKeyLayout(const tdi::TableInfo *table_info) {
+  for (const auto &field_id : table_info->keyFieldIdListGet()) {
+    const auto *key_field = table_info->keyFieldGet(field_id);
+    PackedKeyFieldLayout field;
+    field.id = field_id;
+    field.match_type = key_field->matchTypeGet();
+    field.data_type = key_field->dataTypeGet();
+    field.size_bits = key_field->sizeGet();
+    field.size_bytes = (field.size_bits + 7) / 8;
+    field.offset = size_;
+    size_ += field.size_bytes;
+    if (field.match_type !=
+        static_cast<tdi_match_type_e>(TDI_MATCH_TYPE_EXACT)) {
+      exact_only_ = false;
+    }
+    fields_.push_back(field);
+  }
+  identity_size_ = exact_only_ ? size_ : 2 * size_;
+  match_mask_.resize(size_);
+  for (size_t i = 0; i < fields_.size(); i++) {
+    const auto *key_field = table_info->keyFieldGet(fields_[i].id);
+    if (key_field->nameGet() == kMatchPriorityFieldName) {
+      priority_field_ = &fields_[i];
+      continue;
+    }
+    if (fields_[i].match_type ==
+        static_cast<tdi_match_type_e>(TDI_MATCH_TYPE_RANGE)) {
+      continue;
+    }
+    fieldMaskFill(fields_[i], match_mask_.data());
+  }
+}
+
+const PackedKeyFieldLayout *PackedKeyLayout::fieldGet(
+    const tdi_id_t &field_id) const {
+  auto it = std::lower_bound(
+      fields_.begin(),
+      fields_.end(),
+      field_id,
+      [](const PackedKeyFieldLayout &field, const tdi_id_t &id) {
+        return field.id < id;
+      });
+  if (it == fields_.end() || it->id != field_id) {
+    return nullptr;
+  }
+  return &(*it);
+}
+
+void PackedKeyLayout::fieldMaskFill(const PackedKeyFieldLayout &field,
+                                    uint8_t *buf) {
+  if (!field.size_bytes) return;
+  std::memset(buf + field.offset, 0xff, field.size_bytes);
+  buf[field.offset] = topByteMask(field);
+}
+
+PackedTableKey::PackedTableKey(const tdi::Table *table,
+                               const PackedKeyLayout *layout)
+    : TableKey(table),
+      layout_(layout),
+      bytes_(2 * layout->sizeGet()) {
+  this->reset();
+}
+
+tdi_status_t PackedTableKey::setValue(const tdi_id_t &field_id,
+                                      const tdi::KeyFieldValue &field_value) {
+  const auto *field = layout_->fieldGet(field_id);
+  if (!field) {
+    LOG_ERROR("%s:%d Key field %d not found", __func__, __LINE__, field_id);
+    return TDI_OBJECT_NOT_FOUND;
+  }
+  if (field->data_type == TDI_FIELD_DATA_TYPE_STRING) {
+    LOG_ERROR("%s:%d String key field %d not supported",
+              __func__,
+              __LINE__,
+              field_id);
+    return TDI_NOT_SUPPORTED;
+  }
+  if (field_value.matchTypeGet() != field->match_type) {
+    LOG_ERROR("%s:%d Match type %d of value does not match key field %d",
+              __func__,
+              __LINE__,
+              static_cast<int>(field_value.matchTypeGet()),
+              field_id);
+    return TDI_INVALID_ARG;
+  }
+  tdi_status_t status = TDI_SUCCESS;
+  switch (static_cast<int>(field->match_type)) {
+    case TDI_MATCH_TYPE_EXACT: {
+      if (field_value.is_pointer()) {
+        const auto &exact =
+            static_cast<const KeyFieldValueExact<const uint8_t *> &>(
+                field_value);
+        return fieldBytesFromPtr(
+            *field, exact.value_, exact.size_, valuePtr(*field));
+      }
+      const auto &exact =
+          static_cast<const KeyFieldValueExact<const uint64_t> &>(field_value);
+      return fieldBytesFromValue(*field, exact.value_, valuePtr(*field));
+    }
+    case TDI_MATCH_TYPE_TERNARY: {
+      // Stage into locals so that a bad mask leaves the key untouched
+      std::vector<uint8_t> value(field->size_bytes), mask(field->size_bytes);
+      if (field_value.is_pointer()) {
+        const auto &ternary =
+            static_cast<const KeyFieldValueTernary<const uint8_t *> &>(
+                field_value);
+        status = fieldBytesFromPtr(
+            *field, ternary.value_, ternary.size_, value.data());
+        if (status != TDI_SUCCESS) return status;
+        status = fieldBytesFromPtr(
+            *field, ternary.mask_, ternary.size_, mask.data());
+      } else {
+        const auto &ternary =
+            static_cast<const KeyFieldValueTernary<const uint64_t> &>(
+                field_value);
+        status = fieldBytesFromValue(*field, ternary.value_, value.data());
+        if (status != TDI_SUCCESS) return status;
+        status = fieldBytesFromValue(*field, ternary.mask_, mask.data());
+      }
+      if (status != TDI_SUCCESS) return status;
+      uint8_t *field_value_ptr = valuePtr(*field);
+      uint8_t *field_mask_ptr = maskPtr(*field);
+      for (size_t i = 0; i < field->size_bytes; i++) {
+        field_value_ptr[i] = value[i] & mask[i];
+        field_mask_ptr[i] = mask[i];
+      }
+      return TDI_SUCCESS;
+    }
+    case TDI_MATCH_TYPE_LPM: {
+      std::vector<uint8_t> value(field->size_bytes);
+      uint16_t prefix_len;
+      if (field_value.is_pointer()) {
+        const auto &lpm =
+            static_cast<const KeyFieldValueLPM<const uint8_t *> &>(
+                field_value);
+        status =
+            fieldBytesFromPtr(*field, lpm.value_, lpm.size_, value.data());
+        prefix_len = lpm.prefix_len_;
+      } else {
+        const auto &lpm =
+            static_cast<const KeyFieldValueLPM<const uint64_t> &>(field_value);
+        status = fieldBytesFromValue(*field, lpm.value_, value.data());
+        prefix_len = lpm.prefix_len_;
+      }
+      if (status != TDI_SUCCESS) return status;
+      if (prefix_len > field->size_bits) {
+        LOG_ERROR("%s:%d Prefix length %d exceeds the %zu bits of field %d",
+                  __func__,
+                  __LINE__,
+                  prefix_len,
+                  field->size_bits,
+                  field_id);
+        return TDI_INVALID_ARG;
+      }
+      uint8_t *field_value_ptr = valuePtr(*field);
+      uint8_t *field_mask_ptr = maskPtr(*field);
+      prefixMaskFill(*field, prefix_len, field_mask_ptr);
+      for (size_t i = 0; i < field->size_bytes; i++) {
+        field_value_ptr[i] = value[i] & field_mask_ptr[i];
+      }
+      return TDI_SUCCESS;
+    }
+    case TDI_MATCH_TYPE_RANGE: {
+      std::vector<uint8_t> low(field->size_bytes), high(field->size_bytes);
+      if (field_value.is_pointer()) {
+        const auto &range =
+            static_cast<const KeyFieldValueRange<const uint8_t *> &>(
+                field_value);
+        status =
+            fieldBytesFromPtr(*field, range.low_, range.size_, low.data());
+        if (status != TDI_SUCCESS) return status;
+        status =
+            fieldBytesFromPtr(*field, range.high_, range.size_, high.data());
+      } else {
+        const auto &range =
+            static_cast<const KeyFieldValueRange<const uint64_t> &>(
+                field_value);
+        status = fieldBytesFromValue(*field, range.low_, low.data());
+        if (status != TDI_SUCCESS) return status;
+        status = fieldBytesFromValue(*field, range.high_, high.data());
+      }
+      if (status != TDI_SUCCESS) return status;
+      // Both bounds are in network order, so bytewise order is value order
+      if (std::memcmp(low.data(), high.data(), field->size_bytes) > 0) {
+        LOG_ERROR("%s:%d Low bound above high bound for key field %d",
+                  __func__,
+                  __LINE__,
+                  field_id);
+        return TDI_INVALID_ARG;
+      }
+      std::memcpy(valuePtr(*field), low.data(), field->size_bytes);
+      std::memcpy(maskPtr(*field), high.data(), field->size_bytes);
+      return TDI_SUCCESS;
+    }
+    default:
+      break;
+  }
+  LOG_ERROR("%s:%d Match type %d of key field %d not supported",
+            __func__,
+            __LINE__,
+            static_cast<int>(field->match_type),
+            field_id);
+  return TDI_NOT_SUPPORTED;
+}
+
+const PackedKeyFieldLayout *PackedTableKey::exactFieldGet(
+    const tdi_id_t &field_id) const {
+  const auto *field = layout_->fieldGet(field_id);
+  if (!field) {
+    LOG_ERROR("%s:%d Key field %d not found", __func__, __LINE__, field_id);
+    return nullptr;
+  }
+  if (field->match_type !=
+          static_cast<tdi_match_type_e>(TDI_MATCH_TYPE_EXACT) ||
+      field->data_type == TDI_FIELD_DATA_TYPE_STRING) {
+    LOG_ERROR("%s:%d Key field %d is not an exact field",
+              __func__,
+              __LINE__,
+              field_id);
+    return nullptr;
+  }
+  return field;
+}
+
+tdi_status_t PackedTableKey::setValue(const tdi_id_t &field_id,
+                                      const uint64_t &value) {
+  const auto *field = exactFieldGet(field_id);
+  if (!field) return TDI_INVALID_ARG;
+  return fieldBytesFromValue(*field, value, valuePtr(*field));
+}
+
+tdi_status_t PackedTableKey::setValue(const tdi_id_t &field_id,
+                                      const uint8_t *value,
+                                      const size_t &size) {
+  const auto *field = exactFieldGet(field_id);
+  if (!field) return TDI_INVALID_ARG;
+  return fieldBytesFromPtr(*field, value, size, valuePtr(*field));
+}
+
+tdi_status_t PackedTableKey::getValue(const tdi_id_t &field_id,
+                                      tdi::KeyFieldValue *field_value) const {
+  if (field_value == nullptr) {
+    LOG_ERROR("%s:%d Outparam passed is nullptr", __func__, __LINE__);
+    return TDI_INVALID_ARG;
+  }
+  const auto *field = layout_->fieldGet(field_id);
+  if (!field) {
+    LOG_ERROR("%s:%d Key field %d not found", __func__, __LINE__, field_id);
+    return TDI_OBJECT_NOT_FOUND;
+  }
+  if (field->data_type == TDI_FIELD_DATA_TYPE_STRING) {
+    LOG_ERROR("%s:%d String key field %d not supported",
+              __func__,
+              __LINE__,
+              field_id);
+    return TDI_NOT_SUPPORTED;
+  }
+  if (field_value->matchTypeGet() != field->match_type) {
+    LOG_ERROR("%s:%d Match type %d of value does not match key field %d",
+              __func__,
+              __LINE__,
+              static_cast<int>(field_value->matchTypeGet()),
+              field_id);
+    return TDI_INVALID_ARG;
+  }
+  if (field_value->is_pointer() && field_value->size_ != field->size_bytes) {
+    LOG_ERROR("%s:%d Size %zu does not match the %zu bytes of field %d",
+              __func__,
+              __LINE__,
+              field_value->size_,
+              field->size_bytes,
+              field_id);
+    return TDI_INVALID_ARG;
+  }
+  if (!field_value->is_pointer() && field->size_bytes > sizeof(uint64_t)) {
+    LOG_ERROR("%s:%d Field %d of %zu bits can only be read as a byte stream",
+              __func__,
+              __LINE__,
+              field_id,
+              field->size_bits);
+    return TDI_INVALID_ARG;
+  }
+  switch (static_cast<int>(field->match_type)) {
+    case TDI_MATCH_TYPE_EXACT: {
+      if (field_value->is_pointer()) {
+        auto exact = static_cast<KeyFieldValueExact<uint8_t *> *>(field_value);
+        std::memcpy(exact->value_, valuePtr(*field), field->size_bytes);
+      } else {
+        auto exact = static_cast<KeyFieldValueExact<uint64_t> *>(field_value);
+        TdiEndiannessHandler::toHostOrder(
+            field->size_bytes, valuePtr(*field), &exact->value_);
+      }
+      return TDI_SUCCESS;
+    }
+    case TDI_MATCH_TYPE_TERNARY: {
+      if (field_value->is_pointer()) {
+        auto ternary =
+            static_cast<KeyFieldValueTernary<uint8_t *> *>(field_value);
+        std::memcpy(ternary->value_, valuePtr(*field), field->size_bytes);
+        std::memcpy(ternary->mask_, maskPtr(*field), field->size_bytes);
+      } else {
+        auto ternary =
+            static_cast<KeyFieldValueTernary<uint64_t> *>(field_value);
+        TdiEndiannessHandler::toHostOrder(
+            field->size_bytes, valuePtr(*field), &ternary->value_);
+        TdiEndiannessHandler::toHostOrder(
+            field->size_bytes, maskPtr(*field), &ternary->mask_);
+      }
+      return TDI_SUCCESS;
+    }
+    case TDI_MATCH_TYPE_LPM: {
+      const auto prefix_len =
+          static_cast<uint16_t>(prefixLenGet(*field, maskPtr(*field)));
+      if (field_value->is_pointer()) {
+        auto lpm = static_cast<KeyFieldValueLPM<uint8_t *> *>(field_value);
+        std::memcpy(lpm->value_, valuePtr(*field), field->size_bytes);
+        lpm->prefix_len_ = prefix_len;
+      } else {
+        auto lpm = static_cast<KeyFieldValueLPM<uint64_t> *>(field_value);
+        TdiEndiannessHandler::toHostOrder(
+            field->size_bytes, valuePtr(*field), &lpm->value_);
+        lpm->prefix_len_ = prefix_len;
+      }
+      return TDI_SUCCESS;
+    }
+    case TDI_MATCH_TYPE_RANGE: {
+      if (field_value->is_pointer()) {
+        auto range = static_cast<KeyFieldValueRange<uint8_t *> *>(field_value);
+        std::memcpy(range->low_, valuePtr(*field), field->size_bytes);
+        std::memcpy(range->high_, maskPtr(*field), field->size_bytes);
+      } else {
+        auto range = static_cast<KeyFieldValueRange<uint64_t> *>(field_value);
+        TdiEndiannessHandler::toHostOrder(
+            field->size_bytes, valuePtr(*field), &range->low_);
+        TdiEndiannessHandler::toHostOrder(
+            field->size_bytes, maskPtr(*field), &range->high_);
+      }
+      return TDI_SUCCESS;
+    }
+    default:
+      break;
+  }
+  LOG_ERROR("%s:%d Match type %d of key field %d not supported",
+            __func__,
+            __LINE__,
+            static_cast<int>(field->match_type),
+            field_id);
+  return TDI_NOT_SUPPORTED;
+}
+
+tdi_status_t PackedTableKey::reset() {
+  std::fill(bytes_.begin(), bytes_.end(), 0);
+  uint8_t *mask = bytes_.data() + layout_->sizeGet();
+  for (const auto &field : layout_->fieldsGet()) {
+    if (field.match_type ==
+        static_cast<tdi_match_type_e>(TDI_MATCH_TYPE_EXACT)) {
+      PackedKeyLayout::fieldMaskFill(field, mask);
+    }
+  }
+  return TDI_SUCCESS;
+}
+
+uint32_t PackedTableKey::priorityGet() const {
+  const auto *field = layout_->priorityFieldGet();
+  if (!field || field->size_bytes > sizeof(uint64_t)) return 0;
+  uint64_t priority = 0;
+  TdiEndiannessHandler::toHostOrder(
+      field->size_bytes, valuePtr(*field), &priority);
+  return static_cast<uint32_t>(priority);
+}
+
+size_t PackedTableKey::hash() const {
+  return static_cast<size_t>(
+      bytesHash(bytes_.data(),
+                bytes_.size(),
+                static_cast<uint64_t>(reinterpret_cast<uintptr_t>(table_))));
+}
+
+bool PackedTableKey::equals(const tdi::TableKey &other) const {
+  const auto *packed = dynamic_cast<const PackedTableKey *>(&other);
+  if (packed == nullptr || packed->table_ != table_ ||
+      packed->layout_ != layout_) {
+    return false;
+  }
+  return std::memcmp(bytes_.data(), packed->bytes_.data(), bytes_.size()) ==
+         0;
+}
+
+bool PackedTableKey::less(const tdi::TableKey &other) const {
+  const auto *packed = dynamic_cast<const PackedTableKey *>(&other);
+  if (packed == nullptr) {
+    return tdi::TableKey::less(other);
+  }
+  if (packed->table_ != table_) {
+    return std::less<const void *>()(table_, packed->table_);
+  }
+  if (packed->layout_ != layout_) {
+    return std::less<const void *>()(layout_, packed->layout_);
+  }
+  return std::memcmp(bytes_.data(), packed->bytes_.data(), bytes_.size()) < 0;
+}
+
+void PackedTableKey::identitySet(const uint8_t *identity) {
+  std::memcpy(bytes_.data(), identity, layout_->identitySizeGet());
+}
+
+}  // namespace tdi
@@ -22,6 +22,40 @@
 namespace tdi {
 const std::string tdiNullStr = "";
 
+namespace {
+
+// Get the pool of a table, creating it on first use. Creation races are
+// settled by a CAS and the loser frees its pool
+template <typename T>
+TdiObjectPool<T> *poolGetOrCreate(std::atomic<TdiObjectPool<T> *> *pool_ptr,
+                                  const size_t &size) {
+  TdiObjectPool<T> *pool = pool_ptr->load(std::memory_order_acquire);
+  if (pool) return pool;
+  std::unique_ptr<TdiObjectPool<T>> created(new TdiObjectPool<T>(size));
+  if (pool_ptr->compare_exchange_strong(pool,
+                                        created.get(),
+                                        std::memory_order_acq_rel,
+                                        std::memory_order_acquire)) {
+    return created.release();
+  }
+  return pool;
+}
+
+// A pool which caches nothing is as good as none, and skips the reset
+template <typename T>
+TdiObjectPool<T> *poolGetIfEnabled(
+    const std::atomic<TdiObjectPool<T> *> &pool_ptr) {
+  TdiObjectPool<T> *pool = pool_ptr.load(std::memory_order_acquire);
+  return (pool && pool->capacityGet()) ? pool : nullptr;
+}
+
+}  // anonymous namespace
+
+Table::~Table() {
+  delete key_pool_.load();
+  delete data_pool_.load();
+}
+
 tdi_status_t Table::entryAdd(const Session & /*session*/,
                              const Target & /*dev_tgt*/,
                              const Flags & /*flags*/,
@@ -57,6 +91,91 @@ tdi_status_t Table::entryDel(const Session & /*session*/,
   return TDI_NOT_SUPPORTED;
 }
 
+tdi_status_t Table::entryAddBatch(
+    const Session &session,
+    const Target &dev_tgt,
+    const Flags &flags,
+    const std::vector<const TableKey *> &keys,
+    const std::vector<const TableData *> &datas,
+    std::vector<tdi_status_t> *statuses) const {
+  if (statuses == nullptr || keys.size() != datas.size()) {
+    LOG_ERROR("%s:%d %s ERROR : Invalid args, %zu keys and %zu data",
+              __func__,
+              __LINE__,
+              tableInfoGet()->nameGet().c_str(),
+              keys.size(),
+              datas.size());
+    return TDI_INVALID_ARG;
+  }
+  tdi_status_t status = TDI_SUCCESS;
+  statuses->assign(keys.size(), TDI_SUCCESS);
+  for (size_t i = 0; i < keys.size(); i++) {
+    if (keys[i] == nullptr || datas[i] == nullptr) {
+      (*statuses)[i] = TDI_INVALID_ARG;
+    } else {
+      (*statuses)[i] =
+          entryAdd(session, dev_tgt, flags, *keys[i], *datas[i]);
+    }
+    if (status == TDI_SUCCESS) status = (*statuses)[i];
+  }
+  return status;
+}
+
+tdi_status_t Table::entryModBatch(
+    const Session &session,
+    const Target &dev_tgt,
+    const Flags &flags,
+    const std::vector<const TableKey *> &keys,
+    const std::vector<const TableData *> &datas,
+    std::vector<tdi_status_t> *statuses) const {
+  if (statuses == nullptr || keys.size() != datas.size()) {
+    LOG_ERROR("%s:%d %s ERROR : Invalid args, %zu keys and %zu data",
+              __func__,
+              __LINE__,
+              tableInfoGet()->nameGet().c_str(),
+              keys.size(),
+              datas.size());
+    return TDI_INVALID_ARG;
+  }
+  tdi_status_t status = TDI_SUCCESS;
+  statuses->assign(keys.size(), TDI_SUCCESS);
+  for (size_t i = 0; i < keys.size(); i++) {
+    if (keys[i] == nullptr || datas[i] == nullptr) {
+      (*statuses)[i] = TDI_INVALID_ARG;
+    } else {
+      (*statuses)[i] =
+          entryMod(session, dev_tgt, flags, *keys[i], *datas[i]);
+    }
+    if (status == TDI_SUCCESS) status = (*statuses)[i];
+  }
+  return status;
+}
+
+tdi_status_t Table::entryDelBatch(const Session &session,
+                                  const Target &dev_tgt,
+                                  const Flags &flags,
+                                  const std::vector<const TableKey *> &keys,
+                                  std::vector<tdi_status_t> *statuses) const {
+  if (statuses == nullptr) {
+    LOG_ERROR("%s:%d %s ERROR : Outparam passed is nullptr",
+              __func__,
+              __LINE__,
+              tableInfoGet()->nameGet().c_str());
+    return TDI_INVALID_ARG;
+  }
+  tdi_status_t status = TDI_SUCCESS;
+  statuses->assign(keys.size(), TDI_SUCCESS);
+  for (size_t i = 0; i < keys.size(); i++) {
+    if (keys[i] == nullptr) {
+      (*statuses)[i] = TDI_INVALID_ARG;
+    } else {
+      (*statuses)[i] = entryDel(session, dev_tgt, flags, *keys[i]);
+    }
+    if (status == TDI_SUCCESS) status = (*statuses)[i];
+  }
+  return status;
+}
+
 tdi_status_t Table::clear(const Session & /*session*/,
                           const Target & /*dev_tgt*/,
                           const Flags & /*flags*/) const {
@@ -122,6 +241,34 @@ tdi_status_t Table::entryGet(const Session & /*session */,
   return TDI_NOT_SUPPORTED;
 }
 
+tdi_status_t Table::entryGetBatch(const Session &session,
+                                  const Target &dev_tgt,
+                                  const Flags &flags,
+                                  const std::vector<const TableKey *> &keys,
+                                  const std::vector<TableData *> &datas,
+                                  std::vector<tdi_status_t> *statuses) const {
+  if (statuses == nullptr || keys.size() != datas.size()) {
+    LOG_ERROR("%s:%d %s ERROR : Invalid args, %zu keys and %zu data",
+              __func__,
+              __LINE__,
+              tableInfoGet()->nameGet().c_str(),
+              keys.size(),
+              datas.size());
+    return TDI_INVALID_ARG;
+  }
+  tdi_status_t status = TDI_SUCCESS;
+  statuses->assign(keys.size(), TDI_SUCCESS);
+  for (size_t i = 0; i < keys.size(); i++) {
+    if (keys[i] == nullptr || datas[i] == nullptr) {
+      (*statuses)[i] = TDI_INVALID_ARG;
+    } else {
+      (*statuses)[i] = entryGet(session, dev_tgt, flags, *keys[i], datas[i]);
+    }
+    if (status == TDI_SUCCESS) status = (*statuses)[i];
+  }
+  return status;
+}
+
 tdi_status_t Table::entryGetFirst(const Session & /*session*/,
                                   const Target & /*dev_tgt*/,
                                   const Flags & /*flags*/,
@@ -134,6 +281,19 @@ tdi_status_t Table::entryGetFirst(const Session & /*session*/,
   return TDI_NOT_SUPPORTED;
 }
 
+tdi_status_t Table::cursorAllocate(
+    const Session & /*session*/,
+    const Target & /*dev_tgt*/,
+    const Flags & /*flags*/,
+    const bool & /*snapshot*/,
+    std::unique_ptr<TableCursor> * /*cursor_ret*/) const {
+  LOG_ERROR("%s:%d %s ERROR Table cursor not supported",
+            __func__,
+            __LINE__,
+            tableInfoGet()->nameGet().c_str());
+  return TDI_NOT_SUPPORTED;
+}
+
 tdi_status_t Table::entryGet(const Session & /*session*/,
                              const Target & /*dev_tgt*/,
                              const Flags & /*flags*/,
@@ -302,6 +462,154 @@ tdi_status_t Table::dataReset(const std::vector<tdi_id_t> & /* fields */,
   return TDI_NOT_SUPPORTED;
 }
 
+tdi_status_t Table::keyPoolSizeSet(const size_t &size) const {
+  std::unique_ptr<TableKey> key;
+  if (size) {
+    auto status = this->keyAllocate(&key);
+    if (status != TDI_SUCCESS) return status;
+    // Released keys are reset, so the pool is refused on tables which
+    // can't do that
+    status = this->keyReset(key.get());
+    if (status != TDI_SUCCESS) return status;
+  }
+  auto pool = poolGetOrCreate(&key_pool_, size);
+  pool->capacitySet(size);
+  // Fill the shard of this thread. put() returns the first object that
+  // does not fit, which is then freed
+  for (size_t i = 0; i < size; i++) {
+    if (!key) {
+      auto status = this->keyAllocate(&key);
+      if (status != TDI_SUCCESS) return status;
+    }
+    if (pool->put(std::move(key))) break;
+  }
+  return TDI_SUCCESS;
+}
+
+tdi_status_t Table::keyPoolAllocate(std::unique_ptr<TableKey> *key_ret) const {
+  auto pool = poolGetIfEnabled(key_pool_);
+  if (pool) {
+    *key_ret = pool->get();
+    if (*key_ret) return TDI_SUCCESS;
+  }
+  return this->keyAllocate(key_ret);
+}
+
+tdi_status_t Table::keyPoolRelease(std::unique_ptr<TableKey> key) const {
+  if (key == nullptr) {
+    LOG_ERROR("%s:%d %s null key passed",
+              __func__,
+              __LINE__,
+              tableInfoGet()->nameGet().c_str());
+    return TDI_INVALID_ARG;
+  }
+  const Table *table = nullptr;
+  key->tableGet(&table);
+  if (table != this) {
+    LOG_ERROR("%s:%d %s Key object does not belong to this table",
+              __func__,
+              __LINE__,
+              tableInfoGet()->nameGet().c_str());
+    return TDI_INVALID_ARG;
+  }
+  auto pool = poolGetIfEnabled(key_pool_);
+  if (!pool) return TDI_SUCCESS;
+  // A key which can't be reset is freed instead of pooled
+  if (this->keyReset(key.get()) != TDI_SUCCESS) return TDI_SUCCESS;
+  pool->put(std::move(key));
+  return TDI_SUCCESS;
+}
+
+tdi_status_t Table::dataPoolSizeSet(const size_t &size) const {
+  std::unique_ptr<TableData> data;
+  if (size) {
+    auto status = this->dataAllocate(&data);
+    if (status != TDI_SUCCESS) return status;
+    status = this->dataReset(data.get());
+    if (status != TDI_SUCCESS) return status;
+  }
+  auto pool = poolGetOrCreate(&data_pool_, size);
+  pool->capacitySet(size);
+  for (size_t i = 0; i < size; i++) {
+    if (!data) {
+      auto status = this->dataAllocate(&data);
+      if (status != TDI_SUCCESS) return status;
+    }
+    if (pool->put(std::move(data))) break;
+  }
+  return TDI_SUCCESS;
+}
+
+tdi_status_t Table::dataPoolAllocate(
+    const std::vector<tdi_id_t> &fields,
+    const tdi_id_t &action_id,
+    std::unique_ptr<TableData> *data_ret) const {
+  auto pool = poolGetIfEnabled(data_pool_);
+  std::unique_ptr<TableData> data;
+  if (pool) data = pool->get();
+  if (data) {
+    // Pooled objects were reset to all fields and no action on release
+    tdi_status_t status = TDI_SUCCESS;
+    if (fields.empty()) {
+      if (action_id) status = this->dataReset(action_id, data.get());
+    } else {
+      status = action_id ? this->dataReset(fields, action_id, data.get())
+                         : this->dataReset(fields, data.get());
+    }
+    if (status == TDI_SUCCESS) {
+      *data_ret = std::move(data);
+      return TDI_SUCCESS;
+    }
+    // Not every reset variant may be supported, allocate instead. That
+    // also reports invalid arguments
+    data.reset();
+  }
+  if (fields.empty()) {
+    return action_id ? this->dataAllocate(action_id, data_ret)
+                     : this->dataAllocate(data_ret);
+  }
+  return action_id ? this->dataAllocate(fields, action_id, data_ret)
+                   : this->dataAllocate(fields, data_ret);
+}
+
+tdi_status_t Table::dataPoolRelease(std::unique_ptr<TableData> data) const {
+  if (data == nullptr) {
+    LOG_ERROR("%s:%d %s null data passed",
+              __func__,
+              __LINE__,
+              tableInfoGet()->nameGet().c_str());
+    return TDI_INVALID_ARG;
+  }
+  const Table *table = nullptr;
+  data->getParent(&table);
+  if (table != this) {
+    LOG_ERROR("%s:%d %s Data object does not belong to this table",
+              __func__,
+              __LINE__,
+              tableInfoGet()->nameGet().c_str());
+    return TDI_INVALID_ARG;
+  }
+  // Data objects of container fields are not pooled
+  auto pool = poolGetIfEnabled(data_pool_);
+  if (!pool || data->containerIdGet()) return TDI_SUCCESS;
+  // A data object which can't be reset is freed instead of pooled
+  if (this->dataReset(data.get()) != TDI_SUCCESS) return TDI_SUCCESS;
+  pool->put(std::move(data));
+  return TDI_SUCCESS;
+}
+
+tdi_status_t Table::poolUsageGet(size_t *key_count, size_t *data_count) const {
+  if (key_count == nullptr || data_count == nullptr) {
+    LOG_ERROR("%s:%d Outparam passed is nullptr", __func__, __LINE__);
+    return TDI_INVALID_ARG;
+  }
+  auto key_pool = key_pool_.load(std::memory_order_acquire);
+  auto data_pool = data_pool_.load(std::memory_order_acquire);
+  *key_count = key_pool ? key_pool->sizeGet() : 0;
+  *data_count = data_pool ? data_pool->sizeGet() : 0;
+  return TDI_SUCCESS;
+}
+
 tdi_status_t Table::attributeAllocate(
     const tdi_attributes_type_e &attr_type,
     std::unique_ptr<TableAttributes> *table_attr) const {
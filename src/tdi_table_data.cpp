@@ -14,12 +14,26 @@
  * limitations under the License.
  */
 #include <algorithm>
+#include <cstring>
 
+#include <tdi/common/tdi_table.hpp>
 #include <tdi/common/tdi_table_data.hpp>
 #include <tdi/common/tdi_utils.hpp>
 
 namespace tdi {
 
+TableData::TableData(const tdi::Table *table,
+                     tdi_id_t action_id,
+                     tdi_id_t container_id,
+                     std::vector<tdi_id_t> active_fields)
+    : table_(table), action_id_(action_id), container_id_(container_id) {
+  const IdOrdinals *ordinals =
+      table_ ? &table_->tableInfoGet()->dataFieldOrdinalsGet() : nullptr;
+  active_fields_.init(ordinals);
+  removed_one_ofs_.init(ordinals);
+  this->activeFieldsSet(active_fields);
+}
+
 tdi_status_t TableData::setValue(const tdi_id_t & /*field_id*/,
                                  const uint64_t & /*value*/) {
   LOG_ERROR("%s:%d Not supported", __func__, __LINE__);
@@ -33,6 +47,11 @@ tdi_status_t TableData::setValue(const tdi_id_t & /*field_id*/,
   return TDI_NOT_SUPPORTED;
 }
 
+tdi_status_t TableData::setValue(const tdi_id_t &field_id,
+                                 std::vector<uint8_t> &&value) {
+  return this->setValue(field_id, value.data(), value.size());
+}
+
 tdi_status_t TableData::setValue(const tdi_id_t & /*field_id*/,
                                  const std::vector<tdi_id_t> & /*arr*/) {
   LOG_ERROR("%s:%d Not supported", __func__, __LINE__);
@@ -70,6 +89,12 @@ tdi_status_t TableData::setValue(
   return TDI_NOT_SUPPORTED;
 }
 
+tdi_status_t TableData::setValueMove(
+    const tdi_id_t &field_id,
+    std::vector<std::unique_ptr<tdi::TableData>> &&ret_vec) {
+  return this->setValue(field_id, std::move(ret_vec));
+}
+
 tdi_status_t TableData::setValue(const tdi_id_t & /*field_id*/,
                                  const std::string & /*str*/) {
   LOG_ERROR("%s:%d Not supported", __func__, __LINE__);
@@ -88,6 +113,13 @@ tdi_status_t TableData::getValue(const tdi_id_t & /*field_id*/,
   LOG_ERROR("%s:%d Not supported", __func__, __LINE__);
   return TDI_NOT_SUPPORTED;
 }
+tdi_status_t TableData::getValueView(const tdi_id_t & /*field_id*/,
+                                     const uint8_t ** /*value*/,
+                                     size_t * /*size*/) const {
+  LOG_ERROR("%s:%d Not supported", __func__, __LINE__);
+  return TDI_NOT_SUPPORTED;
+}
+
 tdi_status_t TableData::getValue(const tdi_id_t & /*field_id*/,
                                  std::vector<tdi_id_t> * /*arr*/) const {
   LOG_ERROR("%s:%d Not supported", __func__, __LINE__);
@@ -171,23 +203,68 @@ tdi_status_t TableData::reset(const tdi_id_t &action_id,
   return this->resetDerived();
 }
 
+bool TableData::equals(const tdi::TableData &other) const {
+  if (this == &other) return true;
+  if (this->table_ != other.table_ || this->action_id_ != other.action_id_ ||
+      this->container_id_ != other.container_id_) {
+    return false;
+  }
+  if (this->all_fields_set_ != other.all_fields_set_ ||
+      this->active_fields_ != other.active_fields_ ||
+      this->removed_one_ofs_ != other.removed_one_ofs_) {
+    // The same active fields can still be reached in different ways, for
+    // example all fields but a oneof sibling against the explicit list
+    std::set<tdi_id_t> field_ids;
+    for (const auto *data : {this, &other}) {
+      data->active_fields_.idsGet(&field_ids);
+      data->removed_one_ofs_.idsGet(&field_ids);
+    }
+    if (this->table_ != nullptr) {
+      const auto &action_field_ids =
+          this->table_->tableInfoGet()->dataFieldIdListGet(this->action_id_);
+      field_ids.insert(action_field_ids.begin(), action_field_ids.end());
+    }
+    for (const auto &field_id : field_ids) {
+      bool is_active = false;
+      bool other_is_active = false;
+      this->isActive(field_id, &is_active);
+      other.isActive(field_id, &other_is_active);
+      if (is_active != other_is_active) return false;
+    }
+  }
+  return this->equalsDerived(other);
+}
+
 tdi_status_t TableData::activeFieldsSet(const std::vector<tdi_id_t> &fields) {
-  this->removed_one_ofs_ = {};
-  this->active_fields_s_ = {};
+  this->removed_one_ofs_.clear();
+  this->active_fields_.clear();
   if (fields.empty()) {
     this->all_fields_set_ = true;
   } else {
     this->all_fields_set_ = false;
-    std::copy(fields.begin(),
-              fields.end(),
-              std::inserter(active_fields_s_, active_fields_s_.end()));
+    for (const auto &field_id : fields) {
+      this->active_fields_.insert(field_id);
+    }
   }
+  this->active_fields_s_stale_.store(true, std::memory_order_relaxed);
   return TDI_SUCCESS;
 }
 
+const std::set<tdi_id_t> &TableData::activeFieldsGet() const {
+  if (this->active_fields_s_stale_.load(std::memory_order_acquire)) {
+    std::lock_guard<std::mutex> lock(this->active_fields_s_mtx_);
+    if (this->active_fields_s_stale_.load(std::memory_order_relaxed)) {
+      this->active_fields_s_.clear();
+      this->active_fields_.idsGet(&this->active_fields_s_);
+      this->active_fields_s_stale_.store(false, std::memory_order_release);
+    }
+  }
+  return this->active_fields_s_;
+}
+
 void TableData::removeActiveField(const tdi_id_t &field_id) {
   // The reason a separate set of removed_one_ofs_ is maintained
-  // is because the active_field_s_ set doesn't always
+  // is because the active_fields_ set doesn't always
   // contain the list of all fields. It cannot keep it especially
   // if the action_id is not known beforehand. So in those cases,
   // we need to mark if a field was removed.
@@ -196,38 +273,99 @@ void TableData::removeActiveField(const tdi_id_t &field_id) {
   // If the set of active fields is empty,
   // then no need to process it or change
   // all_fields_set.
-  if (!active_fields_s_.empty()) {
-    this->active_fields_s_.erase(field_id);
+  if (!active_fields_.empty()) {
+    if (this->active_fields_.erase(field_id)) {
+      this->active_fields_s_stale_.store(true, std::memory_order_relaxed);
+    }
     all_fields_set_ = false;
   }
 }
 
 tdi_status_t TableData::isActive(const tdi_id_t &field_id,
                                  bool *is_active) const {
-  // 1. Check if the input field was part of an explicit
-  // field removal which can be done via removeActiveField.
-  auto it = this->removed_one_ofs_.find(field_id);
-  if (it != this->removed_one_ofs_.end()) {
-    *is_active = false;
-    return TDI_SUCCESS;
+  // A field is inactive if it was explicitly removed via
+  // removeActiveField. Otherwise it is active if all fields were set
+  // or if it is explicitly set in the active fields set
+  *is_active = !this->removed_one_ofs_.contains(field_id) &&
+               (this->all_fields_set_ ||
+                this->active_fields_.contains(field_id));
+  return TDI_SUCCESS;
+}
+
+void TableData::FieldSet::init(const IdOrdinals *ordinals) {
+  ordinals_ = ordinals;
+  bits_.assign(ordinals_ ? (ordinals_->sizeGet() + 63) / 64 : 0, 0);
+  others_.clear();
+  count_ = 0;
+}
+
+void TableData::FieldSet::clear() {
+  if (!count_) return;
+  if (!bits_.empty()) {
+    std::memset(bits_.data(), 0, bits_.size() * sizeof(bits_[0]));
   }
-  // 2. Check if all fields were set. Then all fields are
-  // active
+  others_.clear();
+  count_ = 0;
+}
 
-  if (this->all_fields_set_) {
-    *is_active = true;
-    return TDI_SUCCESS;
+bool TableData::FieldSet::insert(const tdi_id_t &field_id) {
+  size_t ordinal;
+  bool inserted;
+  if (ordinals_ && ordinals_->find(field_id, &ordinal)) {
+    const uint64_t bit = 1ULL << (ordinal % 64);
+    inserted = !(bits_[ordinal / 64] & bit);
+    bits_[ordinal / 64] |= bit;
+  } else {
+    inserted = others_.insert(field_id).second;
   }
+  if (inserted) count_++;
+  return inserted;
+}
 
-  // Lastly check if they are explicitly set in the active
-  // fields set
-  auto it2 = this->active_fields_s_.find(field_id);
-  if (it2 != this->active_fields_s_.end()) {
-    *is_active = true;
-    return TDI_SUCCESS;
+bool TableData::FieldSet::erase(const tdi_id_t &field_id) {
+  size_t ordinal;
+  bool erased;
+  if (ordinals_ && ordinals_->find(field_id, &ordinal)) {
+    const uint64_t bit = 1ULL << (ordinal % 64);
+    erased = bits_[ordinal / 64] & bit;
+    bits_[ordinal / 64] &= ~bit;
+  } else {
+    erased = others_.erase(field_id);
   }
-  *is_active = false;
-  return TDI_SUCCESS;
+  if (erased) count_--;
+  return erased;
+}
+
+bool TableData::FieldSet::contains(const tdi_id_t &field_id) const {
+  if (!count_) return false;
+  size_t ordinal;
+  if (ordinals_ && ordinals_->find(field_id, &ordinal)) {
+    return (bits_[ordinal / 64] >> (ordinal % 64)) & 1;
+  }
+  return others_.find(field_id) != others_.end();
+}
+
+void TableData::FieldSet::idsGet(std::set<tdi_id_t> *field_ids) const {
+  for (size_t word = 0; word < bits_.size(); word++) {
+    for (uint64_t bits = bits_[word]; bits; bits &= bits - 1) {
+      field_ids->insert(
+          ordinals_->idGet(word * 64 + __builtin_ctzll(bits)));
+    }
+  }
+  field_ids->insert(others_.begin(), others_.end());
+}
+
+bool TableData::FieldSet::operator==(const FieldSet &other) const {
+  if (count_ != other.count_) return false;
+  if (ordinals_ == other.ordinals_) {
+    return bits_ == other.bits_ && others_ == other.others_;
+  }
+  // Different tables, compare by ID
+  std::set<tdi_id_t> field_ids;
+  std::set<tdi_id_t> other_field_ids;
+  this->idsGet(&field_ids);
+  other.idsGet(&other_field_ids);
+  return field_ids == other_field_ids;
 }
 
 tdi_status_t TableData::getParent(const tdi::Table **table) const {
@@ -46,4 +46,16 @@ tdi_status_t TableKey::reset() {
   return TDI_NOT_SUPPORTED;
 }
 
+size_t TableKey::hash() const {
+  return std::hash<const TableKey *>()(this);
+}
+
+bool TableKey::equals(const tdi::TableKey &other) const {
+  return this == &other;
+}
+
+bool TableKey::less(const tdi::TableKey &other) const {
+  return std::less<const TableKey *>()(this, &other);
+}
+
 }  // namespace tdi
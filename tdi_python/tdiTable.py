@@ -63,6 +63,8 @@ class TdiTable:
         self.string_choices = {}
         self.annotations = {}
         self.has_const_default_action = False
+        # Size of the key and data object pools of the table in the driver
+        self._pool_size = 0
         self.unimplemented_tables = ["TODO"]
         self.table_type = self.table_type_map((self.get_type()))
         self.table_ready = False if self.table_type in self.unimplemented_tables else True
@@ -1752,6 +1754,17 @@ class TdiTable:
             return -1, -1
         return key_handle, data_handle
 
+    def _pool_size_set(self, size):
+        # Dumps allocate and free a key and data object per entry, let the
+        # driver recycle them instead
+        if size <= self._pool_size:
+            return
+        sts = self._cintf.get_driver().tdi_table_key_pool_size_set(self._handle, c_size_t(size))
+        if sts == 0:
+            sts = self._cintf.get_driver().tdi_table_data_pool_size_set(self._handle, c_size_t(size))
+        # Tables which can't pool objects refuse it, don't ask again
+        self._pool_size = size
+
     def _deallocate_hdls(self, key_hdls, data_hdls):
         for hdl in key_hdls:
             self._cintf.get_driver().tdi_table_key_deallocate(hdl)
@@ -1788,6 +1801,7 @@ class TdiTable:
         arrtype = self._cintf.handle_type * n
         key_hdls = arrtype()
         data_hdls = arrtype()
+        self._pool_size_set(n)
         for i in range(0, n):
             new_key, new_data = self._allocate_keydata_handles()
             key_hdls[i] = new_key